@@ -0,0 +1,1340 @@
+/**
+ * @file bench_main.cpp
+ * @brief Benchmarks for CSV loading and SMA signal generation
+ *
+ * Generates a synthetic OHLCV file, loads it repeatedly with each LoadMode and
+ * reports the best time, throughput, and whether both loaders produced the
+ * same data, together with reloads from the binary sidecar cache and a full
+ * pass through the chunked streaming reader (parse + iterate). It then compares SMAStrategy's per-bar path with its batch
+ * (on_bars) path and checks that both produce identical signals, and finally
+ * times the time-ordered merge of one file per symbol for 3,000 symbols and
+ * marking a 3,000-position Portfolio per symbol vs in one batch. The last
+ * sections time the event-driven BacktestEngine (checked against
+ * SweepEngine's result for the same windows, and its online metrics against
+ * a second pass over the stored equity curve), virtual vs statically
+ * dispatched strategies per bar and in the engine, a sweep of many short runs
+ * with per-run state on the global heap vs in per-thread RunArenas, and
+ * per-bar signal output through std::ofstream with std::endl vs RecordWriter
+ * (checked to write byte-identical files), walk-forward folds warmed up
+ * from the preceding bars vs replayed from the first bar, 32 strategies in
+ * separate passes vs one StrategyGroup pass, a streamed file
+ * through the single-threaded engine vs the three-stage Pipeline, and a
+ * day-two run over a file with one appended bar, replayed vs resumed from a
+ * checkpoint. The indicator section checks every streaming indicator against
+ * its batch kernel and times 32 consumers computing their own indicator
+ * series vs sharing one IndicatorGraph, and a two-symbol sweep run locally
+ * vs through a SweepCoordinator and loopback workers (same top 10). The
+ * compact storage section runs the engine over double, float32 and tick
+ * price columns and reports each layout's P&L divergence. The validation
+ * section times a mapped load with and without validation and checks the
+ * quality report of a deliberately damaged copy of the file, and the last
+ * one loads 64 files one add_file() at a time vs in one parallel add_files()
+ * (same merged feed).
+ *
+ * Usage: bench [rows] [repetitions]   (defaults: 1000000 rows, 5 repetitions)
+ */
+
+#include "synthetic_data.hpp"
+#include "data/bar_cache.hpp"
+#include "data/bar_cursor.hpp"
+#include "data/data_handler.hpp"
+#include "data/multi_symbol_data_handler.hpp"
+#include "engine/backtest_engine.hpp"
+#include "engine/checkpoint.hpp"
+#include "engine/pipeline.hpp"
+#include "engine/precision_check.hpp"
+#include "portfolio/portfolio.hpp"
+#include "indicators/crossover_kernel.hpp"
+#include "indicators/indicator_graph.hpp"
+#include "indicators/indicators.hpp"
+#include "indicators/rolling_mean_cache.hpp"
+#include "output/record_writer.hpp"
+#include "strategy/sma_strategy.hpp"
+#include "strategy/static_sma_strategy.hpp"
+#include "strategy/strategy_group.hpp"
+#include "sweep/distributed_sweep.hpp"
+#include "sweep/sweep_engine.hpp"
+#include "sweep/walk_forward.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+    struct LoadResult {
+        double best_seconds = 0.0;
+        size_t rows = 0;
+        size_t bytes = 0;
+        double close_checksum = 0.0;
+        bool from_cache = true;  ///< Every repetition was served from the sidecar
+    };
+
+    LoadResult run_load(const std::string& path, backtest::LoadMode mode, int repetitions,
+                        backtest::CachePolicy cache = backtest::CachePolicy::Disabled) {
+        LoadResult result;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::DataHandler data;
+            auto start = std::chrono::steady_clock::now();
+            data.load_csv(path, "BENCH", mode, cache);
+            auto stop = std::chrono::steady_clock::now();
+            result.from_cache = result.from_cache && data.last_load_stats().from_cache;
+
+            double seconds = std::chrono::duration<double>(stop - start).count();
+            if (rep == 0 || seconds < result.best_seconds) {
+                result.best_seconds = seconds;
+            }
+            if (rep == 0) {
+                result.rows = data.size();
+                result.bytes = data.last_load_stats().bytes_read;
+                while (data.has_next()) {
+                    result.close_checksum += data.get_next_bar().close;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Times DataHandler::open_stream() plus draining every bar through get_next_bar()
+     */
+    LoadResult run_stream(const std::string& path, int repetitions) {
+        LoadResult result;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::DataHandler data;
+            double checksum = 0.0;
+            auto start = std::chrono::steady_clock::now();
+            data.open_stream(path, "BENCH");
+            while (data.has_next()) {
+                checksum += data.get_next_bar().close;
+            }
+            auto stop = std::chrono::steady_clock::now();
+
+            double seconds = std::chrono::duration<double>(stop - start).count();
+            if (rep == 0 || seconds < result.best_seconds) {
+                result.best_seconds = seconds;
+            }
+            result.rows = data.last_load_stats().rows_loaded;
+            result.bytes = data.last_load_stats().bytes_read;
+            result.close_checksum = checksum;
+        }
+        result.from_cache = false;
+        return result;
+    }
+
+    void print_result(const char* name, const LoadResult& r) {
+        const double mb = static_cast<double>(r.bytes) / (1024.0 * 1024.0);
+        std::printf("%-14s %10.3f ms %10.1f MB/s %12.0f rows/s\n", name,
+                    r.best_seconds * 1e3, mb / r.best_seconds,
+                    static_cast<double>(r.rows) / r.best_seconds);
+    }
+
+    /**
+     * @brief Times per-bar vs batch signal generation; returns false on a mismatch
+     */
+    bool run_sma(const backtest::DataHandler& data, size_t short_win, size_t long_win, int repetitions) {
+        const backtest::BarColumns bars = data.columns();
+        std::vector<backtest::Signal> streaming(bars.size());
+        std::vector<backtest::Signal> batch(bars.size());
+
+        double best_streaming = 0.0;
+        double best_batch = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::SMAStrategy per_bar(short_win, long_win);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < bars.size(); ++i) {
+                per_bar.on_new_bar(bars.bar(i));
+                streaming[i] = per_bar.generate_signal();
+            }
+            auto mid = std::chrono::steady_clock::now();
+
+            backtest::SMAStrategy batched(short_win, long_win);
+            batched.on_bars(bars, batch);
+            auto stop = std::chrono::steady_clock::now();
+
+            const double s = std::chrono::duration<double>(mid - start).count();
+            const double b = std::chrono::duration<double>(stop - mid).count();
+            if (rep == 0 || s < best_streaming) best_streaming = s;
+            if (rep == 0 || b < best_batch) best_batch = b;
+        }
+
+        bool identical = true;
+        for (size_t i = 0; i < bars.size(); ++i) {
+            if (streaming[i].type != batch[i].type || streaming[i].strength != batch[i].strength ||
+                streaming[i].timestamp != batch[i].timestamp) {
+                identical = false;
+                break;
+            }
+        }
+
+        const double n = static_cast<double>(bars.size());
+        std::printf("SMA %3zu/%-4zu per-bar %7.2f ns/bar  batch %7.2f ns/bar  (%5.2fx)  identical: %s\n",
+                    short_win, long_win, best_streaming * 1e9 / n, best_batch * 1e9 / n,
+                    best_streaming / best_batch, identical ? "yes" : "NO");
+        return identical;
+    }
+
+    /**
+     * @brief Times the k-way merge of many per-symbol files; returns false if the order is wrong
+     */
+    bool run_merge(size_t symbols, size_t rows_per_symbol, int repetitions) {
+        std::vector<std::string> paths;
+        backtest::MultiSymbolDataHandler feed;
+        for (size_t s = 0; s < symbols; ++s) {
+            paths.push_back("bench_symbol_" + std::to_string(s) + ".csv");
+            // Different lengths so streams run out at different times
+            const size_t rows = rows_per_symbol - (s * 7) % (rows_per_symbol / 2 + 1);
+            if (!backtest::write_synthetic_csv(paths.back(), rows, 1000 + s) ||
+                !feed.add_file(paths.back(), "SYM" + std::to_string(s))) {
+                return false;
+            }
+        }
+
+        bool ordered = true;
+        size_t emitted = 0;
+        double best = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            feed.reset();
+            backtest::Timestamp last = std::numeric_limits<backtest::Timestamp>::min();
+            double checksum = 0.0;
+            auto start = std::chrono::steady_clock::now();
+            while (feed.has_next()) {
+                const backtest::Bar bar = feed.get_next_bar();
+                ordered = ordered && bar.timestamp >= last;
+                last = bar.timestamp;
+                checksum += bar.close;
+            }
+            auto stop = std::chrono::steady_clock::now();
+            const double seconds = std::chrono::duration<double>(stop - start).count();
+            if (rep == 0 || seconds < best) best = seconds;
+            emitted = feed.position();
+            if (checksum == 0.0) ordered = false;
+        }
+
+        for (const std::string& path : paths) {
+            std::remove(path.c_str());
+        }
+        const bool complete = emitted == feed.size();
+        std::printf("merge %zu symbols, %zu bars: %7.2f ns/bar  %12.0f bars/s  ordered: %s\n",
+                    symbols, feed.size(), best * 1e9 / static_cast<double>(feed.size()),
+                    static_cast<double>(feed.size()) / best, ordered && complete ? "yes" : "NO");
+        return ordered && complete;
+    }
+
+    /**
+     * @brief Times end-of-bar marking of a large book, per symbol vs batched; false on a mismatch
+     */
+    bool run_marking(size_t symbols, size_t steps, int repetitions) {
+        std::vector<backtest::PriceUpdate> updates(symbols);
+        for (size_t s = 0; s < symbols; ++s) {
+            updates[s].symbol_id = backtest::intern_symbol("MARK" + std::to_string(s));
+        }
+
+        auto make_book = [&]() {
+            backtest::Portfolio portfolio(1e9);
+            for (size_t s = 0; s < symbols; ++s) {
+                portfolio.open_position(updates[s].symbol_id, 100 + static_cast<int>(s % 50), 50.0);
+            }
+            return portfolio;
+        };
+        // Precomputed so both paths time marking only
+        std::vector<double> prices(symbols * steps);
+        for (size_t step = 0; step < steps; ++step) {
+            for (size_t s = 0; s < symbols; ++s) {
+                prices[step * symbols + s] = 50.0 + static_cast<double>((step * 31 + s * 17) % 1000) * 0.01;
+            }
+        }
+        auto price_at = [&](size_t step, size_t s) { return prices[step * symbols + s]; };
+
+        double best_single = 0.0;
+        double best_batch = 0.0;
+        double single_value = 0.0;
+        double batch_value = 0.0;
+        bool consistent = true;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::Portfolio single = make_book();
+            backtest::Portfolio batch = make_book();
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t step = 0; step < steps; ++step) {
+                for (size_t s = 0; s < symbols; ++s) {
+                    single.update_price(updates[s].symbol_id, price_at(step, s));
+                }
+                single_value += single.total_value();
+            }
+            auto mid = std::chrono::steady_clock::now();
+            for (size_t step = 0; step < steps; ++step) {
+                for (size_t s = 0; s < symbols; ++s) {
+                    updates[s].price = price_at(step, s);
+                }
+                batch.update_prices(updates);
+                batch_value += batch.total_value();
+            }
+            auto stop = std::chrono::steady_clock::now();
+
+            const double a = std::chrono::duration<double>(mid - start).count();
+            const double b = std::chrono::duration<double>(stop - mid).count();
+            if (rep == 0 || a < best_single) best_single = a;
+            if (rep == 0 || b < best_batch) best_batch = b;
+            consistent = consistent && single.check_aggregates() && batch.check_aggregates();
+        }
+
+        const bool match = consistent && std::abs(single_value - batch_value) <= 1e-9 * std::abs(single_value);
+        const double n = static_cast<double>(symbols * steps);
+        std::printf("mark %zu symbols x %zu bars: update_price %6.2f ns/mark  update_prices %6.2f ns/mark  (%5.2fx)  consistent: %s\n",
+                    symbols, steps, best_single * 1e9 / n, best_batch * 1e9 / n, best_single / best_batch,
+                    match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Times full BacktestEngine runs; false if they disagree with SweepEngine::run_one()
+     */
+    bool run_engine(const backtest::DataHandler& data, size_t short_win, size_t long_win, int repetitions) {
+        const double commission = 1.0;
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = commission;
+        const backtest::SimulatedExecution execution(costs);
+
+        double best = 0.0;
+        double final_value = 0.0;
+        double sharpe = 0.0;
+        size_t fills = 0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::SMAStrategy strategy(short_win, long_win);
+            backtest::BacktestEngine engine(strategy, execution);
+            const backtest::EngineStats& stats = engine.run(data.columns());
+            if (rep == 0 || stats.seconds < best) best = stats.seconds;
+            final_value = engine.portfolio().total_value();
+            fills = stats.fills;
+            sharpe = engine.metrics().sharpe;
+        }
+
+        backtest::SweepConfig config;
+        config.commission = commission;
+        const backtest::SweepResult expected =
+            backtest::SweepEngine(data.columns(), config).run_one(backtest::SmaParams{short_win, long_win});
+        const bool match = expected.final_value == final_value && expected.trades == fills &&
+                           expected.metrics.sharpe == sharpe;
+
+        const double n = static_cast<double>(data.size());
+        std::printf("engine SMA %3zu/%-4zu %7.2f ns/bar  %6.2f M bars/s  fills %zu  matches sweep: %s\n",
+                    short_win, long_win, best * 1e9 / n, n / best * 1e-6, fills, match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Online metrics vs a second pass over the stored equity curve; false if they disagree
+     */
+    bool run_metrics(const backtest::DataHandler& data, int repetitions) {
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        const backtest::SimulatedExecution execution(costs);
+
+        double best[3] = {0.0, 0.0, 0.0};
+        backtest::PerformanceMetrics online;
+        double offline_sharpe = 0.0;
+        double offline_sortino = 0.0;
+        double offline_drawdown = 0.0;
+        size_t curve_bytes = 0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                backtest::SMAStrategy strategy(10, 50);
+                backtest::EngineConfig config;
+                config.record_equity = variant == 0;
+                backtest::BacktestEngine engine(strategy, execution, config);
+                const double t = engine.run(data.columns()).seconds;
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+                if (variant == 1) {
+                    online = engine.metrics();
+                    continue;
+                }
+
+                // What exporting the curve and analysing it afterwards costs
+                const backtest::EquityCurve& curve = engine.equity_curve();
+                curve_bytes = curve.size() * (sizeof(double) + sizeof(backtest::Timestamp));
+                auto start = std::chrono::steady_clock::now();
+                const backtest::Span<const double> values = curve.values();
+                const size_t n = values.size();
+                std::vector<double> returns(n);
+                double previous = config.initial_capital;
+                double sum = 0.0;
+                double down = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    returns[i] = values[i] / previous - 1.0;
+                    previous = values[i];
+                    sum += returns[i];
+                    down += returns[i] < 0.0 ? returns[i] * returns[i] : 0.0;
+                }
+                const double mean = sum / n;
+                double squares = 0.0;
+                for (double r : returns) {
+                    squares += (r - mean) * (r - mean);
+                }
+                const double annualize = std::sqrt(backtest::kDefaultPeriodsPerYear);
+                offline_sharpe = mean / std::sqrt(squares / (n - 1)) * annualize;
+                offline_sortino = mean / std::sqrt(down / n) * annualize;
+                offline_drawdown = curve.max_drawdown();
+                const double offline = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || offline < best[2]) best[2] = offline;
+            }
+        }
+
+        // Flat through a warm-up, then a loss: the drawdown runs from the starting value
+        const double flat_then_loss[] = {100000.0, 100000.0, 100000.0, 90000.0, 95000.0, 80000.0};
+        backtest::PerformanceTracker tracker(flat_then_loss[0]);
+        backtest::EquityCurve reference;
+        for (double value : flat_then_loss) {
+            tracker.on_bar(value);
+            reference.record(0, value);
+        }
+        const double flat_drawdown = tracker.metrics().max_drawdown;
+
+        auto close = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); };
+        const bool match = close(online.sharpe, offline_sharpe) && close(online.sortino, offline_sortino) &&
+                           online.max_drawdown == offline_drawdown &&
+                           flat_drawdown == reference.max_drawdown() && close(flat_drawdown, 0.2);
+        std::printf("engine + equity curve %8.2f ms (+ offline analysis %6.2f ms, %.1f MB stored)  "
+                    "online metrics only %8.2f ms  sharpe %.4f sortino %.4f max dd %.2f%%  agree: %s\n",
+                    best[0] * 1e3, best[2] * 1e3, curve_bytes / 1e6, best[1] * 1e3, online.sharpe,
+                    online.sortino, online.max_drawdown * 100.0, match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Per-bar signal path through Strategy& vs a compile-time StaticSMAStrategy; false on a mismatch
+     */
+    template <size_t ShortWindow, size_t LongWindow>
+    bool run_dispatch(const backtest::DataHandler& data, int repetitions) {
+        using Static = backtest::StaticSMAStrategy<ShortWindow, LongWindow>;
+        const backtest::BarColumns bars = data.columns();
+        std::vector<backtest::Signal> dynamic_signals(bars.size());
+        std::vector<backtest::Signal> static_signals(bars.size());
+        const backtest::SimulatedExecution execution;
+
+        double best[4] = {0.0, 0.0, 0.0, 0.0};
+        double values[2] = {0.0, 0.0};
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::SMAStrategy sma(ShortWindow, LongWindow);
+            backtest::Strategy& dynamic = sma;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < bars.size(); ++i) {
+                dynamic.on_new_bar(bars.bar(i));
+                dynamic_signals[i] = dynamic.generate_signal();
+            }
+            auto mid = std::chrono::steady_clock::now();
+            Static fixed;
+            for (size_t i = 0; i < bars.size(); ++i) {
+                fixed.on_new_bar(bars.bar(i));
+                static_signals[i] = fixed.generate_signal();
+            }
+            auto stop = std::chrono::steady_clock::now();
+
+            backtest::SMAStrategy engine_sma(ShortWindow, LongWindow);
+            backtest::BacktestEngine dynamic_engine(engine_sma, execution);
+            const double d = dynamic_engine.run(bars).seconds;
+            Static engine_fixed;
+            backtest::BasicBacktestEngine<Static> static_engine(engine_fixed, execution);
+            const double e = static_engine.run(bars).seconds;
+            values[0] = dynamic_engine.portfolio().total_value();
+            values[1] = static_engine.portfolio().total_value();
+
+            const double times[4] = {std::chrono::duration<double>(mid - start).count(),
+                                     std::chrono::duration<double>(stop - mid).count(), d, e};
+            for (int k = 0; k < 4; ++k) {
+                if (rep == 0 || times[k] < best[k]) best[k] = times[k];
+            }
+        }
+
+        bool identical = values[0] == values[1];
+        for (size_t i = 0; identical && i < bars.size(); ++i) {
+            identical = dynamic_signals[i].type == static_signals[i].type &&
+                        dynamic_signals[i].strength == static_signals[i].strength &&
+                        dynamic_signals[i].timestamp == static_signals[i].timestamp;
+        }
+
+        const double n = static_cast<double>(bars.size());
+        std::printf("SMA %3zu/%-4zu virtual %6.2f ns/bar  static %6.2f ns/bar  (%5.2fx)  "
+                    "engine virtual %6.2f  static %6.2f ns/bar  (%5.2fx)  identical: %s\n",
+                    ShortWindow, LongWindow, best[0] * 1e9 / n, best[1] * 1e9 / n, best[0] / best[1],
+                    best[2] * 1e9 / n, best[3] * 1e9 / n, best[2] / best[3], identical ? "yes" : "NO");
+        return identical;
+    }
+
+    /**
+     * @brief Times a sweep of many short strategy runs with and without RunArena; false if results differ
+     */
+    bool run_arena_sweep(const backtest::DataHandler& data, size_t bars, int repetitions) {
+        const backtest::BarColumns history = data.columns().slice(0, bars);
+        std::vector<size_t> short_windows;
+        std::vector<size_t> long_windows;
+        for (size_t w = 2; w <= 64; w += 2) short_windows.push_back(w);
+        for (size_t w = 20; w <= 400; w += 20) long_windows.push_back(w);
+        const std::vector<backtest::SmaParams> grid =
+            backtest::SweepEngine::make_grid(short_windows, long_windows);
+
+        // Strategy runs only, so every run allocates its rolling sums and buffers
+        backtest::SweepConfig config;
+        config.share_indicators = false;
+        double best[2] = {0.0, 0.0};
+        std::vector<backtest::SweepResult> results[2];
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int arena = 0; arena < 2; ++arena) {
+                config.run_arena = arena == 1;
+                const backtest::SweepEngine engine(history, config);
+                auto start = std::chrono::steady_clock::now();
+                results[arena] = engine.run(grid);
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[arena]) best[arena] = t;
+            }
+        }
+
+        bool match = results[0].size() == results[1].size();
+        for (size_t i = 0; match && i < results[0].size(); ++i) {
+            match = results[0][i].final_value == results[1][i].final_value &&
+                    results[0][i].trades == results[1][i].trades;
+        }
+        std::printf("sweep %zu runs x %zu bars: heap %7.2f us/run  arena %7.2f us/run  (%5.2fx)  identical: %s\n",
+                    grid.size(), history.size(), best[0] * 1e6 / grid.size(), best[1] * 1e6 / grid.size(),
+                    best[0] / best[1], match ? "yes" : "NO");
+        return match;
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * @brief Writes one text signal line per bar: ostream + std::endl vs RecordWriter; false on a mismatch
+     */
+    bool run_output(const backtest::DataHandler& data, int repetitions) {
+        const backtest::BarColumns bars = data.columns();
+        std::vector<backtest::Signal> signals(bars.size(), backtest::Signal(backtest::SignalType::HOLD, 0, 0.0));
+        backtest::SMAStrategy strategy(10, 50);
+        strategy.on_bars(bars, backtest::Span<backtest::Signal>(signals.data(), signals.size()));
+
+        const std::string paths[3] = {"bench_output_stream.txt", "bench_output_sync.txt", "bench_output_async.txt"};
+        double best[3] = {0.0, 0.0, 0.0};
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 3; ++variant) {
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    // The original main.cpp loop
+                    std::ofstream out(paths[0]);
+                    char timestamp[backtest::kTimestampBufferSize];
+                    for (size_t i = 0; i < bars.size(); ++i) {
+                        const backtest::SignalType type = signals[i].type;
+                        const char* label = type == backtest::SignalType::BUY    ? "BUY "
+                                            : type == backtest::SignalType::SELL ? "SELL"
+                                                                                 : "HOLD";
+                        backtest::format_timestamp(bars.timestamps[i], timestamp);
+                        out << timestamp << " | Close: " << bars.close[i] << " | Signal: " << label << std::endl;
+                    }
+                } else {
+                    backtest::RecordWriter out(backtest::RecordKind::Signals, backtest::OutputFormat::Text,
+                                               backtest::BufferedWriter::kDefaultChunkBytes, variant == 2);
+                    out.open(paths[variant]);
+                    for (size_t i = 0; i < bars.size(); ++i) {
+                        out.write_signal(bars.bar(i), signals[i]);
+                    }
+                    out.close();
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+        }
+
+        const std::string expected = read_file(paths[0]);
+        const bool match = !expected.empty() && read_file(paths[1]) == expected && read_file(paths[2]) == expected;
+        for (const std::string& path : paths) {
+            std::remove(path.c_str());
+        }
+
+        const double n = static_cast<double>(bars.size());
+        std::printf("signal lines: ostream+endl %7.2f ns/bar  buffered %7.2f ns/bar  background %7.2f ns/bar  "
+                    "(%5.2fx)  identical: %s\n",
+                    best[0] * 1e9 / n, best[1] * 1e9 / n, best[2] * 1e9 / n, best[0] / best[1],
+                    match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Walk-forward with warm-started slices vs every range replayed from bar 0
+     *
+     * Parallel and single-threaded runs must agree exactly (false otherwise).
+     * The full replay computes the same moving averages from a different
+     * starting point, so it is reported as a count of agreeing folds only.
+     */
+    bool run_walk_forward(const backtest::DataHandler& data, int repetitions) {
+        std::vector<size_t> short_windows;
+        std::vector<size_t> long_windows;
+        for (size_t w = 2; w <= 20; w += 2) short_windows.push_back(w);
+        for (size_t w = 20; w <= 200; w += 20) long_windows.push_back(w);
+        const std::vector<backtest::SmaParams> grid =
+            backtest::SweepEngine::make_grid(short_windows, long_windows);
+
+        backtest::WalkForwardConfig config;
+        config.train_bars = std::max<size_t>(data.size() / 10, 2);
+        config.test_bars = std::max<size_t>(data.size() / 40, 1);
+        double best[3] = {0.0, 0.0, 0.0};
+        std::vector<backtest::WalkForwardFold> folds[2];
+        size_t agreeing = 0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                config.sweep.threads = variant == 0 ? 0 : 1;
+                const backtest::WalkForwardRunner runner(data.columns(), config);
+                auto start = std::chrono::steady_clock::now();
+                folds[variant] = runner.run(grid);
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+
+            // Every range from bar 0, trading only inside it, as a fresh load and replay would
+            auto start = std::chrono::steady_clock::now();
+            agreeing = 0;
+            for (const backtest::WalkForwardFold& fold : folds[1]) {
+                backtest::SweepConfig sweep = config.sweep;
+                sweep.warmup_bars = fold.train_begin;
+                const std::vector<backtest::SweepResult> ranked =
+                    backtest::SweepEngine(data.columns().slice(0, fold.train_end), sweep).run(grid);
+                sweep.warmup_bars = fold.test_begin;
+                const backtest::SweepResult test =
+                    backtest::SweepEngine(data.columns().slice(0, fold.test_end), sweep).run_one(ranked.front().params);
+                if (test.trades == fold.test.trades &&
+                    std::fabs(test.final_value - fold.test.final_value) <= 1e-6 * std::fabs(test.final_value)) {
+                    ++agreeing;
+                }
+            }
+            const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || t < best[2]) best[2] = t;
+        }
+
+        bool match = folds[0].size() == folds[1].size();
+        for (size_t i = 0; match && i < folds[0].size(); ++i) {
+            match = folds[0][i].train.params.short_window == folds[1][i].train.params.short_window &&
+                    folds[0][i].train.params.long_window == folds[1][i].train.params.long_window &&
+                    folds[0][i].test.final_value == folds[1][i].test.final_value;
+        }
+        std::printf("walk-forward %zu folds x %zu points: warm slices %8.2f ms (%.2f ms 1 thread)  "
+                    "replay from bar 0 %8.2f ms  (%5.2fx)  agreeing folds %zu/%zu  identical: %s\n",
+                    folds[0].size(), grid.size(), best[0] * 1e3, best[1] * 1e3, best[2] * 1e3,
+                    best[2] / best[0], agreeing, folds[1].size(), match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief One pass per strategy vs a StrategyGroup pass (1 and all threads); false if signals differ
+     */
+    bool run_strategy_group(const backtest::DataHandler& data, size_t count, int repetitions) {
+        const backtest::BarColumns bars = data.columns();
+        const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        double best[3] = {0.0, 0.0, 0.0};
+        std::vector<uint64_t> checksums[3];
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 3; ++variant) {
+                std::vector<std::unique_ptr<backtest::SMAStrategy>> strategies;
+                for (size_t i = 0; i < count; ++i) {
+                    strategies.push_back(std::make_unique<backtest::SMAStrategy>(5 + i, 20 + 5 * i));
+                }
+                std::vector<uint64_t>& sums = checksums[variant];
+                sums.assign(count, 0);
+                auto sum_signals = [&](size_t index, backtest::Span<const backtest::Signal> signals) {
+                    uint64_t s = sums[index];
+                    for (const backtest::Signal& signal : signals) {
+                        s = s * 3 + static_cast<uint64_t>(signal.type);
+                    }
+                    sums[index] = s;
+                };
+
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    std::vector<backtest::Signal> signals(backtest::kDefaultGroupBlockSize);
+                    for (size_t i = 0; i < count; ++i) {
+                        backtest::BarCursor cursor(bars);
+                        while (cursor.has_next()) {
+                            const backtest::BarColumns block = cursor.next_block(backtest::kDefaultGroupBlockSize);
+                            strategies[i]->on_bars(block, backtest::Span<backtest::Signal>(signals.data(), block.size()));
+                            sum_signals(i, backtest::Span<const backtest::Signal>(signals.data(), block.size()));
+                        }
+                    }
+                } else {
+                    backtest::StrategyGroup group(backtest::kDefaultGroupBlockSize, variant == 1 ? 1 : threads);
+                    for (auto& strategy : strategies) {
+                        group.add(*strategy);
+                    }
+                    group.run(bars, [&](size_t index, const backtest::BarColumns&,
+                                        backtest::Span<const backtest::Signal> signals) {
+                        sum_signals(index, signals);
+                    });
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+        }
+
+        const bool match = checksums[0] == checksums[1] && checksums[0] == checksums[2];
+        std::printf("%zu strategies: separate passes %8.2f ms  group %8.2f ms (%5.2fx)  "
+                    "group %zu threads %8.2f ms (%5.2fx)  identical: %s\n",
+                    count, best[0] * 1e3, best[1] * 1e3, best[0] / best[1], threads, best[2] * 1e3,
+                    best[0] / best[2], match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Single-threaded engine vs the three-stage Pipeline over a streamed file; false on a mismatch
+     */
+    bool run_pipeline(const std::string& path, int repetitions) {
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        const backtest::SimulatedExecution execution(costs);
+
+        const backtest::WaitPolicy policies[2] = {backtest::WaitPolicy::Backoff, backtest::WaitPolicy::BusyPoll};
+        double best[3] = {0.0, 0.0, 0.0};
+        double values[3] = {0.0, 0.0, 0.0};
+        size_t fills[3] = {0, 0, 0};
+        backtest::PipelineStats last[2];
+        // Busy-polling stages only make progress when each has a core of its own
+        const bool spin = std::thread::hardware_concurrency() >= 3;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < (spin ? 3 : 2); ++variant) {
+                backtest::DataHandler data;
+                data.open_stream(path, "BENCH");
+                backtest::SMAStrategy strategy(10, 50);
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    backtest::BacktestEngine engine(strategy, execution);
+                    fills[variant] = engine.run(data).fills;
+                    values[variant] = engine.portfolio().total_value();
+                } else {
+                    backtest::PipelineConfig config;
+                    config.wait = policies[variant - 1];
+                    backtest::Pipeline pipeline(strategy, execution, config);
+                    last[variant - 1] = pipeline.run(data);
+                    fills[variant] = pipeline.engine_stats().fills;
+                    values[variant] = pipeline.portfolio().total_value();
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+        }
+
+        if (!spin) {
+            values[2] = values[0];
+            fills[2] = fills[0];
+        }
+        const bool match = values[0] == values[1] && values[0] == values[2] &&
+                           fills[0] == fills[1] && fills[0] == fills[2];
+        std::printf("open_stream + engine %9.2f ms  pipeline backoff %9.2f ms  busy-poll %9.2f ms%s  identical: %s\n",
+                    best[0] * 1e3, best[1] * 1e3, best[2] * 1e3, spin ? "" : " (skipped, < 3 cores)",
+                    match ? "yes" : "NO");
+        for (int i = 0; i < (spin ? 2 : 1); ++i) {
+            std::printf("  %-9s latency p50 %8llu ns  p99 %8llu ns  max depth %zu/%zu\n",
+                        i == 0 ? "backoff" : "busy-poll",
+                        static_cast<unsigned long long>(last[i].latency_ns.quantile(0.50)),
+                        static_cast<unsigned long long>(last[i].latency_ns.quantile(0.99)),
+                        std::max(last[i].bar_queue.max_depth, last[i].signal_queue.max_depth),
+                        last[i].bar_queue.capacity);
+        }
+        return match;
+    }
+
+    /**
+     * @brief Day-two run over a file with one appended bar: full replay vs resume from a checkpoint
+     *
+     * Returns false if the resumed run ends in a different state than the replay.
+     */
+    bool run_checkpoint(const std::string& path, int repetitions) {
+        std::ifstream in(path, std::ios::binary);
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const size_t cut = text.size() > 1 ? text.rfind('\n', text.size() - 2) : std::string::npos;
+        const std::string previous_path = path + ".previous.csv";
+        const std::string checkpoint_path = path + ".checkpoint";
+        {
+            std::ofstream out(previous_path, std::ios::binary | std::ios::trunc);
+            out.write(text.data(), static_cast<std::streamsize>(cut == std::string::npos ? 0 : cut + 1));
+        }
+
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        const backtest::SimulatedExecution execution(costs);
+
+        // Yesterday: the full run that leaves the checkpoint behind
+        bool saved = false;
+        {
+            backtest::DataHandler previous;
+            previous.load_csv(previous_path, "BENCH", backtest::LoadMode::MemoryMapped);
+            backtest::SMAStrategy strategy(10, 50);
+            backtest::BacktestEngine engine(strategy, execution);
+            engine.run(previous);
+            saved = backtest::save_checkpoint(checkpoint_path, engine, previous);
+        }
+
+        backtest::DataHandler data;
+        data.load_csv(path, "BENCH", backtest::LoadMode::MemoryMapped);
+        double best[2] = {0.0, 0.0};
+        double values[2] = {0.0, 0.0};
+        double realized[2] = {0.0, 0.0};
+        size_t resumed_bars = 0;
+        bool loaded = saved;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                data.reset();
+                backtest::SMAStrategy strategy(10, 50);
+                backtest::BacktestEngine engine(strategy, execution);
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    engine.run(data);
+                } else {
+                    loaded = backtest::load_checkpoint(checkpoint_path, engine, data) && loaded;
+                    resumed_bars = engine.resume(data).bars;
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+                values[variant] = engine.portfolio().total_value();
+                realized[variant] = engine.portfolio().realized_pnl();
+            }
+        }
+
+        std::remove(previous_path.c_str());
+        std::remove(checkpoint_path.c_str());
+        const bool match = loaded && values[0] == values[1] && realized[0] == realized[1];
+        std::printf("append 1 bar to %zu: replay %9.3f ms  checkpoint + resume %9.3f ms (%zu bars)  (%7.0fx)  "
+                    "identical: %s\n",
+                    data.size(), best[0] * 1e3, best[1] * 1e3, resumed_bars, best[0] / best[1],
+                    match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Whether two series are bit-identical (NaN entries must match too)
+     */
+    bool same_series(backtest::Span<const double> a, const std::vector<double>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            const bool both_nan = std::isnan(a[i]) && std::isnan(b[i]);
+            if (!both_nan && std::memcmp(&a[i], &b[i], sizeof(double)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Streaming indicators vs batch kernels, and 32 consumers with and without a shared graph
+     *
+     * Returns false if a batch or graph series differs from the streaming one.
+     */
+    bool run_indicators(const backtest::DataHandler& data, int repetitions) {
+        using backtest::IndicatorKind;
+        using backtest::PriceField;
+        const backtest::BarColumns bars = data.columns();
+        const size_t n = bars.size();
+        const size_t window = 50;
+
+        // Streaming, one bar at a time
+        std::vector<double> streamed[6];
+        double stream_seconds = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (std::vector<double>& s : streamed) s.assign(n, 0.0);
+            backtest::SmaIndicator sma(window);
+            backtest::EmaIndicator ema(window);
+            backtest::StdDevIndicator stddev(window);
+            backtest::RollingMinIndicator low(window);
+            backtest::RollingMaxIndicator high(window);
+            backtest::AtrIndicator atr(window);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < n; ++i) {
+                streamed[0][i] = sma.update(bars.close[i]);
+                streamed[1][i] = ema.update(bars.close[i]);
+                streamed[2][i] = stddev.update(bars.close[i]);
+                streamed[3][i] = low.update(bars.low[i]);
+                streamed[4][i] = high.update(bars.high[i]);
+                streamed[5][i] = atr.update(bars.high[i], bars.low[i], bars.close[i]);
+            }
+            const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || t < stream_seconds) stream_seconds = t;
+        }
+
+        // The same six series from a fresh graph
+        const backtest::IndicatorKey keys[6] = {
+            {IndicatorKind::Sma, PriceField::Close, window}, {IndicatorKind::Ema, PriceField::Close, window},
+            {IndicatorKind::StdDev, PriceField::Close, window}, {IndicatorKind::Min, PriceField::Low, window},
+            {IndicatorKind::Max, PriceField::High, window}, {IndicatorKind::Atr, PriceField::Close, window}};
+        double batch_seconds = 0.0;
+        bool match = true;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            backtest::IndicatorGraph graph(bars);
+            auto start = std::chrono::steady_clock::now();
+            for (const backtest::IndicatorKey& key : keys) {
+                graph.series(key);
+            }
+            const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || t < batch_seconds) batch_seconds = t;
+            if (rep == 0) {
+                for (int k = 0; k < 6; ++k) {
+                    const bool same = same_series(graph.series(keys[k]), streamed[k]);
+                    if (!same) {
+                        std::printf("  %s(%zu): batch differs from streaming\n",
+                                    backtest::indicator_kind_name(keys[k].kind), window);
+                    }
+                    match = same && match;
+                }
+                backtest::RollingMeanCache cache(bars.close);
+                cache.request({window});
+                cache.compute(window);
+                const backtest::Span<const double> cached = cache.means(window);
+                match = same_series(graph.sma(window), std::vector<double>(cached.begin(), cached.end())) && match;
+            }
+        }
+        std::printf("6 indicators x %zu bars: streaming %8.2f ms  batch %8.2f ms (%5.2fx)  identical: %s\n",
+                    n, stream_seconds * 1e3, batch_seconds * 1e3, stream_seconds / batch_seconds,
+                    match ? "yes" : "NO");
+
+        // 32 consumers: SMA and StdDev filters on windows 10..40 and an ATR stop of 14 or 20
+        const size_t consumers = 32;
+        std::vector<backtest::IndicatorKey> wanted;
+        for (size_t c = 0; c < consumers; ++c) {
+            wanted.push_back({IndicatorKind::Sma, PriceField::Close, 10 + 10 * (c % 4)});
+            wanted.push_back({IndicatorKind::StdDev, PriceField::Close, 20 + 10 * (c % 3)});
+            wanted.push_back({IndicatorKind::Atr, PriceField::Close, c % 2 == 0 ? size_t(14) : size_t(20)});
+        }
+        double best[2] = {0.0, 0.0};
+        double checksums[2] = {0.0, 0.0};
+        backtest::IndicatorGraphStats shared_stats;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                double checksum = 0.0;
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    std::vector<double> out(n);
+                    for (const backtest::IndicatorKey& key : wanted) {
+                        const backtest::Span<double> series(out);
+                        if (key.kind == IndicatorKind::Sma) {
+                            backtest::sma_batch(bars.close, key.window, series);
+                        } else if (key.kind == IndicatorKind::StdDev) {
+                            backtest::stddev_batch(bars.close, key.window, series);
+                        } else {
+                            backtest::atr_batch(bars.high, bars.low, bars.close, key.window, series);
+                        }
+                        checksum += out[n - 1];
+                    }
+                } else {
+                    backtest::IndicatorGraph graph(bars);
+                    for (const backtest::IndicatorKey& key : wanted) {
+                        checksum += graph.series(key)[n - 1];
+                    }
+                    shared_stats = graph.stats();
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+                checksums[variant] = checksum;
+            }
+        }
+        const bool shared_match = checksums[0] == checksums[1];
+        std::printf("%zu consumers, %zu series: recomputed %8.2f ms  shared graph %8.2f ms (%5.2fx, "
+                    "%zu series + %zu shared nodes, %.1f MB)  identical: %s\n",
+                    consumers, wanted.size(), best[0] * 1e3, best[1] * 1e3, best[0] / best[1],
+                    shared_stats.series_computed, shared_stats.shared_computed, shared_stats.bytes / 1e6,
+                    shared_match ? "yes" : "NO");
+        return match && shared_match;
+    }
+
+    /**
+     * @brief Top 10 of two symbols' sweeps: local SweepEngines vs a coordinator with loopback workers
+     */
+    bool run_distributed(const std::string& path, size_t rows, int repetitions) {
+        const std::string second_path = path + ".second.csv";
+        if (!backtest::write_synthetic_csv(second_path, rows, 7)) {
+            return false;
+        }
+        const std::vector<backtest::SweepSymbol> symbols = {{"FIRST", path}, {"SECOND", second_path}};
+        std::vector<size_t> short_windows;
+        std::vector<size_t> long_windows;
+        for (size_t w = 2; w <= 20; w += 2) short_windows.push_back(w);
+        for (size_t w = 10; w <= 100; w += 10) long_windows.push_back(w);
+        const std::vector<backtest::SmaParams> grid = backtest::SweepEngine::make_grid(short_windows, long_windows);
+        const size_t workers = 2;
+
+        backtest::DistributedSweepConfig config;
+        config.params_per_unit = 16;
+        config.progress_interval = 0.0;
+        double best[2] = {0.0, 0.0};
+        std::vector<backtest::DistributedResult> local;
+        std::vector<backtest::DistributedResult> remote;
+        backtest::DistributedSweepStats stats;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            auto start = std::chrono::steady_clock::now();
+            backtest::StreamingTopK top(config.top_k, config.sweep.rank_by);
+            for (const backtest::SweepSymbol& symbol : symbols) {
+                backtest::DataHandler data;
+                data.load_csv(symbol.path, symbol.symbol, backtest::LoadMode::MemoryMapped,
+                              backtest::CachePolicy::ReadWrite);
+                for (const backtest::SweepResult& result : backtest::SweepEngine(data.columns()).run(grid)) {
+                    top.push(backtest::DistributedResult{symbol.symbol, result});
+                }
+            }
+            local = top.sorted();
+            double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || t < best[0]) best[0] = t;
+
+            start = std::chrono::steady_clock::now();
+            backtest::SweepCoordinator coordinator(symbols, grid, config);
+            if (!coordinator.listen(0)) {
+                return false;
+            }
+            const size_t threads = std::max<size_t>(std::thread::hardware_concurrency() / workers, 1);
+            std::vector<std::thread> pool;
+            for (size_t i = 0; i < workers; ++i) {
+                pool.emplace_back([threads, port = coordinator.port()] {
+                    backtest::SweepWorker(threads).run("127.0.0.1", port);
+                });
+            }
+            remote = coordinator.run();
+            for (std::thread& worker : pool) {
+                worker.join();
+            }
+            stats = coordinator.stats();
+            t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || t < best[1]) best[1] = t;
+        }
+        std::remove(second_path.c_str());
+        std::remove(backtest::bar_cache_path(second_path).c_str());
+
+        bool match = local.size() == remote.size() && stats.failed == 0;
+        for (size_t i = 0; match && i < local.size(); ++i) {
+            const backtest::SweepResult& a = local[i].result;
+            const backtest::SweepResult& b = remote[i].result;
+            match = local[i].symbol == remote[i].symbol && a.params.short_window == b.params.short_window &&
+                    a.params.long_window == b.params.long_window && a.final_value == b.final_value &&
+                    a.trades == b.trades && a.metrics.sharpe == b.metrics.sharpe;
+        }
+        std::printf("2 symbols x %zu windows: local %8.2f ms  coordinator + %zu loopback workers %8.2f ms "
+                    "(%zu units)  top %zu identical: %s\n",
+                    grid.size(), best[0] * 1e3, workers, best[1] * 1e3, stats.units, local.size(),
+                    match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Serial add_file() per symbol vs one parallel add_files(); returns false if the feeds differ
+     */
+    bool run_parallel_load(size_t symbols, size_t rows_per_symbol, int repetitions) {
+        std::vector<backtest::DataFile> files;
+        for (size_t s = 0; s < symbols; ++s) {
+            files.push_back(backtest::DataFile{"bench_load_" + std::to_string(s) + ".csv", "LOAD" + std::to_string(s)});
+            // Uneven sizes, so the largest-first order matters
+            const size_t rows = rows_per_symbol / 4 + (s * 37) % (rows_per_symbol + 1);
+            if (!backtest::write_synthetic_csv(files.back().path, rows, 2000 + s)) {
+                return false;
+            }
+        }
+
+        double best[2] = {0.0, 0.0};
+        double checksum[2] = {0.0, 0.0};
+        size_t bars[2] = {0, 0};
+        bool ok = true;
+        backtest::ParallelLoadStats stats;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                backtest::MultiSymbolDataHandler feed;
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    for (const backtest::DataFile& file : files) {
+                        ok = feed.add_file(file.path, file.symbol) && ok;
+                    }
+                } else {
+                    ok = feed.add_files(files, backtest::ParallelLoadConfig(), &stats) && ok;
+                }
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+                bars[variant] = feed.size();
+                checksum[variant] = 0.0;
+                while (feed.has_next()) {
+                    const backtest::Bar bar = feed.get_next_bar();
+                    checksum[variant] += bar.close * static_cast<double>(bar.symbol_id + 1);
+                }
+            }
+        }
+        for (const backtest::DataFile& file : files) {
+            std::remove(file.path.c_str());
+        }
+
+        const bool match = ok && bars[0] == bars[1] && checksum[0] == checksum[1];
+        std::printf("load %zu files: add_file %8.2f ms  add_files %8.2f ms on %zu threads (%.2fx, %.0f MB/s)  "
+                    "same feed: %s\n",
+                    symbols, best[0] * 1e3, best[1] * 1e3, stats.threads, best[0] / best[1],
+                    static_cast<double>(stats.bytes) / (1024.0 * 1024.0) / best[1], match ? "yes" : "NO");
+        return match;
+    }
+
+    /**
+     * @brief Mapped load with vs without validation, then a damaged copy checked against its report
+     *
+     * The copy drops, duplicates and swaps rows and breaks highs at fixed
+     * positions, so the expected counts are known; with every missing minute
+     * forward-filled the cleaned file has as many bars as the original.
+     */
+    bool run_validation(const std::string& path, int repetitions) {
+        backtest::ValidationConfig config;
+        config.calendar = backtest::TradingCalendar::Continuous;  // Synthetic bars run around the clock
+        double best[2] = {0.0, 0.0};
+        size_t bars[2] = {0, 0};
+        bool clean = false;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                backtest::DataHandler data;
+                if (variant == 1) {
+                    data.set_validation(config);
+                }
+                auto start = std::chrono::steady_clock::now();
+                data.load_csv(path, "BENCH", backtest::LoadMode::MemoryMapped);
+                const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+                bars[variant] = data.size();
+                clean = variant == 0 || data.last_quality_report().clean();
+            }
+        }
+
+        std::ifstream in(path, std::ios::binary);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+        const std::string dirty_path = path + ".dirty.csv";
+        size_t dropped = 0, duplicated = 0, swapped = 0, broken = 0;
+        {
+            std::ofstream out(dirty_path, std::ios::binary | std::ios::trunc);
+            out << (lines.empty() ? std::string() : lines[0]) << '\n';
+            for (size_t i = 1; i < lines.size(); ++i) {
+                std::string line = lines[i];
+                switch (i % 1000) {
+                    case 300: {  // High of 1.00, below open and close
+                        const size_t a = line.find(',', line.find(',') + 1);
+                        const size_t b = line.find(',', a + 1);
+                        line.replace(a + 1, b - a - 1, "1.00");
+                        ++broken;
+                        break;
+                    }
+                    case 500:
+                        ++dropped;
+                        continue;
+                    case 700:
+                        out << line << '\n';
+                        ++duplicated;
+                        break;
+                    case 900:
+                        if (i + 1 < lines.size()) {
+                            out << lines[i + 1] << '\n' << line << '\n';
+                            ++i;
+                            ++swapped;
+                            continue;
+                        }
+                        break;
+                }
+                out << line << '\n';
+            }
+        }
+
+        backtest::DataHandler data;
+        data.set_validation(config);
+        data.load_csv(dirty_path, "BENCH", backtest::LoadMode::MemoryMapped);
+        const backtest::DataQualityReport& report = data.last_quality_report();
+        std::remove(dirty_path.c_str());
+        // A swapped row arrives late and is dropped, leaving a one-bar gap like a dropped row
+        const bool match = clean && bars[1] == bars[0] && report.bars_out == bars[0] && data.size() == bars[0] &&
+                           report.duplicates == duplicated && report.out_of_order == swapped &&
+                           report.ohlc_repaired == broken && report.invalid == 0 &&
+                           report.gaps == dropped + swapped && report.bars_filled == dropped + swapped &&
+                           report.gaps_unfilled == 0;
+        std::printf("mapped load %8.2f ms  validated %8.2f ms  (%.2fx)  damaged copy repaired: %s\n",
+                    best[0] * 1e3, best[1] * 1e3, best[1] / best[0], match ? "yes" : "NO");
+        backtest::print_quality_report(std::cout, "damaged copy", report);
+        return match;
+    }
+
+    /**
+     * @brief Engine over double columns vs float32 and tick compact stores, with their P&L divergence
+     */
+    bool run_compact(const backtest::DataHandler& data, int repetitions) {
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        const backtest::SimulatedExecution execution(costs);
+        backtest::BasicCompactBarStore<backtest::Float32PriceCodec> floats;
+        backtest::BasicCompactBarStore<backtest::TickPriceCodec> ticks;
+        if (!floats.assign(data.columns()) || !ticks.assign(data.columns())) {
+            return false;
+        }
+
+        double best[3] = {0.0, 0.0, 0.0};
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 3; ++variant) {
+                backtest::SMAStrategy strategy(10, 50);
+                backtest::EngineConfig config;
+                config.record_equity = false;
+                backtest::BacktestEngine engine(strategy, execution, config);
+                const double t = variant == 0 ? engine.run(data.columns()).seconds
+                               : variant == 1 ? engine.run(floats).seconds
+                                              : engine.run(ticks).seconds;
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+        }
+        std::printf("engine over double %8.2f ms  float32 %8.2f ms  ticks %8.2f ms  (%zu -> %zu bytes/bar)\n",
+                    best[0] * 1e3, best[1] * 1e3, best[2] * 1e3,
+                    sizeof(backtest::Timestamp) + sizeof(backtest::SymbolId) + 5 * sizeof(double),
+                    floats.bytes_per_bar());
+
+        // Sweeps read the configured layout's closes a block at a time; only float32 rounds them
+        backtest::CompactBarStore configured;
+        if (!configured.assign(data.columns())) {
+            return false;
+        }
+        const std::vector<backtest::SmaParams> grid =
+            backtest::SweepEngine::make_grid({5, 10, 20, 40}, {50, 100, 200});
+        backtest::SweepConfig sweep_config;
+        sweep_config.threads = 1;
+        const backtest::SweepEngine sweeps[2] = {backtest::SweepEngine(data.columns(), sweep_config),
+                                                 backtest::SweepEngine(configured, sweep_config)};
+        std::vector<backtest::SweepResult> results[2];
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (int variant = 0; variant < 2; ++variant) {
+                auto start = std::chrono::steady_clock::now();
+                results[variant] = sweeps[variant].run(grid);
+                auto stop = std::chrono::steady_clock::now();
+                const double t = std::chrono::duration<double>(stop - start).count();
+                if (rep == 0 || t < best[variant]) best[variant] = t;
+            }
+        }
+        bool same_sweep = results[1].size() == results[0].size();
+        for (size_t i = 0; same_sweep && i < results[0].size(); ++i) {
+            same_sweep = results[1][i].params.short_window == results[0][i].params.short_window &&
+                         results[1][i].params.long_window == results[0][i].params.long_window &&
+                         results[1][i].final_value == results[0][i].final_value;
+        }
+        const bool exact = !std::is_same<backtest::PriceCodec, backtest::Float32PriceCodec>::value;
+        std::printf("sweep over double  %8.2f ms  %-7s %8.2f ms  (%zu runs, identical: %s)\n",
+                    best[0] * 1e3, backtest::PriceCodec::name, best[1] * 1e3, grid.size(),
+                    same_sweep ? "yes" : exact ? "NO" : "no (float32 rounding)");
+
+        backtest::SMAStrategy reference[2] = {backtest::SMAStrategy(10, 50), backtest::SMAStrategy(10, 50)};
+        backtest::SMAStrategy candidate[2] = {backtest::SMAStrategy(10, 50), backtest::SMAStrategy(10, 50)};
+        const backtest::PrecisionReport reports[2] = {
+            backtest::check_storage_precision(data.columns(), floats, reference[0], candidate[0], execution),
+            backtest::check_storage_precision(data.columns(), ticks, reference[1], candidate[1], execution)};
+        for (const backtest::PrecisionReport& report : reports) {
+            backtest::print_precision_report(std::cout, report);
+        }
+        // Tick storage is exact for prices on the cent grid, which the synthetic generator writes
+        return (same_sweep || !exact) && reports[1].final_value_error() == 0.0 && reports[1].same_fills();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+    const std::string path = "bench_synthetic.csv";
+
+    std::cout << "Generating " << rows << " rows into " << path << std::endl;
+    if (!backtest::write_synthetic_csv(path, rows)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return 1;
+    }
+
+    LoadResult stream = run_load(path, backtest::LoadMode::Stream, repetitions);
+    LoadResult mapped = run_load(path, backtest::LoadMode::MemoryMapped, repetitions);
+
+    // The first cached load parses and writes the sidecar; the timed ones map it
+    const std::string cache_path = backtest::bar_cache_path(path);
+    std::remove(cache_path.c_str());
+    const LoadResult primed = run_load(path, backtest::LoadMode::MemoryMapped, 1, backtest::CachePolicy::ReadWrite);
+    LoadResult cached = run_load(path, backtest::LoadMode::MemoryMapped, repetitions, backtest::CachePolicy::ReadWrite);
+    LoadResult streamed = run_stream(path, repetitions);
+
+    std::cout << "load_csv, best of " << repetitions << ":" << std::endl;
+    print_result("Stream", stream);
+    print_result("MemoryMapped", mapped);
+    print_result("Cache write", primed);
+    print_result("Cache reload", cached);
+    print_result("open_stream", streamed);
+    std::printf("speedup        %10.2fx (MemoryMapped), %.2fx (cache reload)\n",
+                stream.best_seconds / mapped.best_seconds, stream.best_seconds / cached.best_seconds);
+
+    bool identical = stream.rows == mapped.rows && stream.close_checksum == mapped.close_checksum &&
+                     cached.rows == mapped.rows && cached.close_checksum == mapped.close_checksum &&
+                     !primed.from_cache && cached.from_cache &&
+                     streamed.rows == mapped.rows && streamed.close_checksum == mapped.close_checksum;
+    std::cout << "results identical: " << (identical ? "yes" : "NO") << std::endl;
+
+    backtest::DataHandler data;
+    data.load_csv(path, "BENCH", backtest::LoadMode::MemoryMapped);
+    std::cout << "SMAStrategy signals, best of " << repetitions
+              << " (kernel: " << backtest::sma_crossover_kernel_isa() << "):" << std::endl;
+    identical = run_sma(data, 10, 50, repetitions) && identical;
+    identical = run_sma(data, 50, 200, repetitions) && identical;
+    identical = run_sma(data, 200, 500, repetitions) && identical;
+
+    std::cout << "MultiSymbolDataHandler, best of " << repetitions << ":" << std::endl;
+    identical = run_merge(3000, std::max<size_t>(rows / 3000, 2), repetitions) && identical;
+
+    std::cout << "Portfolio marking, best of " << repetitions << ":" << std::endl;
+    identical = run_marking(3000, std::max<size_t>(rows / 3000, 2), repetitions) && identical;
+
+    std::cout << "BacktestEngine, best of " << repetitions << ":" << std::endl;
+    identical = run_engine(data, 10, 50, repetitions) && identical;
+    identical = run_metrics(data, repetitions) && identical;
+
+    std::cout << "Strategy dispatch, best of " << repetitions << ":" << std::endl;
+    identical = run_dispatch<10, 50>(data, repetitions) && identical;
+    identical = run_dispatch<50, 200>(data, repetitions) && identical;
+
+    std::cout << "Sweep run allocation, best of " << repetitions << ":" << std::endl;
+    identical = run_arena_sweep(data, 2000, repetitions) && identical;
+
+    std::cout << "Signal output, best of " << repetitions << ":" << std::endl;
+    identical = run_output(data, repetitions) && identical;
+
+    std::cout << "Walk-forward, best of " << repetitions << ":" << std::endl;
+    identical = run_walk_forward(data, repetitions) && identical;
+
+    std::cout << "StrategyGroup, best of " << repetitions << ":" << std::endl;
+    identical = run_strategy_group(data, 32, repetitions) && identical;
+
+    std::cout << "Pipeline, best of " << repetitions << ":" << std::endl;
+    identical = run_pipeline(path, repetitions) && identical;
+
+    std::cout << "Checkpoint, best of " << repetitions << ":" << std::endl;
+    identical = run_checkpoint(path, repetitions) && identical;
+
+    std::cout << "Indicators, best of " << repetitions << ":" << std::endl;
+    identical = run_indicators(data, repetitions) && identical;
+
+    std::cout << "Compact price storage, best of " << repetitions << ":" << std::endl;
+    identical = run_compact(data, repetitions) && identical;
+
+    std::cout << "Distributed sweep, best of " << repetitions << ":" << std::endl;
+    identical = run_distributed(path, std::min<size_t>(rows, 200000), repetitions) && identical;
+
+    std::cout << "Load validation, best of " << repetitions << ":" << std::endl;
+    identical = run_validation(path, repetitions) && identical;
+
+    std::cout << "Parallel file loading, best of " << repetitions << ":" << std::endl;
+    identical = run_parallel_load(64, std::max<size_t>(rows / 64, 8), repetitions) && identical;
+
+    std::remove(path.c_str());
+    std::remove(cache_path.c_str());
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+/**
+ * @file microbench.cpp
+ * @brief Google Benchmark suite covering loading, strategies, portfolio and the engine
+ *
+ * Complements `bench` (which compares alternative implementations and checks
+ * that they agree) with steady, statistically repeated measurements meant
+ * for tracking regressions:
+ * - DataHandler::load_csv throughput per LoadMode, sidecar reload and
+ *   streaming, in bytes/s and rows (items)/s
+ * - SMAStrategy::on_new_bar cost per bar across window sizes, virtual vs
+ *   statically dispatched, and the batch on_bars path
+ * - Portfolio open/close, mark and valuation latency as the book grows
+ * - end-to-end bars/s of BacktestEngine, from memory and from CSV
+ *
+ * Usage: microbench [--rows=<count>] [benchmark flags, e.g. --benchmark_filter=Load]
+ *   --rows adds one more file size (k/M/G suffixes, e.g. --rows=100M) to the
+ *   data-size dependent benchmarks; files are generated on first use and
+ *   removed on exit.
+ */
+
+#include "synthetic_data.hpp"
+#include "data/bar_cache.hpp"
+#include "data/data_handler.hpp"
+#include "engine/backtest_engine.hpp"
+#include "portfolio/portfolio.hpp"
+#include "strategy/sma_strategy.hpp"
+#include "strategy/static_sma_strategy.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Generated input files and loaded datasets, created on first use
+     */
+    class Fixtures {
+    public:
+        ~Fixtures() {
+            for (const auto& entry : files_) {
+                std::remove(entry.second.c_str());
+                std::remove(backtest::bar_cache_path(entry.second).c_str());
+            }
+        }
+
+        const std::string& file(size_t rows) {
+            auto it = files_.find(rows);
+            if (it == files_.end()) {
+                const std::string path = "microbench_" + std::to_string(rows) + ".csv";
+                if (!backtest::write_synthetic_csv(path, rows)) {
+                    std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+                }
+                it = files_.emplace(rows, path).first;
+            }
+            return it->second;
+        }
+
+        const backtest::DataHandler& data(size_t rows) {
+            auto it = data_.find(rows);
+            if (it == data_.end()) {
+                auto handler = std::make_unique<backtest::DataHandler>();
+                handler->load_csv(file(rows), "BENCH", backtest::LoadMode::MemoryMapped);
+                it = data_.emplace(rows, std::move(handler)).first;
+            }
+            return *it->second;
+        }
+
+    private:
+        std::map<size_t, std::string> files_;
+        std::map<size_t, std::unique_ptr<backtest::DataHandler>> data_;
+    };
+
+    Fixtures& fixtures() {
+        static Fixtures instance;
+        return instance;
+    }
+
+    /// Bars every strategy and engine benchmark replays
+    constexpr size_t kStrategyRows = 1000000;
+
+    // ---------------------------------------------------------------- loading
+
+    void BM_LoadCsv(benchmark::State& state, backtest::LoadMode mode, backtest::CachePolicy cache) {
+        const size_t rows = static_cast<size_t>(state.range(0));
+        const std::string& path = fixtures().file(rows);
+        if (cache == backtest::CachePolicy::ReadWrite) {
+            backtest::DataHandler prime;
+            prime.load_csv(path, "BENCH", mode, cache);  // Writes the sidecar outside the timing
+        }
+
+        size_t bytes = 0;
+        size_t loaded = 0;
+        for (auto _ : state) {
+            backtest::DataHandler data;
+            if (!data.load_csv(path, "BENCH", mode, cache)) {
+                state.SkipWithError("load_csv failed");
+                break;
+            }
+            bytes = data.last_load_stats().bytes_read;
+            loaded = data.size();
+            benchmark::DoNotOptimize(data.columns().close.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * loaded));
+        state.counters["rows"] = static_cast<double>(loaded);
+    }
+
+    void BM_StreamCsv(benchmark::State& state) {
+        const size_t rows = static_cast<size_t>(state.range(0));
+        const std::string& path = fixtures().file(rows);
+
+        size_t bytes = 0;
+        size_t loaded = 0;
+        for (auto _ : state) {
+            backtest::DataHandler data;
+            data.open_stream(path, "BENCH");
+            double checksum = 0.0;
+            while (data.has_next()) {
+                checksum += data.get_next_bar().close;
+            }
+            benchmark::DoNotOptimize(checksum);
+            bytes = data.last_load_stats().bytes_read;
+            loaded = data.last_load_stats().rows_loaded;
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * loaded));
+    }
+
+    // --------------------------------------------------------------- strategy
+
+    /**
+     * @brief One on_new_bar() + generate_signal() per iteration through the virtual interface
+     */
+    void BM_SmaOnNewBar(benchmark::State& state) {
+        const backtest::BarColumns bars = fixtures().data(kStrategyRows).columns();
+        backtest::SMAStrategy sma(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+        backtest::Strategy& strategy = sma;
+        size_t i = 0;
+        for (auto _ : state) {
+            strategy.on_new_bar(bars.bar(i));
+            benchmark::DoNotOptimize(strategy.generate_signal());
+            if (++i == bars.size()) i = 0;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    /**
+     * @brief Same as BM_SmaOnNewBar with compile-time windows and direct calls
+     */
+    template <size_t ShortWindow, size_t LongWindow>
+    void BM_StaticSmaOnNewBar(benchmark::State& state) {
+        const backtest::BarColumns bars = fixtures().data(kStrategyRows).columns();
+        backtest::StaticSMAStrategy<ShortWindow, LongWindow> strategy;
+        size_t i = 0;
+        for (auto _ : state) {
+            strategy.on_new_bar(bars.bar(i));
+            benchmark::DoNotOptimize(strategy.generate_signal());
+            if (++i == bars.size()) i = 0;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    /**
+     * @brief SMAStrategy::on_bars() over a block of 4096 bars per iteration
+     */
+    void BM_SmaOnBars(benchmark::State& state) {
+        constexpr size_t kBlock = 4096;
+        const backtest::BarColumns bars = fixtures().data(kStrategyRows).columns();
+        backtest::SMAStrategy strategy(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+        std::vector<backtest::Signal> signals(kBlock);
+        size_t offset = 0;
+        for (auto _ : state) {
+            strategy.on_bars(bars.slice(offset, kBlock), signals);
+            benchmark::DoNotOptimize(signals.data());
+            offset += kBlock;
+            if (offset + kBlock > bars.size()) offset = 0;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBlock));
+    }
+
+    // -------------------------------------------------------------- portfolio
+
+    /**
+     * @brief Interned ids of the portfolio benchmark symbols PB0..PB(n-1)
+     */
+    const std::vector<backtest::SymbolId>& book_symbols(size_t n) {
+        static std::vector<backtest::SymbolId> ids;
+        while (ids.size() < n) {
+            ids.push_back(backtest::intern_symbol("PB" + std::to_string(ids.size())));
+        }
+        return ids;
+    }
+
+    backtest::Portfolio make_book(size_t positions) {
+        const std::vector<backtest::SymbolId>& ids = book_symbols(positions + 1);
+        backtest::Portfolio portfolio(1e12);
+        for (size_t s = 0; s < positions; ++s) {
+            portfolio.open_position(ids[s], 100 + static_cast<int>(s % 50), 50.0);
+        }
+        return portfolio;
+    }
+
+    /**
+     * @brief Opening and fully closing one extra position next to `positions` held ones
+     */
+    void BM_PortfolioOpenClose(benchmark::State& state) {
+        const size_t positions = static_cast<size_t>(state.range(0));
+        backtest::Portfolio portfolio = make_book(positions);
+        const backtest::SymbolId extra = book_symbols(positions + 1)[positions];
+        for (auto _ : state) {
+            portfolio.open_position(extra, 100, 50.0, 1.0);
+            portfolio.close_position(extra, 100, 50.5, 1.0);
+        }
+        benchmark::DoNotOptimize(portfolio.total_value());
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+    }
+
+    /**
+     * @brief Adding to and reducing an existing position
+     */
+    void BM_PortfolioAdjust(benchmark::State& state) {
+        const size_t positions = static_cast<size_t>(state.range(0));
+        backtest::Portfolio portfolio = make_book(positions);
+        const std::vector<backtest::SymbolId>& ids = book_symbols(positions);
+        size_t s = 0;
+        for (auto _ : state) {
+            portfolio.open_position(ids[s], 10, 51.0);
+            portfolio.close_position(ids[s], 10, 51.5);
+            if (++s == positions) s = 0;
+        }
+        benchmark::DoNotOptimize(portfolio.total_value());
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+    }
+
+    void BM_PortfolioUpdatePrice(benchmark::State& state) {
+        const size_t positions = static_cast<size_t>(state.range(0));
+        backtest::Portfolio portfolio = make_book(positions);
+        const std::vector<backtest::SymbolId>& ids = book_symbols(positions);
+        size_t s = 0;
+        double price = 50.0;
+        for (auto _ : state) {
+            portfolio.update_price(ids[s], price);
+            price = price < 60.0 ? price + 0.01 : 50.0;
+            if (++s == positions) s = 0;
+        }
+        benchmark::DoNotOptimize(portfolio.total_value());
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_PortfolioTotalValue(benchmark::State& state) {
+        const backtest::Portfolio portfolio = make_book(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(portfolio.total_value());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    // ----------------------------------------------------------------- engine
+
+    /**
+     * @brief Full BacktestEngine replay of in-memory bars, SMA 10/50, $1 commission, 2 bps slippage
+     */
+    void BM_EngineRun(benchmark::State& state) {
+        const backtest::BarColumns bars = fixtures().data(static_cast<size_t>(state.range(0))).columns();
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        costs.slippage_bps = 2.0;
+        const backtest::SimulatedExecution execution(costs);
+        for (auto _ : state) {
+            backtest::SMAStrategy strategy(10, 50);
+            backtest::BacktestEngine engine(strategy, execution);
+            benchmark::DoNotOptimize(engine.run(bars).fills);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars.size()));
+    }
+
+    void BM_StaticEngineRun(benchmark::State& state) {
+        using Static = backtest::StaticSMAStrategy<10, 50>;
+        const backtest::BarColumns bars = fixtures().data(static_cast<size_t>(state.range(0))).columns();
+        backtest::CostModelConfig costs;
+        costs.commission_per_order = 1.0;
+        costs.slippage_bps = 2.0;
+        const backtest::SimulatedExecution execution(costs);
+        for (auto _ : state) {
+            Static strategy;
+            backtest::BasicBacktestEngine<Static> engine(strategy, execution);
+            benchmark::DoNotOptimize(engine.run(bars).fills);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars.size()));
+    }
+
+    /**
+     * @brief CSV load (MemoryMapped) plus the engine run, per iteration
+     */
+    void BM_EndToEnd(benchmark::State& state) {
+        const size_t rows = static_cast<size_t>(state.range(0));
+        const std::string& path = fixtures().file(rows);
+        const backtest::SimulatedExecution execution;
+        size_t bars = 0;
+        for (auto _ : state) {
+            backtest::DataHandler data;
+            data.load_csv(path, "BENCH", backtest::LoadMode::MemoryMapped);
+            backtest::SMAStrategy strategy(10, 50);
+            backtest::BacktestEngine engine(strategy, execution);
+            bars = engine.run(data).bars;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars));
+    }
+
+    // --------------------------------------------------------- registration
+
+    void register_benchmarks(const std::vector<size_t>& file_rows) {
+        struct Load {
+            const char* name;
+            backtest::LoadMode mode;
+            backtest::CachePolicy cache;
+        };
+        const Load loads[] = {
+            {"BM_LoadCsv/Stream", backtest::LoadMode::Stream, backtest::CachePolicy::Disabled},
+            {"BM_LoadCsv/MemoryMapped", backtest::LoadMode::MemoryMapped, backtest::CachePolicy::Disabled},
+            {"BM_LoadCsv/CacheReload", backtest::LoadMode::MemoryMapped, backtest::CachePolicy::ReadWrite},
+        };
+        for (const Load& load : loads) {
+            auto* b = benchmark::RegisterBenchmark(load.name, BM_LoadCsv, load.mode, load.cache);
+            for (size_t rows : file_rows) b->Arg(static_cast<int64_t>(rows));
+            b->Unit(benchmark::kMillisecond)->UseRealTime();
+        }
+        auto* stream = benchmark::RegisterBenchmark("BM_StreamCsv", BM_StreamCsv);
+        for (size_t rows : file_rows) stream->Arg(static_cast<int64_t>(rows));
+        stream->Unit(benchmark::kMillisecond)->UseRealTime();
+
+        auto* sma = benchmark::RegisterBenchmark("BM_SmaOnNewBar", BM_SmaOnNewBar);
+        auto* batch = benchmark::RegisterBenchmark("BM_SmaOnBars", BM_SmaOnBars);
+        for (auto* b : {sma, batch}) {
+            b->ArgNames({"short", "long"});
+            b->Args({5, 20})->Args({10, 50})->Args({50, 200})->Args({200, 1000})->Args({1000, 5000});
+        }
+        benchmark::RegisterBenchmark("BM_StaticSmaOnNewBar<10,50>", BM_StaticSmaOnNewBar<10, 50>);
+        benchmark::RegisterBenchmark("BM_StaticSmaOnNewBar<50,200>", BM_StaticSmaOnNewBar<50, 200>);
+        benchmark::RegisterBenchmark("BM_StaticSmaOnNewBar<200,1000>", BM_StaticSmaOnNewBar<200, 1000>);
+
+        for (auto* b : {benchmark::RegisterBenchmark("BM_PortfolioOpenClose", BM_PortfolioOpenClose),
+                        benchmark::RegisterBenchmark("BM_PortfolioAdjust", BM_PortfolioAdjust),
+                        benchmark::RegisterBenchmark("BM_PortfolioUpdatePrice", BM_PortfolioUpdatePrice),
+                        benchmark::RegisterBenchmark("BM_PortfolioTotalValue", BM_PortfolioTotalValue)}) {
+            b->ArgName("positions")->RangeMultiplier(8)->Range(1, 1 << 15);
+        }
+
+        for (auto* b : {benchmark::RegisterBenchmark("BM_EngineRun", BM_EngineRun),
+                        benchmark::RegisterBenchmark("BM_StaticEngineRun", BM_StaticEngineRun),
+                        benchmark::RegisterBenchmark("BM_EndToEnd", BM_EndToEnd)}) {
+            for (size_t rows : file_rows) b->Arg(static_cast<int64_t>(rows));
+            b->Unit(benchmark::kMillisecond)->UseRealTime();
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> file_rows = {1000, 100000, kStrategyRows};
+
+    // Strip our own flag before Google Benchmark sees the arguments
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--rows=", 7) == 0) {
+            size_t rows = 0;
+            if (!backtest::parse_row_count(argv[i] + 7, rows) || rows == 0) {
+                std::fprintf(stderr, "Invalid row count: %s\n", argv[i] + 7);
+                return 1;
+            }
+            file_rows.push_back(rows);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    register_benchmarks(file_rows);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file synthetic_data.cpp
+ * @brief Implementation of the synthetic OHLCV generator
+ */
+
+#include "synthetic_data.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace backtest {
+
+    bool write_synthetic_csv(const std::string& path, const SyntheticSpec& spec) {
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (out == nullptr) {
+            return false;
+        }
+
+        std::mt19937_64 rng(spec.seed);
+        std::normal_distribution<double> step(0.0, 0.5);
+        std::uniform_real_distribution<double> spread(0.0, 1.5);
+        std::uniform_int_distribution<long> volume(100000, 5000000);
+
+        // Rows are formatted into one buffer and written in large blocks
+        constexpr size_t kFlushBytes = 1 << 20;
+        std::vector<char> buffer(kFlushBytes + 256);
+        size_t used = 0;
+        bool ok = true;
+        auto flush = [&]() {
+            ok = ok && std::fwrite(buffer.data(), 1, used, out) == used;
+            used = 0;
+        };
+
+        static const char kHeader[] = "timestamp,open,high,low,close,volume\n";
+        std::fputs(kHeader, out);
+
+        char timestamp[kTimestampBufferSize];
+        double price = spec.start_price;
+        Timestamp ts = spec.start;
+        const Timestamp step_ns = spec.step_seconds * kNanosPerSecond;
+        for (size_t i = 0; i < spec.rows; ++i) {
+            // The walk is floored at 1.0 before a row is written, and lows stay above half the body,
+            // so every price is positive
+            const double open = price;
+            const double move = price + step(rng);
+            const double close = move > 1.0 ? move : 1.0;
+            const double high = (open > close ? open : close) + spread(rng);
+            const double body_low = open < close ? open : close;
+            const double wick = body_low - spread(rng);
+            const double low = wick > 0.5 * body_low ? wick : 0.5 * body_low;
+            format_timestamp(ts, timestamp);
+            const int n = std::snprintf(buffer.data() + used, buffer.size() - used,
+                                        "%s,%.2f,%.2f,%.2f,%.2f,%ld\n",
+                                        timestamp, open, high, low, close, volume(rng));
+            used += n > 0 ? static_cast<size_t>(n) : 0;
+            if (used >= kFlushBytes) {
+                flush();
+            }
+            price = close;
+            ts += step_ns;
+        }
+        flush();
+        return std::fclose(out) == 0 && ok;
+    }
+
+    bool write_synthetic_csv(const std::string& path, size_t rows, uint64_t seed) {
+        SyntheticSpec spec;
+        spec.rows = rows;
+        spec.seed = seed;
+        return write_synthetic_csv(path, spec);
+    }
+
+    bool parse_row_count(const char* text, size_t& rows) {
+        char* end = nullptr;
+        const double value = std::strtod(text, &end);
+        if (end == text || !(value >= 0.0)) {
+            return false;
+        }
+        double scale = 1.0;
+        switch (*end) {
+            case '\0': break;
+            case 'k': case 'K': scale = 1e3; ++end; break;
+            case 'm': case 'M': scale = 1e6; ++end; break;
+            case 'g': case 'G': scale = 1e9; ++end; break;
+            default: return false;
+        }
+        if (*end != '\0') {
+            return false;
+        }
+        rows = static_cast<size_t>(value * scale + 0.5);
+        return true;
+    }
+
+} // namespace backtest
@@ -0,0 +1,50 @@
+/**
+ * @file synthetic_data.hpp
+ * @brief Reproducible random-walk OHLCV files for benchmarks
+ *
+ * Shared by the bench, microbench and gen_data targets so every benchmark
+ * measures the same data. Files from 1k to 100M+ rows are written in one
+ * buffered pass; timestamps increase strictly (one bar per step), so files of
+ * any length are valid input for MultiSymbolDataHandler as well.
+ */
+
+#ifndef SYNTHETIC_DATA_HPP
+#define SYNTHETIC_DATA_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "data/timestamp.hpp"
+
+namespace backtest {
+
+    /**
+     * @struct SyntheticSpec
+     * @brief Shape of a generated file
+     */
+    struct SyntheticSpec {
+        size_t rows = 1000000;             ///< Data rows (the header is extra)
+        uint64_t seed = 42;                ///< Seed of the random walk
+        double start_price = 100.0;        ///< Open of the first bar
+        Timestamp start = 1577836800LL * kNanosPerSecond;  ///< Time of the first bar (2020-01-01)
+        int64_t step_seconds = 60;         ///< Bar length (minute bars by default)
+    };
+
+    /**
+     * @brief Writes a random-walk OHLCV CSV (timestamp,open,high,low,close,volume)
+     * @return false if the file cannot be written
+     */
+    bool write_synthetic_csv(const std::string& path, const SyntheticSpec& spec);
+
+    /**
+     * @brief Same as above with default shape, rows and seed given
+     */
+    bool write_synthetic_csv(const std::string& path, size_t rows, uint64_t seed = 42);
+
+    /**
+     * @brief Parses a row count such as "1000", "250k", "10M" or "1G"
+     * @return false on malformed input
+     */
+    bool parse_row_count(const char* text, size_t& rows);
+
+} // namespace backtest
+#endif // SYNTHETIC_DATA_HPP
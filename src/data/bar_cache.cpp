@@ -0,0 +1,273 @@
+/**
+ * @file bar_cache.cpp
+ * @brief Writing, validating and mapping binary bar caches
+ */
+
+#include "bar_cache.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace backtest {
+
+    namespace {
+
+        static_assert(std::is_trivially_copyable<BarCacheHeader>::value, "header is written as raw bytes");
+
+        constexpr uint32_t kByteOrderTag = 0x01020304;
+        constexpr size_t kColumnCount = 7;
+        constexpr size_t kColumnWidths[kColumnCount] = {
+            sizeof(Timestamp), sizeof(uint32_t), sizeof(double), sizeof(double),
+            sizeof(double), sizeof(double), sizeof(double)};
+
+        inline uint64_t align_up(uint64_t offset) {
+            return (offset + kBarCacheAlignment - 1) & ~static_cast<uint64_t>(kBarCacheAlignment - 1);
+        }
+
+        inline uint64_t rotl(uint64_t x, int r) {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline uint64_t load_u64(const char* p) {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t mix(uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /**
+         * @brief Writes zero bytes until the stream position reaches offset
+         */
+        void pad_to(std::ofstream& out, uint64_t& position, uint64_t offset) {
+            static const char zeros[kBarCacheAlignment] = {};  // Padding is always < one alignment unit
+            out.write(zeros, static_cast<std::streamsize>(offset - position));
+            position = offset;
+        }
+
+        /**
+         * @brief Per-writer temporary name; the sequence number separates threads of one process
+         */
+        std::string temporary_path(const std::string& cache_path) {
+            static std::atomic<unsigned long> sequence{0};
+            const std::string suffix = "." + std::to_string(sequence.fetch_add(1, std::memory_order_relaxed));
+#if defined(__unix__) || defined(__APPLE__)
+            return cache_path + ".tmp." + std::to_string(static_cast<long>(::getpid())) + suffix;
+#else
+            return cache_path + ".tmp" + suffix;
+#endif
+        }
+
+    } // namespace
+
+    uint64_t checksum_bytes(const char* data, size_t size) {
+        constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ULL;
+        constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4fULL;
+
+        uint64_t lanes[4] = {kPrime1, kPrime2, ~kPrime1, ~kPrime2};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                lanes[lane] = rotl(lanes[lane] + load_u64(data + i + 8 * lane) * kPrime2, 31) * kPrime1;
+            }
+        }
+
+        uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        for (; i + 8 <= size; i += 8) {
+            h = rotl(h ^ (load_u64(data + i) * kPrime2), 27) * kPrime1;
+        }
+        for (; i < size; ++i) {
+            h = rotl(h ^ (static_cast<uint8_t>(data[i]) * kPrime1), 11) * kPrime2;
+        }
+        return mix(h ^ static_cast<uint64_t>(size));
+    }
+
+    std::string bar_cache_path(const std::string& csv_path) {
+        return csv_path + ".bars";
+    }
+
+    bool write_bar_cache(const std::string& cache_path, const BarColumns& columns, const BarCacheSource& source) {
+        const size_t n = columns.size();
+
+        // File-local symbol table in order of first appearance
+        std::unordered_map<SymbolId, uint32_t> local_ids;
+        std::vector<SymbolId> table;
+        std::vector<uint32_t> local_symbols(n);
+        for (size_t i = 0; i < n; ++i) {
+            const auto inserted = local_ids.emplace(columns.symbol_ids[i], static_cast<uint32_t>(table.size()));
+            if (inserted.second) {
+                table.push_back(columns.symbol_ids[i]);
+            }
+            local_symbols[i] = inserted.first->second;
+        }
+
+        BarCacheHeader header{};
+        header.magic = kBarCacheMagic;
+        header.version = kBarCacheVersion;
+        header.byte_order = kByteOrderTag;
+        header.row_count = n;
+        header.source_size = source.size;
+        header.source_checksum = source.checksum;
+        header.symbol_count = static_cast<uint32_t>(table.size());
+        header.symbols_offset = align_up(sizeof(header));
+
+        uint64_t offset = header.symbols_offset;
+        for (SymbolId id : table) {
+            offset += sizeof(uint32_t) + symbol_name(id).size();
+        }
+        for (size_t c = 0; c < kColumnCount; ++c) {
+            offset = align_up(offset);
+            header.column_offsets[c] = offset;
+            offset += kColumnWidths[c] * n;
+        }
+        header.file_size = offset;
+
+        const void* column_data[kColumnCount] = {
+            columns.timestamps.data(), local_symbols.data(), columns.open.data(), columns.high.data(),
+            columns.low.data(), columns.close.data(), columns.volume.data()};
+
+        const std::string tmp_path = temporary_path(cache_path);
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            uint64_t position = 0;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            position += sizeof(header);
+            pad_to(out, position, header.symbols_offset);
+
+            for (SymbolId id : table) {
+                const std::string& name = symbol_name(id);
+                const uint32_t length = static_cast<uint32_t>(name.size());
+                out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.write(name.data(), static_cast<std::streamsize>(name.size()));
+                position += sizeof(length) + name.size();
+            }
+
+            for (size_t c = 0; c < kColumnCount; ++c) {
+                pad_to(out, position, header.column_offsets[c]);
+                out.write(static_cast<const char*>(column_data[c]),
+                          static_cast<std::streamsize>(kColumnWidths[c] * n));
+                position += kColumnWidths[c] * n;
+            }
+
+            out.flush();
+            if (!out) {
+                out.close();
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool read_bar_cache(const std::string& cache_path, const BarCacheSource& source, BarStore& store,
+                        std::vector<std::string>* symbols) {
+        MappedFile file;
+        if (!file.open(cache_path) || file.size() < sizeof(BarCacheHeader)) {
+            return false;
+        }
+
+        BarCacheHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != kBarCacheMagic || header.version != kBarCacheVersion ||
+            header.byte_order != kByteOrderTag || header.file_size != file.size() ||
+            header.source_size != source.size || header.source_checksum != source.checksum) {
+            return false;
+        }
+
+        // Every section must be aligned and lie inside the file
+        const uint64_t n = header.row_count;
+        if (header.symbols_offset < sizeof(header) || header.symbols_offset > file.size()) {
+            return false;
+        }
+        for (size_t c = 0; c < kColumnCount; ++c) {
+            const uint64_t begin = header.column_offsets[c];
+            if (begin % kBarCacheAlignment != 0 || begin > file.size() ||
+                n > (file.size() - begin) / kColumnWidths[c]) {
+                return false;
+            }
+        }
+
+        // Symbol table -> global ids
+        std::vector<SymbolId> global_ids;
+        global_ids.reserve(header.symbol_count);
+        std::vector<std::string> names;
+        const char* p = file.data() + header.symbols_offset;
+        const char* table_end = file.data() + header.column_offsets[0];
+        for (uint32_t s = 0; s < header.symbol_count; ++s) {
+            uint32_t length;
+            if (table_end - p < static_cast<std::ptrdiff_t>(sizeof(length))) {
+                return false;
+            }
+            std::memcpy(&length, p, sizeof(length));
+            p += sizeof(length);
+            if (static_cast<uint64_t>(table_end - p) < length) {
+                return false;
+            }
+            names.emplace_back(p, length);
+            p += length;
+        }
+        bool identity = true;
+        for (uint32_t s = 0; s < header.symbol_count; ++s) {
+            global_ids.push_back(intern_symbol(names[s]));
+            identity = identity && global_ids.back() == s;
+        }
+
+        const char* base = file.data();
+        auto column = [&](size_t c) { return base + header.column_offsets[c]; };
+        const uint32_t* local_symbols = reinterpret_cast<const uint32_t*>(column(1));
+
+        std::vector<SymbolId> translated;
+        if (!identity) {
+            translated.resize(n);
+        }
+        for (uint64_t i = 0; i < n; ++i) {
+            const uint32_t local = local_symbols[i];
+            if (local >= header.symbol_count) {
+                return false;
+            }
+            if (!identity) {
+                translated[i] = global_ids[local];
+            }
+        }
+
+        const size_t rows = static_cast<size_t>(n);
+        BarColumns columns{
+            Span<const Timestamp>(reinterpret_cast<const Timestamp*>(column(0)), rows),
+            Span<const SymbolId>(local_symbols, rows),
+            Span<const double>(reinterpret_cast<const double*>(column(2)), rows),
+            Span<const double>(reinterpret_cast<const double*>(column(3)), rows),
+            Span<const double>(reinterpret_cast<const double*>(column(4)), rows),
+            Span<const double>(reinterpret_cast<const double*>(column(5)), rows),
+            Span<const double>(reinterpret_cast<const double*>(column(6)), rows)};
+
+        store.adopt_mapping(std::move(file), columns, std::move(translated));
+        if (symbols != nullptr) {
+            *symbols = std::move(names);
+        }
+        return true;
+    }
+
+} // namespace backtest
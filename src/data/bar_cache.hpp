@@ -0,0 +1,109 @@
+/**
+ * @file bar_cache.hpp
+ * @brief Versioned binary sidecar that lets parsed CSV files be reloaded by mmap()
+ *
+ * Parsing text dominates startup when the same historical files are read
+ * over and over. After a CSV has been parsed once, its BarStore can be
+ * written next to it as a binary sidecar (`<csv>.bars`); later loads map
+ * the sidecar and use its columns in place, without parsing or copying.
+ *
+ * Layout (native byte order, every section 64-byte aligned):
+ *
+ *   BarCacheHeader
+ *   symbol table   : symbol_count x { uint32 length, bytes }
+ *   timestamps     : row_count x int64 (nanoseconds since epoch)
+ *   symbols        : row_count x uint32 (index into the file's symbol table)
+ *   open, high, low, close, volume : row_count x double each
+ *
+ * The header records the size and a checksum of the source CSV, so a
+ * sidecar is only used while the source is byte-for-byte unchanged.
+ */
+
+#ifndef BAR_CACHE_HPP
+#define BAR_CACHE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bar_store.hpp"
+
+namespace backtest {
+
+    /// File signature of a bar cache (the bytes "BTBARCCH" read as a little-endian integer)
+    constexpr uint64_t kBarCacheMagic = 0x4843435241425442ULL;
+
+    /// Format version; bumped whenever the layout changes
+    constexpr uint32_t kBarCacheVersion = 1;
+
+    /// Alignment of every section of the file
+    constexpr size_t kBarCacheAlignment = 64;
+
+    /**
+     * @struct BarCacheHeader
+     * @brief Fixed-size header at offset 0 of a bar cache file
+     */
+    struct BarCacheHeader {
+        uint64_t magic;              ///< kBarCacheMagic
+        uint32_t version;            ///< kBarCacheVersion
+        uint32_t byte_order;         ///< 0x01020304 as written by the producing machine
+        uint64_t row_count;          ///< Bars stored in every column
+        uint64_t source_size;        ///< Size of the source CSV in bytes
+        uint64_t source_checksum;    ///< checksum_bytes() of the source CSV
+        uint64_t file_size;          ///< Total size of the cache file, for truncation checks
+        uint32_t symbol_count;       ///< Entries in the symbol table
+        uint32_t reserved;           ///< Zero
+        uint64_t symbols_offset;     ///< Offset of the symbol table
+        uint64_t column_offsets[7];  ///< timestamps, symbols, open, high, low, close, volume
+    };
+
+    /**
+     * @struct BarCacheSource
+     * @brief Identity of the source file a cache was built from
+     */
+    struct BarCacheSource {
+        uint64_t size = 0;      ///< Source size in bytes
+        uint64_t checksum = 0;  ///< checksum_bytes() of the source contents
+    };
+
+    /**
+     * @brief Fast 64-bit non-cryptographic checksum of a byte range
+     *
+     * Consumes eight bytes per step on four independent lanes, so hashing a
+     * file costs far less than parsing it; used to detect stale sidecars.
+     */
+    uint64_t checksum_bytes(const char* data, size_t size);
+
+    /**
+     * @brief Default sidecar path for a CSV file (`<csv_path>.bars`)
+     */
+    std::string bar_cache_path(const std::string& csv_path);
+
+    /**
+     * @brief Writes bar columns as a bar cache
+     * @param cache_path Destination; written to a temporary file and renamed into place
+     * @param columns Bars to write (e.g. the rows of one file within a BarStore)
+     * @param source Identity of the CSV the bars were parsed from
+     * @return true on success, false if the file could not be written
+     *
+     * Readers never observe a partially written cache: the rename only
+     * happens once every byte has been written.
+     */
+    bool write_bar_cache(const std::string& cache_path, const BarColumns& columns, const BarCacheSource& source);
+
+    /**
+     * @brief Maps a bar cache into a store without copying its price columns
+     * @param cache_path Cache file to open
+     * @param source Expected source identity; the cache is rejected if it differs
+     * @param store Receives the bars (previous contents are released)
+     * @param symbols If not null, receives the cache's symbol names in table order
+     * @return true if the cache was valid and loaded, false otherwise (store untouched)
+     *
+     * Symbol names are interned into the global table. When the resulting ids
+     * equal the file's table indices the symbol column is used in place too,
+     * otherwise it is translated into an owned column.
+     */
+    bool read_bar_cache(const std::string& cache_path, const BarCacheSource& source, BarStore& store,
+                        std::vector<std::string>* symbols = nullptr);
+
+} // namespace backtest
+#endif // BAR_CACHE_HPP
@@ -0,0 +1,81 @@
+/**
+ * @file bar_cursor.hpp
+ * @brief Independent read position over shared, immutable bar columns
+ *
+ * DataHandler keeps a single current index, so one handler cannot be iterated
+ * by several consumers at once. A BarCursor carries its own index over a
+ * read-only BarColumns view, so any number of threads can replay the same
+ * loaded data concurrently, each with its own cursor.
+ */
+
+#ifndef BAR_CURSOR_HPP
+#define BAR_CURSOR_HPP
+#include <cstddef>
+#include <stdexcept>
+#include "bar_store.hpp"
+
+namespace backtest {
+
+    /**
+     * @class BarCursor
+     * @brief Iterator-like access to a BarColumns view
+     *
+     * Offers the same has_next()/get_next_bar()/reset() interface as
+     * DataHandler, plus block-wise access for batch consumers. The cursor
+     * does not own the data; the underlying store must outlive it and must
+     * not be modified while it is in use.
+     */
+    class BarCursor {
+        private:
+            BarColumns columns_;  ///< Bars this cursor walks over
+            size_t index_;        ///< Next bar to return
+
+        public:
+            /**
+             * @brief Creates a cursor positioned at the first bar of columns
+             */
+            explicit BarCursor(const BarColumns& columns) : columns_(columns), index_(0) {}
+
+            /**
+             * @brief Checks if more bars are available
+             */
+            bool has_next() const { return index_ < columns_.size(); }
+
+            /**
+             * @brief Returns the next bar and advances the cursor
+             * @throws std::out_of_range if no more bars are available
+             */
+            Bar get_next_bar() {
+                if (!has_next()) {
+                    throw std::out_of_range("No more bars available");
+                }
+                return columns_.bar(index_++);
+            }
+
+            /**
+             * @brief Returns up to max_bars upcoming bars as columns and advances past them
+             * @return An empty view once the cursor is exhausted
+             */
+            BarColumns next_block(size_t max_bars) {
+                BarColumns block = columns_.slice(index_, max_bars);
+                index_ += block.size();
+                return block;
+            }
+
+            /**
+             * @brief Moves the cursor back to the first bar
+             */
+            void reset() { index_ = 0; }
+
+            /**
+             * @brief Moves the cursor to bar i (clamped to size())
+             */
+            void seek(size_t i) { index_ = i < columns_.size() ? i : columns_.size(); }
+
+            size_t position() const { return index_; }
+            size_t size() const { return columns_.size(); }
+            const BarColumns& columns() const { return columns_; }
+    };
+
+} // namespace backtest
+#endif // BAR_CURSOR_HPP
@@ -0,0 +1,63 @@
+/**
+ * @file bar_store.cpp
+ * @brief Implementation of the columnar bar container
+ */
+
+#include "bar_store.hpp"
+#include <utility>
+
+namespace backtest {
+
+    void BarStore::reserve(size_t n) {
+        timestamps_.reserve(n);
+        symbols_.reserve(n);
+        open_.reserve(n);
+        high_.reserve(n);
+        low_.reserve(n);
+        close_.reserve(n);
+        volume_.reserve(n);
+    }
+
+    void BarStore::adopt_mapping(MappedFile file, const BarColumns& columns,
+                                 std::vector<SymbolId> symbols) {
+        clear();
+        backing_ = std::move(file);
+        mapped_ = columns;
+        if (!symbols.empty()) {
+            // Vector moves keep the buffer, so the view stays valid after the move
+            mapped_symbols_ = std::move(symbols);
+            mapped_.symbol_ids = Span<const SymbolId>(mapped_symbols_.data(), mapped_symbols_.size());
+        }
+    }
+
+    void BarStore::make_owned() {
+        if (!is_mapped()) {
+            return;
+        }
+        const BarColumns view = mapped_;
+        symbols_.assign(view.symbol_ids.begin(), view.symbol_ids.end());
+        timestamps_.assign(view.timestamps.begin(), view.timestamps.end());
+        open_.assign(view.open.begin(), view.open.end());
+        high_.assign(view.high.begin(), view.high.end());
+        low_.assign(view.low.begin(), view.low.end());
+        close_.assign(view.close.begin(), view.close.end());
+        volume_.assign(view.volume.begin(), view.volume.end());
+        mapped_ = BarColumns{};
+        mapped_symbols_ = std::vector<SymbolId>();
+        backing_ = MappedFile();
+    }
+
+    void BarStore::clear() {
+        timestamps_.clear();
+        symbols_.clear();
+        open_.clear();
+        high_.clear();
+        low_.clear();
+        close_.clear();
+        volume_.clear();
+        mapped_ = BarColumns{};
+        mapped_symbols_ = std::vector<SymbolId>();
+        backing_ = MappedFile();
+    }
+
+} // namespace backtest
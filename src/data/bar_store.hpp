@@ -0,0 +1,180 @@
+/**
+ * @file bar_store.hpp
+ * @brief Columnar (struct-of-arrays) storage for OHLCV bars
+ *
+ * Each field of a bar lives in its own contiguous array, so code that only
+ * needs closing prices streams through one dense column instead of striding
+ * over whole Bar objects and their heap-allocated strings.
+ */
+
+#ifndef BAR_STORE_HPP
+#define BAR_STORE_HPP
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include "mapped_file.hpp"
+#include "market_data.hpp"
+#include "symbol_table.hpp"
+#include "timestamp.hpp"
+#include "../util/span.hpp"
+
+namespace backtest {
+
+    /**
+     * @struct BarColumns
+     * @brief Non-owning column views over a contiguous range of bars
+     *
+     * What batch consumers (vectorized strategies and indicators) receive
+     * instead of individual Bar objects. All spans have the same length.
+     */
+    struct BarColumns {
+        Span<const Timestamp> timestamps;  ///< Nanoseconds since epoch
+        Span<const SymbolId> symbol_ids;   ///< Interned symbol ids
+        Span<const double> open;           ///< Opening prices
+        Span<const double> high;           ///< High prices
+        Span<const double> low;            ///< Low prices
+        Span<const double> close;          ///< Closing prices
+        Span<const double> volume;         ///< Volumes
+
+        size_t size() const { return close.size(); }
+        bool empty() const { return close.empty(); }
+
+        /**
+         * @brief Assembles row i as a Bar
+         */
+        Bar bar(size_t i) const {
+            return Bar(timestamps[i], symbol_ids[i], open[i], high[i], low[i], close[i], volume[i]);
+        }
+
+        /**
+         * @brief Views rows [offset, offset + count) of these columns
+         */
+        BarColumns slice(size_t offset, size_t count = size_t(-1)) const {
+            return BarColumns{timestamps.subspan(offset, count), symbol_ids.subspan(offset, count),
+                              open.subspan(offset, count), high.subspan(offset, count),
+                              low.subspan(offset, count), close.subspan(offset, count),
+                              volume.subspan(offset, count)};
+        }
+    };
+
+    /**
+     * @class BarStore
+     * @brief Column-oriented container of bars
+     *
+     * Row i of the store is the bar formed by element i of every column.
+     * Columns are exposed as read-only spans for vectorized consumers, and
+     * bar(i) assembles a Bar for code written against the row-oriented API.
+     *
+     * A store either owns its columns or views columns that live in a mapped
+     * file (see adopt_mapping()), so a binary cache can be used in place
+     * without copying. Mapped stores are read-only until make_owned().
+     *
+     * Owned columns are allocated from the memory resource given at
+     * construction (the default resource unless a caller supplies an arena).
+     */
+    class BarStore {
+        private:
+            std::pmr::vector<Timestamp> timestamps_;  ///< Nanoseconds since epoch
+            std::pmr::vector<SymbolId> symbols_;      ///< Interned symbol ids
+            std::pmr::vector<double> open_;           ///< Opening prices
+            std::pmr::vector<double> high_;           ///< High prices
+            std::pmr::vector<double> low_;            ///< Low prices
+            std::pmr::vector<double> close_;          ///< Closing prices
+            std::pmr::vector<double> volume_;         ///< Volumes
+            MappedFile backing_;                      ///< File the columns are mapped from (closed if owned)
+            BarColumns mapped_;                       ///< Column views into backing_ while mapped
+            std::vector<SymbolId> mapped_symbols_;    ///< Translated symbol ids viewed by mapped_, if any
+
+        public:
+            /**
+             * @brief Creates an empty store
+             * @param resource Memory resource for the owned columns
+             */
+            explicit BarStore(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+                : timestamps_(resource), symbols_(resource), open_(resource), high_(resource),
+                  low_(resource), close_(resource), volume_(resource) {}
+
+            /**
+             * @brief Replaces the contents with columns that live in a mapped file
+             * @param file Mapping that keeps the column memory alive
+             * @param columns Views into file (symbol_ids may instead view `symbols`)
+             * @param symbols Owned symbol ids to use instead of a mapped column, or empty
+             */
+            void adopt_mapping(MappedFile file, const BarColumns& columns,
+                               std::vector<SymbolId> symbols = std::vector<SymbolId>());
+
+            /**
+             * @brief Checks whether the columns are views into a mapped file
+             */
+            bool is_mapped() const { return backing_.is_open(); }
+
+            /**
+             * @brief Copies mapped columns into owned storage so the store can grow
+             *
+             * No-op for stores that already own their columns.
+             */
+            void make_owned();
+
+            /**
+             * @brief Reserves capacity for n bars in every column
+             */
+            void reserve(size_t n);
+
+            /**
+             * @brief Appends one bar to the end of the store
+             * @pre !is_mapped()
+             */
+            void append(Timestamp ts, SymbolId symbol, double open, double high,
+                        double low, double close, double volume) {
+                timestamps_.push_back(ts);
+                symbols_.push_back(symbol);
+                open_.push_back(open);
+                high_.push_back(high);
+                low_.push_back(low);
+                close_.push_back(close);
+                volume_.push_back(volume);
+            }
+
+            /**
+             * @brief Removes all bars (capacity is kept) and releases any mapping
+             */
+            void clear();
+
+            size_t size() const { return is_mapped() ? mapped_.size() : close_.size(); }
+            bool empty() const { return size() == 0; }
+
+            /**
+             * @brief Assembles row i as a Bar
+             *
+             * Bar is a small trivially copyable record, so this is a handful of
+             * loads with no allocation.
+             */
+            Bar bar(size_t i) const {
+                if (is_mapped()) {
+                    return mapped_.bar(i);
+                }
+                return Bar(timestamps_[i], symbols_[i], open_[i], high_[i], low_[i], close_[i], volume_[i]);
+            }
+
+            // Column views
+            Span<const Timestamp> timestamps() const { return columns().timestamps; }
+            Span<const SymbolId> symbol_ids() const { return columns().symbol_ids; }
+            Span<const double> opens() const { return columns().open; }
+            Span<const double> highs() const { return columns().high; }
+            Span<const double> lows() const { return columns().low; }
+            Span<const double> closes() const { return columns().close; }
+            Span<const double> volumes() const { return columns().volume; }
+
+            /**
+             * @brief Views of all columns at once
+             */
+            BarColumns columns() const {
+                if (is_mapped()) {
+                    return mapped_;
+                }
+                return BarColumns{timestamps_, symbols_, open_, high_, low_, close_, volume_};
+            }
+    };
+
+} // namespace backtest
+#endif // BAR_STORE_HPP
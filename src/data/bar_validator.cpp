@@ -0,0 +1,233 @@
+/**
+ * @file bar_validator.cpp
+ * @brief Implementation of single-pass bar validation, repair and gap filling
+ */
+
+#include "bar_validator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace backtest {
+
+    BarValidator::BarValidator(const ValidationConfig& config, BarStore& store, SymbolId symbol)
+        : config_(config), store_(store), symbol_(symbol), probing_(config.interval <= 0),
+          fill_gaps_(config.fill_gaps) {
+        report_.interval = config_.interval > 0 ? config_.interval : 0;
+        if (probing_) {
+            probe_.reserve(kIntervalProbeRows);
+        } else {
+            resolve_calendar();
+        }
+    }
+
+    void BarValidator::push(Timestamp ts, double open, double high, double low, double close, double volume) {
+        ++report_.rows_in;
+        if (have_row_ && ts <= last_seen_) {
+            ++(ts == last_seen_ ? report_.duplicates : report_.out_of_order);
+            return;
+        }
+
+        // Negated comparisons so NaN fails them too
+        if (!(open > 0.0) || !(high > 0.0) || !(low > 0.0) || !(close > 0.0) || !(volume >= 0.0) ||
+            !std::isfinite(open + high + low + close + volume)) {
+            ++report_.invalid;
+            return;
+        }
+        if (high < std::max(open, close) || low > std::min(open, close) || high < low) {
+            if (!config_.repair_ohlc) {
+                ++report_.invalid;
+                return;
+            }
+            const double top = std::max(std::max(open, close), std::max(high, low));
+            const double bottom = std::min(std::min(open, close), std::min(high, low));
+            high = top;
+            low = bottom;
+            ++report_.ohlc_repaired;
+        }
+        if (volume == 0.0) {
+            ++report_.zero_volume;
+            if (config_.drop_zero_volume) {
+                return;
+            }
+        }
+
+        have_row_ = true;
+        last_seen_ = ts;
+        const Row row{ts, open, high, low, close, volume};
+        if (!probing_) {
+            emit(row);
+            return;
+        }
+        probe_.push_back(row);
+        if (probe_.size() == kIntervalProbeRows) {
+            infer_interval();
+        }
+    }
+
+    void BarValidator::finish() {
+        if (probing_) {
+            infer_interval();
+        }
+    }
+
+    /**
+     * @brief Takes the most common spacing of the held rows (the smaller on ties) and releases them
+     *
+     * The minimum would let one irregular early row halve the spacing and
+     * double the file with fills; gaps and stray rows only add rarer spacings.
+     */
+    void BarValidator::infer_interval() {
+        probing_ = false;
+        std::vector<Timestamp> spacings;
+        spacings.reserve(probe_.size());
+        for (size_t i = 1; i < probe_.size(); ++i) {
+            spacings.push_back(probe_[i].ts - probe_[i - 1].ts);
+        }
+        std::sort(spacings.begin(), spacings.end());
+        size_t best_run = 0;
+        for (size_t i = 0; i < spacings.size();) {
+            size_t j = i;
+            while (j < spacings.size() && spacings[j] == spacings[i]) {
+                ++j;
+            }
+            if (j - i > best_run) {
+                best_run = j - i;
+                report_.interval = spacings[i];
+            }
+            i = j;
+        }
+        resolve_calendar();
+        for (const Row& row : probe_) {
+            emit(row);
+        }
+        probe_.clear();
+        probe_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Replaces an Auto calendar by the one that fits the spacing
+     */
+    void BarValidator::resolve_calendar() {
+        report_.calendar = config_.calendar;
+        if (config_.calendar != TradingCalendar::Auto || report_.interval <= 0) {
+            return;
+        }
+        if (report_.interval < kNanosPerDay) {
+            report_.calendar = TradingCalendar::Sessions;
+        } else {
+            report_.calendar = TradingCalendar::Weekdays;
+            fill_gaps_ = false;
+        }
+    }
+
+    void BarValidator::emit(const Row& row) {
+        if (have_bar_ && report_.interval > 0 && row.ts - last_ts_ > report_.interval) {
+            fill_gap(row.ts);
+        }
+        store_.append(row.ts, symbol_, row.open, row.high, row.low, row.close, row.volume);
+        if (!have_bar_) {
+            report_.first = row.ts;
+        }
+        have_bar_ = true;
+        last_ts_ = row.ts;
+        last_close_ = row.close;
+        report_.last = row.ts;
+        ++report_.bars_out;
+    }
+
+    bool BarValidator::slot_expected(Timestamp slot) const {
+        // Sessions gaps never span days (see fill_gap()), so only weekdays filter slots
+        return report_.calendar != TradingCalendar::Weekdays || day_of_week(slot) <= 5;
+    }
+
+    /**
+     * @brief Counts the expected slots in (last_ts_, until) and forward-fills them if few enough
+     */
+    void BarValidator::fill_gap(Timestamp until) {
+        const Timestamp step = report_.interval;
+        if (report_.calendar == TradingCalendar::Sessions && days_since_epoch(last_ts_) != days_since_epoch(until)) {
+            return;  // Session break
+        }
+        // Count at most max_fill_bars + 1 expected slots, so huge gaps cost no more than a fill
+        size_t missing = 0;
+        for (Timestamp slot = last_ts_ + step; slot < until && missing <= config_.max_fill_bars; slot += step) {
+            missing += slot_expected(slot) ? 1 : 0;
+        }
+        if (missing == 0) {
+            return;
+        }
+        ++report_.gaps;
+        if (!fill_gaps_ || missing > config_.max_fill_bars) {
+            ++report_.gaps_unfilled;
+            return;
+        }
+        const double price = last_close_;
+        for (Timestamp slot = last_ts_ + step; slot < until; slot += step) {
+            if (slot_expected(slot)) {
+                store_.append(slot, symbol_, price, price, price, price, 0.0);
+                ++report_.bars_filled;
+                ++report_.bars_out;
+            }
+        }
+    }
+
+    void print_quality_report(std::ostream& os, const std::string& file, const DataQualityReport& report) {
+        os << file << ": " << report.rows_in << " rows -> " << report.bars_out << " bars";
+        if (report.interval > 0) {
+            os << " every " << report.interval / kNanosPerSecond << "s (" << trading_calendar_name(report.calendar)
+               << ")";
+        }
+        if (report.clean()) {
+            os << " | clean";
+        } else {
+            os << " | " << report.out_of_order << " out of order, " << report.duplicates << " duplicates, "
+               << report.invalid << " invalid, " << report.ohlc_repaired << " OHLC repaired | "
+               << report.gaps << " gaps (" << report.bars_filled << " bars filled, " << report.gaps_unfilled
+               << " unfilled)";
+        }
+        if (report.zero_volume > 0) {
+            os << " | " << report.zero_volume << " zero-volume";
+        }
+        os << std::endl;
+    }
+
+    void write_quality_csv(std::ostream& os, const std::string& file, const DataQualityReport& report,
+                           bool header) {
+        if (header) {
+            os << "file,rows_in,bars_out,interval_s,first,last,out_of_order,duplicates,invalid,ohlc_repaired,"
+                  "zero_volume,gaps,bars_filled,gaps_unfilled\n";
+        }
+        os << file << ',' << report.rows_in << ',' << report.bars_out << ',' << report.interval / kNanosPerSecond
+           << ',' << (report.bars_out > 0 ? format_timestamp(report.first) : std::string()) << ','
+           << (report.bars_out > 0 ? format_timestamp(report.last) : std::string()) << ','
+           << report.out_of_order << ',' << report.duplicates << ',' << report.invalid << ','
+           << report.ohlc_repaired << ',' << report.zero_volume << ',' << report.gaps << ','
+           << report.bars_filled << ',' << report.gaps_unfilled << '\n';
+    }
+
+    bool parse_trading_calendar(const std::string& name, TradingCalendar& calendar) {
+        if (name == "continuous") {
+            calendar = TradingCalendar::Continuous;
+        } else if (name == "weekdays") {
+            calendar = TradingCalendar::Weekdays;
+        } else if (name == "sessions") {
+            calendar = TradingCalendar::Sessions;
+        } else if (name == "auto") {
+            calendar = TradingCalendar::Auto;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    const char* trading_calendar_name(TradingCalendar calendar) {
+        switch (calendar) {
+            case TradingCalendar::Continuous: return "continuous";
+            case TradingCalendar::Weekdays: return "weekdays";
+            case TradingCalendar::Sessions: return "sessions";
+            case TradingCalendar::Auto: return "auto";
+        }
+        return "auto";
+    }
+
+} // namespace backtest
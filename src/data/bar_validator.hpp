@@ -0,0 +1,167 @@
+/**
+ * @file bar_validator.hpp
+ * @brief Validation and repair of parsed bars on their way into a BarStore
+ *
+ * DataHandler's loaders hand every parsed row to a BarValidator instead of
+ * appending it directly, so checking and cleaning happen in the same pass as
+ * parsing and no cleaned copy of the file has to be written:
+ *
+ * - order:  rows older than the previous row are dropped, rows with the same
+ *           timestamp collapse into the first one;
+ * - prices: rows with a non-finite or non-positive price or a negative or
+ *           non-finite volume are dropped; highs and lows that do not enclose
+ *           the open and close are widened to do so;
+ * - volume: zero-volume rows are counted (and optionally dropped);
+ * - gaps:   missing bars on the trading calendar are forward-filled with the
+ *           previous close and zero volume, up to max_fill_bars per gap.
+ *
+ * The bar spacing is either given or inferred as the most common spacing
+ * among the first rows, which are held back until it is known, so one
+ * irregular early row does not change it. Everything found is counted in a
+ * DataQualityReport.
+ */
+
+#ifndef BAR_VALIDATOR_HPP
+#define BAR_VALIDATOR_HPP
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "bar_store.hpp"
+#include "symbol_table.hpp"
+#include "timestamp.hpp"
+
+namespace backtest {
+
+    /**
+     * @enum TradingCalendar
+     * @brief Which bar slots between two rows are expected to exist
+     */
+    enum class TradingCalendar {
+        Continuous,  ///< Every slot (24/7 markets)
+        Weekdays,    ///< Slots on Monday to Friday (daily bars without a holiday list)
+        Sessions,    ///< Slots within the day of both neighbours; overnight and weekend gaps are session breaks
+        /**
+         * Chosen once the spacing is known: Sessions below one day, so
+         * overnight gaps are not filled; Weekdays from one day up, with gaps
+         * counted but not filled, as without a holiday list a missing weekday
+         * is more often a holiday than a lost bar
+         */
+        Auto
+    };
+
+    /**
+     * @struct ValidationConfig
+     * @brief What a BarValidator checks and repairs
+     */
+    struct ValidationConfig {
+        Timestamp interval = 0;                          ///< Bar spacing (0 = infer from the first rows)
+        TradingCalendar calendar = TradingCalendar::Auto;  ///< See TradingCalendar::Auto for the default
+        bool fill_gaps = true;                           ///< Forward-fill missing slots (otherwise only count them)
+        size_t max_fill_bars = 64;                       ///< Longer gaps are counted but not filled
+        bool repair_ohlc = true;                         ///< Widen high/low instead of dropping the row
+        bool drop_zero_volume = false;                   ///< Drop zero-volume rows instead of keeping them
+    };
+
+    /**
+     * @struct DataQualityReport
+     * @brief What validation found in one file
+     */
+    struct DataQualityReport {
+        size_t rows_in = 0;          ///< Parsed rows offered to the validator
+        size_t bars_out = 0;         ///< Bars stored, filled ones included
+        size_t out_of_order = 0;     ///< Dropped: older than the previous row
+        size_t duplicates = 0;       ///< Dropped: same timestamp as the previous row
+        size_t invalid = 0;          ///< Dropped: bad price or volume (or OHLC, without repair_ohlc)
+        size_t ohlc_repaired = 0;    ///< High or low widened to enclose open and close
+        size_t zero_volume = 0;      ///< Rows with zero volume
+        size_t gaps = 0;             ///< Runs of missing calendar slots
+        size_t bars_filled = 0;      ///< Forward-filled bars
+        size_t gaps_unfilled = 0;    ///< Gaps left open (longer than max_fill_bars, or filling disabled)
+        Timestamp interval = 0;      ///< Bar spacing used (0 if unknown)
+        TradingCalendar calendar = TradingCalendar::Auto;  ///< Calendar used (Auto until the spacing is known)
+        Timestamp first = 0;         ///< First stored timestamp
+        Timestamp last = 0;          ///< Last stored timestamp
+
+        /**
+         * @brief Whether the file needed no repair (zero volumes aside)
+         */
+        bool clean() const {
+            return out_of_order == 0 && duplicates == 0 && invalid == 0 && ohlc_repaired == 0 && gaps == 0;
+        }
+    };
+
+    /**
+     * @class BarValidator
+     * @brief Checks, repairs and gap-fills rows as they are parsed, appending to a BarStore
+     *
+     * Call push() for every parsed row in file order and finish() at the end;
+     * the store receives the cleaned bars. Holds at most kIntervalProbeRows
+     * rows back while the spacing is inferred.
+     */
+    class BarValidator {
+        public:
+            /// Rows the bar spacing is inferred from
+            static constexpr size_t kIntervalProbeRows = 32;
+
+            BarValidator(const ValidationConfig& config, BarStore& store, SymbolId symbol);
+
+            void push(Timestamp ts, double open, double high, double low, double close, double volume);
+
+            /**
+             * @brief Flushes held rows; call once after the last push()
+             */
+            void finish();
+
+            const DataQualityReport& report() const { return report_; }
+
+        private:
+            struct Row {
+                Timestamp ts;
+                double open, high, low, close, volume;
+            };
+
+            void emit(const Row& row);
+            void fill_gap(Timestamp until);
+            bool slot_expected(Timestamp slot) const;
+            void infer_interval();
+            void resolve_calendar();
+
+            ValidationConfig config_;
+            BarStore& store_;
+            SymbolId symbol_;
+            DataQualityReport report_;
+            std::vector<Row> probe_;     ///< Rows held back until the spacing is known
+            bool probing_;
+            bool fill_gaps_;             ///< config_.fill_gaps, unless Auto resolved to Weekdays
+            bool have_row_ = false;      ///< A row passed the order check
+            Timestamp last_seen_ = 0;    ///< Its timestamp
+            bool have_bar_ = false;      ///< A bar was stored
+            Timestamp last_ts_ = 0;      ///< Timestamp of the last stored bar
+            double last_close_ = 0.0;    ///< Close of the last stored bar
+    };
+
+    /**
+     * @brief Prints one line per file: counts, repairs and gaps
+     */
+    void print_quality_report(std::ostream& os, const std::string& file, const DataQualityReport& report);
+
+    /**
+     * @brief Writes the report as one CSV row, preceded by a header row if header is set
+     */
+    void write_quality_csv(std::ostream& os, const std::string& file, const DataQualityReport& report,
+                           bool header);
+
+    /**
+     * @brief Parses "continuous", "weekdays", "sessions" or "auto" into a TradingCalendar
+     * @return false if name is none of them
+     */
+    bool parse_trading_calendar(const std::string& name, TradingCalendar& calendar);
+
+    /**
+     * @brief Lower-case name of a calendar, as parse_trading_calendar() accepts it
+     */
+    const char* trading_calendar_name(TradingCalendar calendar);
+
+} // namespace backtest
+#endif // BAR_VALIDATOR_HPP
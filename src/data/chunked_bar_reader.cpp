@@ -0,0 +1,292 @@
+/**
+ * @file chunked_bar_reader.cpp
+ * @brief Implementation of the background, double-buffered CSV reader
+ */
+
+#include "chunked_bar_reader.hpp"
+#include "csv_parser.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace backtest {
+
+    namespace {
+        constexpr size_t kNoSlot = 2;
+        constexpr size_t kMaxReportedRows = 5;  // Individual malformed rows written to std::cerr
+    } // namespace
+
+    ChunkedBarReader::ChunkedBarReader(size_t chunk_rows, size_t block_bytes)
+        : chunk_rows_(chunk_rows == 0 ? 1 : chunk_rows),
+          block_bytes_(block_bytes == 0 ? 1 : block_bytes),
+          symbol_id_(kInvalidSymbol),
+          buffer_begin_(0),
+          buffer_end_(0),
+          eof_(false),
+          header_skipped_(false),
+          line_number_(0),
+          total_malformed_(0),
+          file_(nullptr),
+          stopping_(false),
+          current_(kNoSlot),
+          index_(0),
+          finished_(true) {}
+
+    ChunkedBarReader::~ChunkedBarReader() {
+        close();
+    }
+
+    bool ChunkedBarReader::open(const std::string& file_path, const std::string& symbol) {
+        close();
+        file_ = std::fopen(file_path.c_str(), "rb");
+        if (file_ == nullptr) {
+            return false;
+        }
+
+        path_ = file_path;
+        symbol_ = symbol;
+        symbol_id_ = intern_symbol(symbol);
+        buffer_.resize(block_bytes_);
+        buffer_begin_ = buffer_end_ = 0;
+        eof_ = false;
+        header_skipped_ = false;
+        line_number_ = 0;
+        total_malformed_ = 0;
+        for (Slot& slot : slots_) {
+            slot.full = false;
+            slot.last = false;
+        }
+        stopping_ = false;
+        error_ = nullptr;
+        current_ = kNoSlot;
+        view_ = BarColumns{};
+        index_ = 0;
+        finished_ = false;
+        stats_ = ChunkedReadStats{};
+
+        worker_ = std::thread(&ChunkedBarReader::run, this);
+        return true;
+    }
+
+    void ChunkedBarReader::close() {
+        if (worker_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            changed_.notify_all();
+            worker_.join();
+        }
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+        view_ = BarColumns{};
+        index_ = 0;
+        current_ = kNoSlot;
+        finished_ = true;
+    }
+
+    bool ChunkedBarReader::rewind() {
+        const std::string path = path_;
+        const std::string symbol = symbol_;
+        return !path.empty() && open(path, symbol);
+    }
+
+    /**
+     * @brief Reader thread: fills the two slots alternately until the file ends
+     */
+    void ChunkedBarReader::run() {
+        size_t next = 0;
+        for (;;) {
+            Slot& slot = slots_[next];
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait(lock, [&] { return stopping_ || !slot.full; });
+                if (stopping_) {
+                    return;
+                }
+            }
+
+            // The slot belongs to this thread until it is marked full
+            std::exception_ptr error;
+            try {
+                fill(slot);
+            } catch (...) {
+                error = std::current_exception();
+                slot.last = true;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slot.full = true;
+                if (error) {
+                    error_ = error;
+                }
+            }
+            changed_.notify_all();
+            if (slot.last) {
+                return;
+            }
+            next ^= 1;
+        }
+    }
+
+    /**
+     * @brief Parses rows into slot until it holds chunk_rows_ bars or the file ends
+     */
+    void ChunkedBarReader::fill(Slot& slot) {
+        slot.bars.clear();  // Keeps capacity, so only the first fill allocates
+        slot.bars.reserve(chunk_rows_);
+        slot.rows_malformed = 0;
+        slot.bytes = 0;
+        slot.last = false;
+
+        CsvBarRow row;
+        const char* begin;
+        const char* end;
+        while (slot.bars.size() < chunk_rows_) {
+            size_t consumed;
+            if (!next_line(begin, end, consumed)) {
+                slot.last = true;
+                break;
+            }
+            slot.bytes += consumed;
+            ++line_number_;
+
+            if (!header_skipped_) {
+                header_skipped_ = true;
+                continue;
+            }
+
+            // Blank lines (e.g. trailing newlines) are not data rows
+            if (end == begin || (end == begin + 1 && *begin == '\r')) {
+                continue;
+            }
+            Timestamp ts;
+            if (parse_bar_row(begin, end, row) && parse_timestamp(row.timestamp, ts)) {
+                slot.bars.append(ts, symbol_id_, row.open, row.high, row.low, row.close, row.volume);
+            } else {
+                if (total_malformed_ < kMaxReportedRows) {
+                    std::cerr << path_ << ":" << line_number_ << ": malformed row skipped" << std::endl;
+                }
+                ++total_malformed_;
+                ++slot.rows_malformed;
+            }
+        }
+
+        if (slot.last && total_malformed_ > 0) {
+            std::cerr << path_ << ": " << total_malformed_ << " malformed row(s) skipped" << std::endl;
+        }
+    }
+
+    /**
+     * @brief Yields the next line (without its '\n'), reading more of the file as needed
+     * @param consumed Receives the bytes taken from the file, including the newline
+     * @return false once the file is exhausted
+     */
+    bool ChunkedBarReader::next_line(const char*& begin, const char*& end, size_t& consumed) {
+        for (;;) {
+            const char* first = buffer_.data() + buffer_begin_;
+            const char* last = buffer_.data() + buffer_end_;
+            const char* newline = static_cast<const char*>(std::memchr(first, '\n', last - first));
+            if (newline != nullptr) {
+                begin = first;
+                end = newline;
+                buffer_begin_ = static_cast<size_t>(newline + 1 - buffer_.data());
+                consumed = static_cast<size_t>(newline + 1 - first);
+                return true;
+            }
+            if (eof_) {
+                if (first == last) {
+                    return false;
+                }
+                // Final line without a trailing newline
+                begin = first;
+                end = last;
+                buffer_begin_ = buffer_end_;
+                consumed = static_cast<size_t>(last - first);
+                return true;
+            }
+
+            // Move the partial line to the front and read the next block after it
+            const size_t carried = buffer_end_ - buffer_begin_;
+            std::memmove(buffer_.data(), first, carried);
+            buffer_begin_ = 0;
+            buffer_end_ = carried;
+            if (buffer_.size() - carried < block_bytes_ / 2 + 1) {
+                buffer_.resize(carried + block_bytes_);  // Only for lines longer than a block
+            }
+            const size_t got = std::fread(buffer_.data() + buffer_end_, 1, buffer_.size() - buffer_end_, file_);
+            buffer_end_ += got;
+            if (got == 0) {
+                if (std::ferror(file_)) {
+                    throw std::runtime_error("Error reading file: " + path_);
+                }
+                eof_ = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Hands the current chunk back to the reader and waits for the next one
+     * @return false if there is no further chunk
+     */
+    bool ChunkedBarReader::advance() {
+        if (finished_ || !worker_.joinable()) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        size_t next = 0;
+        if (current_ != kNoSlot) {
+            slots_[current_].full = false;
+            next = current_ ^ 1;
+            changed_.notify_all();
+        }
+        changed_.wait(lock, [&] { return slots_[next].full; });
+
+        current_ = next;
+        const Slot& slot = slots_[next];
+        finished_ = slot.last;
+        if (error_) {
+            finished_ = true;
+            view_ = BarColumns{};
+            std::rethrow_exception(error_);
+        }
+        view_ = slot.bars.columns();
+        index_ = 0;
+
+        stats_.rows_loaded += view_.size();
+        stats_.rows_malformed += slot.rows_malformed;
+        stats_.bytes_read += slot.bytes;
+        ++stats_.chunks;
+        return true;
+    }
+
+    bool ChunkedBarReader::has_next() {
+        while (index_ >= view_.size()) {
+            if (!advance()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Bar ChunkedBarReader::get_next_bar() {
+        if (!has_next()) {
+            throw std::out_of_range("No more bars available");
+        }
+        return view_.bar(index_++);
+    }
+
+    BarColumns ChunkedBarReader::next_block() {
+        if (!has_next()) {
+            return BarColumns{};
+        }
+        const BarColumns block = view_.slice(index_);
+        index_ = view_.size();
+        return block;
+    }
+
+} // namespace backtest
@@ -0,0 +1,166 @@
+/**
+ * @file chunked_bar_reader.hpp
+ * @brief Background CSV parsing into a bounded, double-buffered ring of chunks
+ *
+ * DataHandler::load_csv() materializes a whole file before the first bar is
+ * processed, so memory grows with the length of the history. ChunkedBarReader
+ * instead reads the file in fixed-size byte blocks on a background thread and
+ * parses them into fixed-size bar chunks. Two chunk slots alternate: while the
+ * consumer walks one, the reader fills the other, so parsing overlaps with
+ * strategy computation and memory stays bounded by the chunk size.
+ */
+
+#ifndef CHUNKED_BAR_READER_HPP
+#define CHUNKED_BAR_READER_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bar_store.hpp"
+
+namespace backtest {
+
+    /// Bars per chunk when none is given (about 3.3 MB of columns per slot)
+    constexpr size_t kDefaultChunkRows = 64 * 1024;
+
+    /**
+     * @struct ChunkedReadStats
+     * @brief Counters of the rows handed to the consumer so far
+     */
+    struct ChunkedReadStats {
+        size_t rows_loaded = 0;     ///< Bars parsed into delivered chunks
+        size_t rows_malformed = 0;  ///< Rows rejected (bad field count, number or timestamp)
+        size_t bytes_read = 0;      ///< Source bytes consumed by delivered chunks
+        size_t chunks = 0;          ///< Chunks delivered
+    };
+
+    /**
+     * @class ChunkedBarReader
+     * @brief Single-consumer, sequential bar source backed by a parsing thread
+     *
+     * Parses exactly like LoadMode::MemoryMapped: the header row is skipped,
+     * blank lines are ignored and malformed rows are skipped and reported on
+     * std::cerr. Peak memory is two chunks of bars plus one read block,
+     * independent of the file size.
+     *
+     * Views returned by next_block() stay valid until the next call to
+     * has_next(), get_next_bar() or next_block(), which may hand the chunk
+     * back to the reader thread.
+     */
+    class ChunkedBarReader {
+        public:
+            /**
+             * @brief Creates a closed reader
+             * @param chunk_rows Bars per chunk (at least 1)
+             * @param block_bytes Bytes per read() from the file; lines longer than this still work
+             */
+            explicit ChunkedBarReader(size_t chunk_rows = kDefaultChunkRows, size_t block_bytes = 1 << 20);
+
+            /**
+             * @brief Stops the reader thread
+             */
+            ~ChunkedBarReader();
+
+            ChunkedBarReader(const ChunkedBarReader&) = delete;
+            ChunkedBarReader& operator=(const ChunkedBarReader&) = delete;
+
+            /**
+             * @brief Opens a CSV file and starts parsing it in the background
+             * @return false if the file cannot be opened
+             */
+            bool open(const std::string& file_path, const std::string& symbol);
+
+            /**
+             * @brief Stops reading and releases both chunks
+             */
+            void close();
+
+            /**
+             * @brief Restarts from the first bar of the file
+             * @return false if the file can no longer be opened
+             */
+            bool rewind();
+
+            bool is_open() const { return worker_.joinable(); }
+
+            /**
+             * @brief Checks if more bars are available, waiting for the reader if needed
+             * @throws Any exception raised while reading (e.g. std::bad_alloc)
+             */
+            bool has_next();
+
+            /**
+             * @brief Returns the next bar
+             * @throws std::out_of_range if no more bars are available
+             */
+            Bar get_next_bar();
+
+            /**
+             * @brief Returns every remaining bar of the current chunk as columns
+             * @return An empty view once the file is exhausted
+             */
+            BarColumns next_block();
+
+            /**
+             * @brief Counters of the chunks delivered so far
+             */
+            const ChunkedReadStats& stats() const { return stats_; }
+
+            size_t chunk_rows() const { return chunk_rows_; }
+
+        private:
+            /**
+             * @struct Slot
+             * @brief One chunk of the double buffer
+             */
+            struct Slot {
+                BarStore bars;               ///< Parsed bars (capacity chunk_rows_)
+                size_t rows_malformed = 0;   ///< Rows rejected while filling this chunk
+                size_t bytes = 0;            ///< Source bytes consumed by this chunk
+                bool full = false;           ///< Owned by the consumer when true
+                bool last = false;           ///< No chunks follow this one
+            };
+
+            void run();
+            void fill(Slot& slot);
+            bool next_line(const char*& begin, const char*& end, size_t& consumed);
+            bool advance();
+
+            size_t chunk_rows_;
+            size_t block_bytes_;
+            std::string path_;
+            std::string symbol_;
+            SymbolId symbol_id_;
+
+            // Reader-thread state
+            std::vector<char> buffer_;   ///< Read block plus any carried partial line
+            size_t buffer_begin_;        ///< First unparsed byte in buffer_
+            size_t buffer_end_;          ///< One past the last valid byte in buffer_
+            bool eof_;                   ///< The file has been read completely
+            bool header_skipped_;
+            size_t line_number_;
+            size_t total_malformed_;     ///< Malformed rows seen in this pass over the file
+            std::FILE* file_;
+
+            // Shared state, guarded by mutex_
+            Slot slots_[2];
+            std::mutex mutex_;
+            std::condition_variable changed_;
+            bool stopping_;
+            std::exception_ptr error_;
+            std::thread worker_;
+
+            // Consumer state
+            size_t current_;             ///< Slot the consumer is reading, or 2 if none
+            BarColumns view_;            ///< Columns of the current slot
+            size_t index_;               ///< Next bar within view_
+            bool finished_;              ///< The last chunk has been consumed
+            ChunkedReadStats stats_;
+    };
+
+} // namespace backtest
+#endif // CHUNKED_BAR_READER_HPP
@@ -0,0 +1,259 @@
+/**
+ * @file compact_bar_store.hpp
+ * @brief Bar columns with reduced-precision prices and integer volumes
+ *
+ * BarStore keeps every price and the volume as a double, 52 bytes per bar.
+ * BasicCompactBarStore keeps prices in a PriceCodec layout (see
+ * price_codec.hpp) and volumes as int64:
+ *
+ *   layout    price column   bytes per bar
+ *   double    double         52
+ *   float32   float          36
+ *   ticks     int32          36
+ *
+ * A store is filled straight from a CSV by DataHandler::load_compact_csv(),
+ * so no double copy of the history is ever held, or from loaded columns with
+ * assign(). Consumers widen prices back to double a block at a time with
+ * decode() / decode_closes() (vectorized, see crossover_kernel.hpp) or a row
+ * at a time with bar(); all indicator, position and P&L arithmetic stays in
+ * double.
+ *
+ * CompactBarStore is the layout chosen at configure time with the CMake
+ * option BACKTEST_PRICE_STORAGE (double, float or ticks); SweepEngine and
+ * BacktestEngine run over it directly. engine/precision_check.hpp reports
+ * the P&L divergence of a layout from the double path.
+ */
+
+#ifndef COMPACT_BAR_STORE_HPP
+#define COMPACT_BAR_STORE_HPP
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+#include "bar_store.hpp"
+#include "market_data.hpp"
+#include "price_codec.hpp"
+
+namespace backtest {
+
+    /**
+     * @struct DecodedBars
+     * @brief Reusable double columns a compact block is widened into
+     */
+    struct DecodedBars {
+        explicit DecodedBars(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : open(resource), high(resource), low(resource), close(resource), volume(resource) {}
+
+        std::pmr::vector<double> open;
+        std::pmr::vector<double> high;
+        std::pmr::vector<double> low;
+        std::pmr::vector<double> close;
+        std::pmr::vector<double> volume;
+    };
+
+    /**
+     * @class BasicCompactBarStore
+     * @brief Columnar bars with Codec-encoded prices
+     *
+     * Append-only, like an owned BarStore. Tick sizes are kept per SymbolId in
+     * a dense table, like PositionBook's slots, and must be set before the
+     * symbol's bars are added.
+     */
+    template <typename Codec>
+    class BasicCompactBarStore {
+        public:
+            using Stored = typename Codec::Stored;
+
+            /**
+             * @brief Bytes of one stored bar (without the per-symbol tick table)
+             */
+            static constexpr size_t bytes_per_bar() {
+                return sizeof(Timestamp) + sizeof(SymbolId) + 4 * sizeof(Stored) + sizeof(int64_t);
+            }
+
+            static const char* precision_name() { return Codec::name; }
+
+            /**
+             * @brief Sets the price increment of symbol (used by TickPriceCodec only)
+             */
+            void set_tick_size(SymbolId symbol, double tick) {
+                if (symbol >= scales_.size()) {
+                    scales_.resize(static_cast<size_t>(symbol) + 1, scale_of(kDefaultTickSize));
+                }
+                scales_[symbol] = scale_of(tick > 0.0 ? tick : kDefaultTickSize);
+            }
+
+            double tick_size(SymbolId symbol) const { return 1.0 / scale(symbol); }
+
+            /**
+             * @brief Reserves capacity for n bars in every column
+             */
+            void reserve(size_t n) {
+                timestamps_.reserve(n);
+                symbols_.reserve(n);
+                open_.reserve(n);
+                high_.reserve(n);
+                low_.reserve(n);
+                close_.reserve(n);
+                volume_.reserve(n);
+            }
+
+            /**
+             * @brief Encodes and appends one bar
+             * @return false, appending nothing, if a price cannot be encoded (out of
+             *         range, or off the symbol's tick grid in tick storage)
+             */
+            bool append(Timestamp ts, SymbolId symbol, double open, double high, double low, double close,
+                        double volume) {
+                const double ticks = scale(symbol);
+                Stored o, h, l, c;
+                if (!Codec::encode(open, ticks, o) || !Codec::encode(high, ticks, h) ||
+                    !Codec::encode(low, ticks, l) || !Codec::encode(close, ticks, c)) {
+                    return false;
+                }
+                timestamps_.push_back(ts);
+                symbols_.push_back(symbol);
+                open_.push_back(o);
+                high_.push_back(h);
+                low_.push_back(l);
+                close_.push_back(c);
+                volume_.push_back(std::llround(volume));
+                return true;
+            }
+
+            /**
+             * @brief Replaces the contents with an encoded copy of bars
+             * @return false (leaving the store empty) if a price cannot be encoded; reported on std::cerr
+             */
+            bool assign(const BarColumns& bars) {
+                clear();
+                reserve(bars.size());
+                for (size_t i = 0; i < bars.size(); ++i) {
+                    if (!append(bars.timestamps[i], bars.symbol_ids[i], bars.open[i], bars.high[i], bars.low[i],
+                                bars.close[i], bars.volume[i])) {
+                        std::cerr << "Error: Bar " << i << " has a price that " << Codec::name
+                                  << " storage cannot represent exactly (out of range or off the tick grid of "
+                                  << tick_size(bars.symbol_ids[i]) << "; see set_tick_size())" << std::endl;
+                        clear();
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void clear() {
+                timestamps_.clear();
+                symbols_.clear();
+                open_.clear();
+                high_.clear();
+                low_.clear();
+                close_.clear();
+                volume_.clear();
+            }
+
+            size_t size() const { return close_.size(); }
+            bool empty() const { return close_.empty(); }
+
+            /**
+             * @brief Bytes held by the columns
+             */
+            size_t bytes() const { return size() * bytes_per_bar() + scales_.size() * sizeof(double); }
+
+            Span<const Timestamp> timestamps() const { return timestamps_; }
+            Span<const SymbolId> symbol_ids() const { return symbols_; }
+
+            /**
+             * @brief Decodes row i into a Bar of doubles
+             */
+            Bar bar(size_t i) const {
+                const double ticks = scale(symbols_[i]);
+                return Bar(timestamps_[i], symbols_[i], Codec::decode(open_[i], ticks),
+                           Codec::decode(high_[i], ticks), Codec::decode(low_[i], ticks),
+                           Codec::decode(close_[i], ticks), static_cast<double>(volume_[i]));
+            }
+
+            double close(size_t i) const { return Codec::decode(close_[i], scale(symbols_[i])); }
+
+            /**
+             * @brief Decodes closes [offset, offset + count) into out
+             */
+            void decode_closes(size_t offset, size_t count, double* out) const {
+                decode_column(close_, offset, count, out);
+            }
+
+            /**
+             * @brief Widens rows [offset, offset + count) into out and views them as BarColumns
+             *
+             * Timestamps and symbol ids are viewed in place; the price and volume
+             * views stay valid until out is reused.
+             */
+            BarColumns decode(size_t offset, size_t count, DecodedBars& out) const {
+                out.open.resize(count);
+                out.high.resize(count);
+                out.low.resize(count);
+                out.close.resize(count);
+                out.volume.resize(count);
+                decode_column(open_, offset, count, out.open.data());
+                decode_column(high_, offset, count, out.high.data());
+                decode_column(low_, offset, count, out.low.data());
+                decode_column(close_, offset, count, out.close.data());
+                for (size_t i = 0; i < count; ++i) {
+                    out.volume[i] = static_cast<double>(volume_[offset + i]);
+                }
+                return BarColumns{timestamps().subspan(offset, count), symbol_ids().subspan(offset, count),
+                                  out.open, out.high, out.low, out.close, out.volume};
+            }
+
+        private:
+            /**
+             * @brief Ticks per price unit, snapped to an integer for decimal tick sizes
+             */
+            static double scale_of(double tick) {
+                const double scale = 1.0 / tick;
+                const double whole = std::round(scale);
+                return std::fabs(scale - whole) < 1e-9 * whole ? whole : scale;
+            }
+
+            double scale(SymbolId symbol) const {
+                return symbol < scales_.size() ? scales_[symbol] : kDefaultScale;
+            }
+
+            /**
+             * @brief Decodes a range of one price column, one run of equal symbols at a time
+             */
+            void decode_column(const std::vector<Stored>& column, size_t offset, size_t count, double* out) const {
+                if (!Codec::kScaled) {
+                    Codec::decode_block(column.data() + offset, count, 0.0, out);
+                    return;
+                }
+                size_t i = 0;
+                while (i < count) {
+                    const SymbolId symbol = symbols_[offset + i];
+                    size_t j = i + 1;
+                    while (j < count && symbols_[offset + j] == symbol) {
+                        ++j;
+                    }
+                    Codec::decode_block(column.data() + offset + i, j - i, scale(symbol), out + i);
+                    i = j;
+                }
+            }
+
+            static constexpr double kDefaultScale = 100.0;  ///< 1 / kDefaultTickSize
+
+            std::vector<Timestamp> timestamps_;
+            std::vector<SymbolId> symbols_;
+            std::vector<Stored> open_;
+            std::vector<Stored> high_;
+            std::vector<Stored> low_;
+            std::vector<Stored> close_;
+            std::vector<int64_t> volume_;      ///< Rounded to whole units
+            std::vector<double> scales_;       ///< Ticks per price unit by SymbolId, grown by set_tick_size()
+    };
+
+    /// Compact store in the layout selected by BACKTEST_PRICE_STORAGE
+    using CompactBarStore = BasicCompactBarStore<PriceCodec>;
+
+} // namespace backtest
+#endif // COMPACT_BAR_STORE_HPP
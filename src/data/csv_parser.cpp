@@ -0,0 +1,210 @@
+/**
+ * @file csv_parser.cpp
+ * @brief Implementation of the allocation-free OHLCV row parser
+ */
+
+#include "csv_parser.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+namespace backtest {
+
+    namespace {
+
+        /// Powers of ten that are exactly representable as doubles (10^0 .. 10^22)
+        constexpr double kExactPowersOfTen[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        /// Largest integer below which every value is exactly representable as a double
+        constexpr uint64_t kMaxExactMantissa = uint64_t(1) << 53;
+
+        inline bool is_digit(char c) {
+            return static_cast<unsigned>(c - '0') < 10u;
+        }
+
+        inline bool is_blank(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        /**
+         * @brief Full-precision fallback for numbers outside the fast path
+         */
+        bool parse_double_slow(const char* first, const char* last, double& out) {
+            // from_chars does not accept a leading '+'
+            if (first != last && *first == '+') {
+                ++first;
+            }
+            auto result = std::from_chars(first, last, out);
+            return result.ec == std::errc() && result.ptr == last;
+        }
+
+    } // namespace
+
+    /**
+     * @brief Parses a whole field as a double
+     *
+     * Fast path (Clinger): when the decimal significand fits in 53 bits and the
+     * decimal exponent is within [-22, 22], both the significand and the power
+     * of ten are exact doubles, so one IEEE multiply or divide yields the
+     * correctly rounded result. Typical price/volume fields always take it.
+     */
+    bool parse_double(const char* first, const char* last, double& out) {
+        while (first != last && is_blank(*first)) ++first;
+        while (last != first && is_blank(*(last - 1))) --last;
+        if (first == last) {
+            return false;
+        }
+
+        const char* p = first;
+        bool negative = false;
+        if (*p == '-' || *p == '+') {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        int significant_digits = 0;
+        int exponent = 0;
+        bool any_digits = false;
+
+        // Integer part
+        for (; p != last && is_digit(*p); ++p) {
+            any_digits = true;
+            if (mantissa == 0 && *p == '0') continue;  // Leading zeros are not significant
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            } else {
+                ++exponent;  // Digits beyond 19 are only tracked as magnitude
+            }
+            ++significant_digits;
+        }
+
+        // Fractional part
+        if (p != last && *p == '.') {
+            ++p;
+            for (; p != last && is_digit(*p); ++p) {
+                any_digits = true;
+                if (mantissa == 0 && *p == '0') {
+                    --exponent;
+                    continue;
+                }
+                if (significant_digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                    --exponent;
+                }
+                ++significant_digits;
+            }
+        }
+
+        if (!any_digits) {
+            return false;
+        }
+
+        // Optional exponent
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool exp_negative = false;
+            if (p != last && (*p == '-' || *p == '+')) {
+                exp_negative = (*p == '-');
+                ++p;
+            }
+            if (p == last || !is_digit(*p)) {
+                return false;
+            }
+            int exp_value = 0;
+            for (; p != last && is_digit(*p); ++p) {
+                if (exp_value < 100000) {
+                    exp_value = exp_value * 10 + (*p - '0');
+                }
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+
+        if (p != last) {
+            return false;  // Trailing garbage inside the field
+        }
+
+        if (significant_digits > 19 || mantissa > kMaxExactMantissa ||
+            exponent < -22 || exponent > 22) {
+            return parse_double_slow(first, last, out);
+        }
+
+        double value = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            value /= kExactPowersOfTen[-exponent];
+        } else {
+            value *= kExactPowersOfTen[exponent];
+        }
+        out = negative ? -value : value;
+        return true;
+    }
+
+    /**
+     * @brief Splits a row on commas and parses the five numeric fields
+     */
+    bool parse_bar_row(const char* first, const char* last, CsvBarRow& row) {
+        if (last != first && *(last - 1) == '\r') {
+            --last;
+        }
+
+        const char* field_end = static_cast<const char*>(
+            std::memchr(first, ',', static_cast<size_t>(last - first)));
+        if (field_end == nullptr) {
+            return false;
+        }
+        row.timestamp = std::string_view(first, static_cast<size_t>(field_end - first));
+
+        double* numeric_fields[] = {&row.open, &row.high, &row.low, &row.close, &row.volume};
+        const char* p = field_end + 1;
+        for (size_t i = 0; i < 5; ++i) {
+            const bool is_last_field = (i == 4);
+            field_end = static_cast<const char*>(
+                std::memchr(p, ',', static_cast<size_t>(last - p)));
+            if (is_last_field) {
+                if (field_end != nullptr) {
+                    return false;  // More than six fields
+                }
+                field_end = last;
+            } else if (field_end == nullptr) {
+                return false;  // Fewer than six fields
+            }
+            if (!parse_double(p, field_end, *numeric_fields[i])) {
+                return false;
+            }
+            p = field_end + 1;
+        }
+        return true;
+    }
+
+    const char* find_line_end(const char* first, const char* last) {
+        const void* nl = std::memchr(first, '\n', static_cast<size_t>(last - first));
+        return nl != nullptr ? static_cast<const char*>(nl) : last;
+    }
+
+    /**
+     * @brief Extrapolates a line count from the average length of a sample
+     */
+    size_t estimate_line_count(const char* first, const char* last) {
+        constexpr size_t kSampleLines = 64;
+        const size_t total_bytes = static_cast<size_t>(last - first);
+
+        const char* p = first;
+        size_t sampled_lines = 0;
+        while (p != last && sampled_lines < kSampleLines) {
+            const char* line_end = find_line_end(p, last);
+            p = (line_end == last) ? last : line_end + 1;
+            ++sampled_lines;
+        }
+        if (p == last) {
+            return sampled_lines;  // The whole range was sampled
+        }
+
+        const size_t sampled_bytes = static_cast<size_t>(p - first);
+        const size_t estimate = total_bytes / (sampled_bytes / sampled_lines);
+        return estimate + estimate / 16 + 1;  // Headroom for shorter rows later in the file
+    }
+
+} // namespace backtest
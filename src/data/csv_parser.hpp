@@ -0,0 +1,77 @@
+/**
+ * @file csv_parser.hpp
+ * @brief Allocation-free parsing of OHLCV CSV rows
+ *
+ * Low-level helpers used by the fast loading path of DataHandler. They work on
+ * raw character ranges (typically a memory-mapped file) and never build
+ * intermediate streams or strings, and number parsing does not depend on the
+ * global C/C++ locale.
+ */
+
+#ifndef CSV_PARSER_HPP
+#define CSV_PARSER_HPP
+#include <cstddef>
+#include <string_view>
+
+namespace backtest {
+
+    /**
+     * @struct CsvBarRow
+     * @brief Fields of one parsed "timestamp,open,high,low,close,volume" row
+     *
+     * The timestamp is a view into the source buffer and is only valid while
+     * that buffer is alive.
+     */
+    struct CsvBarRow {
+        std::string_view timestamp;  ///< Raw timestamp field (not parsed)
+        double open;                 ///< Opening price
+        double high;                 ///< High price
+        double low;                  ///< Low price
+        double close;                ///< Closing price
+        double volume;               ///< Trading volume
+    };
+
+    /**
+     * @brief Parses a decimal floating point number occupying a whole field
+     * @param first Start of the field
+     * @param last One past the end of the field
+     * @param out Receives the parsed value on success
+     * @return true if the whole field is a valid number, false otherwise
+     *
+     * Accepts an optional sign, digits with an optional '.', and an optional
+     * exponent. Surrounding spaces/tabs are ignored. Plain decimals with up to
+     * 19 significant digits are converted exactly with a single correctly
+     * rounded multiply/divide; everything else falls back to std::from_chars,
+     * so results are identical to strtod() in the "C" locale.
+     */
+    bool parse_double(const char* first, const char* last, double& out);
+
+    /**
+     * @brief Splits and parses one CSV data row
+     * @param first Start of the row
+     * @param last End of the row (excluding the newline; a trailing '\r' is allowed)
+     * @param row Receives the parsed fields on success
+     * @return true if the row has exactly six fields and all numeric fields parse
+     */
+    bool parse_bar_row(const char* first, const char* last, CsvBarRow& row);
+
+    /**
+     * @brief Finds the end of the line starting at first
+     * @return Pointer to the '\n' terminating the line, or last if there is none
+     */
+    const char* find_line_end(const char* first, const char* last);
+
+    /**
+     * @brief Estimates the number of lines in a range without scanning all of it
+     * @param first Start of the data
+     * @param last End of the data
+     * @return Estimated line count, rounded up slightly so a reserve() based on
+     *         it rarely needs to grow
+     *
+     * Measures the average length of the first few lines and extrapolates from
+     * the total size, so sizing the bar storage costs no extra pass over the file.
+     */
+    size_t estimate_line_count(const char* first, const char* last);
+
+} // namespace backtest
+#endif // CSV_PARSER_HPP
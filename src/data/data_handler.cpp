@@ -4,7 +4,12 @@
  */
 
 #include "data_handler.hpp"
+#include "bar_cache.hpp"
+#include "csv_parser.hpp"
+#include "mapped_file.hpp"
+#include "../util/profiler.hpp"
 #include <fstream>
+#include <optional>
 #include <sstream>
 #include <iostream>
 
@@ -13,33 +18,65 @@ namespace backtest {
     /**
      * @brief Initializes an empty DataHandler with index at position 0
      */
-    DataHandler::DataHandler() : current_index(0) {}
+    DataHandler::DataHandler(std::pmr::memory_resource* resource) : store_(resource), current_index(0) {}
 
     /**
      * @brief Loads historical market data from CSV file
      * @param file_path Path to CSV file with OHLCV data
      * @param symbol Ticker symbol to assign to all bars
+     * @param mode Parsing implementation to use
+     * @param cache Binary sidecar policy
      * @return true if successful, false if file cannot be opened
      * 
      * CSV Format: timestamp,open,high,low,close,volume
      * - First row (header) is automatically skipped
      * - Comma-separated values
-     * - Timestamp should be a string (e.g., "2024-01-15")
+     * - Timestamp must be ISO 8601 (e.g., "2024-01-15" or "2024-01-15T09:30:00")
      * - All prices and volume are parsed as doubles
      */
-    bool DataHandler::load_csv(const std::string& file_path, const std::string& symbol) {
+    bool DataHandler::load_csv(const std::string& file_path, const std::string& symbol, LoadMode mode,
+                               CachePolicy cache) {
+        BT_PROFILE_SCOPE(Load);
+        last_load_stats_ = LoadStats{};
+        last_quality_ = DataQualityReport{};
+        stream_.reset();
+        if (cache == CachePolicy::ReadWrite) {
+            return load_csv_cached(file_path, symbol, mode);
+        }
+        // Bars from an earlier cached load are views; copy them so this load can append
+        store_.make_owned();
+        if (mode == LoadMode::MemoryMapped) {
+            return load_csv_mapped(file_path, symbol);
+        }
+        return load_csv_stream(file_path, symbol);
+    }
+
+    /**
+     * @brief Original loader: one std::istringstream per line
+     */
+    bool DataHandler::load_csv_stream(const std::string& file_path, const std::string& symbol) {
+        BT_PROFILE_SCOPE(Parse);
         std::ifstream file(file_path);
         if (!file.is_open()) {
             std::cerr << "Error opening file: " << file_path << std::endl;
             return false;
         }
 
+        const SymbolId symbol_id = intern_symbol(symbol);
+        std::optional<BarValidator> validator;
+        if (validate_) {
+            validator.emplace(validation_, store_, symbol_id);
+        }
         std::string line;
+        size_t line_number = 1;
         // Skip header row
         std::getline(file, line);
+        last_load_stats_.bytes_read += line.size() + 1;
 
         // Parse each data row
         while (std::getline(file, line)) {
+            last_load_stats_.bytes_read += line.size() + 1;
+            ++line_number;
             std::istringstream ss(line);
             std::string timestamp;
             double open, high, low, close, volume;
@@ -52,20 +89,272 @@ namespace backtest {
             ss >> close; ss.ignore();           // Read close, skip comma
             ss >> volume;                       // Read volume (last field)
 
-            // Create Bar and add to collection (now includes symbol)
-            bars_.emplace_back(timestamp, symbol, open, high, low, close, volume);
+            Timestamp ts;
+            if (!parse_timestamp(timestamp, ts)) {
+                report_malformed_row(file_path, line_number);
+                continue;
+            }
+
+            // Append the bar to the columnar store
+            if (validator) {
+                validator->push(ts, open, high, low, close, volume);
+            } else {
+                store_.append(ts, symbol_id, open, high, low, close, volume);
+            }
+            ++last_load_stats_.rows_loaded;
+            BT_PROFILE_COUNT(RowsParsed, 1);
         }
 
+        if (validator) {
+            finish_validation(*validator);
+        }
+        report_malformed_summary(file_path);
         file.close();
         return true;
     }
 
+    /**
+     * @brief Fast loader: parses the memory-mapped file in place
+     *
+     * Rows are located with memchr() and split into fields without creating
+     * any per-line stream or string. The store is reserved up front from a
+     * row-count estimate, so the columns do not reallocate while the file is read.
+     */
+    bool DataHandler::load_csv_mapped(const std::string& file_path, const std::string& symbol) {
+        BT_PROFILE_SCOPE(Parse);
+        MappedFile file;
+        if (!file.open(file_path)) {
+            std::cerr << "Error opening file: " << file_path << std::endl;
+            return false;
+        }
+        last_load_stats_.bytes_read = file.size();
+
+        const char* p = file.data();
+        const char* end = file.end();
+
+        // Skip header row
+        if (p != end) {
+            const char* header_end = find_line_end(p, end);
+            p = (header_end == end) ? end : header_end + 1;
+        }
+
+        store_.reserve(store_.size() + estimate_line_count(p, end));
+        const SymbolId symbol_id = intern_symbol(symbol);
+        std::optional<BarValidator> validator;
+        if (validate_) {
+            validator.emplace(validation_, store_, symbol_id);
+        }
+
+        size_t line_number = 1;  // Header was line 1
+        CsvBarRow row;
+        while (p != end) {
+            const char* line_end = find_line_end(p, end);
+            ++line_number;
+
+            // Blank lines (e.g. trailing newlines) are not data rows
+            const bool blank = (line_end == p) || (line_end == p + 1 && *p == '\r');
+            if (!blank) {
+                Timestamp ts;
+                if (parse_bar_row(p, line_end, row) && parse_timestamp(row.timestamp, ts)) {
+                    if (validator) {
+                        validator->push(ts, row.open, row.high, row.low, row.close, row.volume);
+                    } else {
+                        store_.append(ts, symbol_id, row.open, row.high, row.low, row.close, row.volume);
+                    }
+                    ++last_load_stats_.rows_loaded;
+                    BT_PROFILE_COUNT(RowsParsed, 1);
+                } else {
+                    report_malformed_row(file_path, line_number);
+                }
+            }
+
+            p = (line_end == end) ? end : line_end + 1;
+        }
+
+        if (validator) {
+            finish_validation(*validator);
+        }
+        report_malformed_summary(file_path);
+        return true;
+    }
+
+    template <typename Codec>
+    bool DataHandler::load_compact_csv(const std::string& file_path, const std::string& symbol,
+                                       BasicCompactBarStore<Codec>& out) {
+        BT_PROFILE_SCOPE(Load);
+        last_load_stats_ = LoadStats{};
+        MappedFile file;
+        if (!file.open(file_path)) {
+            std::cerr << "Error opening file: " << file_path << std::endl;
+            return false;
+        }
+        last_load_stats_.bytes_read = file.size();
+
+        const char* p = file.data();
+        const char* end = file.end();
+        if (p != end) {
+            const char* header_end = find_line_end(p, end);
+            p = (header_end == end) ? end : header_end + 1;
+        }
+
+        out.reserve(out.size() + estimate_line_count(p, end));
+        const SymbolId symbol_id = intern_symbol(symbol);
+        size_t line_number = 1;
+        CsvBarRow row;
+        while (p != end) {
+            const char* line_end = find_line_end(p, end);
+            ++line_number;
+            const bool blank = (line_end == p) || (line_end == p + 1 && *p == '\r');
+            if (!blank) {
+                Timestamp ts;
+                if (parse_bar_row(p, line_end, row) && parse_timestamp(row.timestamp, ts)) {
+                    if (!out.append(ts, symbol_id, row.open, row.high, row.low, row.close, row.volume)) {
+                        std::cerr << file_path << ":" << line_number << ": price not representable in "
+                                  << Codec::name << " storage (out of range or off the tick grid of "
+                                  << out.tick_size(symbol_id) << ")" << std::endl;
+                        return false;
+                    }
+                    ++last_load_stats_.rows_loaded;
+                    BT_PROFILE_COUNT(RowsParsed, 1);
+                } else {
+                    report_malformed_row(file_path, line_number);
+                }
+            }
+            p = (line_end == end) ? end : line_end + 1;
+        }
+        report_malformed_summary(file_path);
+        return true;
+    }
+
+    template bool DataHandler::load_compact_csv(const std::string&, const std::string&,
+                                                BasicCompactBarStore<DoublePriceCodec>&);
+    template bool DataHandler::load_compact_csv(const std::string&, const std::string&,
+                                                BasicCompactBarStore<Float32PriceCodec>&);
+    template bool DataHandler::load_compact_csv(const std::string&, const std::string&,
+                                                BasicCompactBarStore<TickPriceCodec>&);
+
+    /**
+     * @brief Flushes a loader's validator and keeps its report
+     *
+     * rows_loaded then counts the bars actually stored rather than the rows parsed.
+     */
+    void DataHandler::finish_validation(BarValidator& validator) {
+        validator.finish();
+        last_quality_ = validator.report();
+        last_load_stats_.rows_loaded = last_quality_.bars_out;
+    }
+
+    /**
+     * @brief Sidecar-aware loader: maps `<file_path>.bars` or parses and writes it
+     *
+     * A cache hit on an empty handler adopts the mapping, so the columns are
+     * used in place. Appending to existing bars copies the cached columns, which
+     * is still far cheaper than parsing.
+     */
+    bool DataHandler::load_csv_cached(const std::string& file_path, const std::string& symbol, LoadMode mode) {
+        BarCacheSource source;
+        {
+            MappedFile file;
+            if (!file.open(file_path)) {
+                std::cerr << "Error opening file: " << file_path << std::endl;
+                return false;
+            }
+            source.size = file.size();
+            source.checksum = checksum_bytes(file.data(), file.size());
+        }
+        if (validate_) {
+            // Validated bars differ from the raw rows, so they get their own cache identity
+            const uint64_t settings[] = {
+                static_cast<uint64_t>(validation_.interval), static_cast<uint64_t>(validation_.calendar),
+                validation_.fill_gaps, validation_.max_fill_bars, validation_.repair_ohlc,
+                validation_.drop_zero_volume};
+            source.checksum ^= checksum_bytes(reinterpret_cast<const char*>(settings), sizeof(settings)) | 1;
+        }
+
+        const std::string cache_path = bar_cache_path(file_path);
+        BarStore cached;
+        std::vector<std::string> names;
+        bool hit;
+        {
+            BT_PROFILE_SCOPE(CacheIO);
+            hit = read_bar_cache(cache_path, source, cached, &names) &&
+                  (cached.empty() || (names.size() == 1 && names[0] == symbol));
+        }
+        if (hit) {
+            last_load_stats_.rows_loaded = cached.size();
+            last_load_stats_.bytes_read = source.size;
+            last_load_stats_.from_cache = true;
+            if (store_.empty()) {
+                store_ = std::move(cached);
+            } else {
+                store_.make_owned();
+                const BarColumns rows = cached.columns();
+                store_.reserve(store_.size() + rows.size());
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    store_.append(rows.timestamps[i], rows.symbol_ids[i], rows.open[i], rows.high[i],
+                                  rows.low[i], rows.close[i], rows.volume[i]);
+                }
+            }
+            return true;
+        }
+
+        store_.make_owned();
+        const size_t first_row = store_.size();
+        const bool loaded = (mode == LoadMode::MemoryMapped) ? load_csv_mapped(file_path, symbol)
+                                                             : load_csv_stream(file_path, symbol);
+        if (loaded) {
+            BT_PROFILE_SCOPE(CacheIO);
+            if (!write_bar_cache(cache_path, store_.columns().slice(first_row), source)) {
+                std::cerr << "Warning: could not write bar cache: " << cache_path << std::endl;
+            }
+        }
+        return loaded;
+    }
+
+    /**
+     * @brief Counts a rejected row and reports the first few individually
+     */
+    void DataHandler::report_malformed_row(const std::string& file_path, size_t line_number) {
+        constexpr size_t kMaxReportedRows = 5;  // Individual malformed rows written to std::cerr
+        if (last_load_stats_.rows_malformed < kMaxReportedRows) {
+            std::cerr << file_path << ":" << line_number << ": malformed row skipped" << std::endl;
+        }
+        ++last_load_stats_.rows_malformed;
+        BT_PROFILE_COUNT(RowsMalformed, 1);
+    }
+
+    /**
+     * @brief Prints the total number of rejected rows, if any
+     */
+    void DataHandler::report_malformed_summary(const std::string& file_path) const {
+        if (last_load_stats_.rows_malformed > 0) {
+            std::cerr << file_path << ": " << last_load_stats_.rows_malformed
+                      << " malformed row(s) skipped" << std::endl;
+        }
+    }
+
+    bool DataHandler::open_stream(const std::string& file_path, const std::string& symbol, size_t chunk_rows) {
+        last_load_stats_ = LoadStats{};
+        store_.clear();
+        current_index = 0;
+        stream_.reset(new ChunkedBarReader(chunk_rows));
+        if (!stream_->open(file_path, symbol)) {
+            std::cerr << "Error opening file: " << file_path << std::endl;
+            stream_.reset();
+            return false;
+        }
+        return true;
+    }
+
     /**
      * @brief Checks if there are more bars to process
-     * @return true if current_index is within bounds
+     * @return true if current_index is within bounds (or the stream has more bars)
      */
     bool DataHandler::has_next() const {
-        return current_index < bars_.size();
+        if (stream_) {
+            return stream_->has_next();
+        }
+        return current_index < store_.size();
     }
 
     /**
@@ -74,10 +363,20 @@ namespace backtest {
      * @throws std::out_of_range if no more bars are available
      */
     Bar DataHandler::get_next_bar() {
+        if (stream_) {
+            const Bar bar = stream_->get_next_bar();
+            const ChunkedReadStats& stats = stream_->stats();
+            last_load_stats_.rows_loaded = stats.rows_loaded;
+            last_load_stats_.rows_malformed = stats.rows_malformed;
+            last_load_stats_.bytes_read = stats.bytes_read;
+            ++current_index;
+            last_streamed_ = bar;
+            return bar;
+        }
         if (!has_next()) {
             throw std::out_of_range("No more bars available");
         }
-        return bars_[current_index++];
+        return store_.bar(current_index++);
     }
 
     /**
@@ -86,6 +385,67 @@ namespace backtest {
      */
     void DataHandler::reset() {
         current_index = 0;
+        if (stream_) {
+            last_load_stats_ = LoadStats{};
+            stream_->rewind();
+        }
+    }
+
+    /**
+     * @brief Saves the position and a fingerprint of the bar just before it
+     */
+    void DataHandler::save_cursor(SnapshotWriter& out) const {
+        Bar last;
+        if (current_index > 0) {
+            last = stream_ ? last_streamed_ : store_.bar(current_index - 1);
+        }
+        out.put(static_cast<uint64_t>(current_index));
+        out.put(last.timestamp);
+        out.put(last.close);
+    }
+
+    /**
+     * @brief Validates the saved fingerprint against the current data, then seeks
+     */
+    bool DataHandler::load_cursor(SnapshotReader& in) {
+        uint64_t index = 0;
+        Timestamp timestamp = 0;
+        double close = 0.0;
+        if (!in.get(index) || !in.get(timestamp) || !in.get(close)) {
+            return false;
+        }
+
+        if (stream_) {
+            reset();
+            while (current_index < index && stream_->has_next()) {
+                get_next_bar();
+            }
+            if (current_index < index) {
+                std::cerr << "Checkpoint is after bar " << index << " but the stream has only "
+                          << current_index << " bars" << std::endl;
+                reset();
+                return false;
+            }
+        } else if (index > store_.size()) {
+            std::cerr << "Checkpoint is after bar " << index << " but the data has only "
+                      << store_.size() << " bars" << std::endl;
+            return false;
+        }
+
+        Bar last;
+        if (index > 0) {
+            last = stream_ ? last_streamed_ : store_.bar(index - 1);
+        }
+        if (last.timestamp != timestamp || last.close != close) {
+            std::cerr << "Checkpoint does not match the data: bar " << index
+                      << " has changed since it was taken" << std::endl;
+            if (stream_) {
+                reset();
+            }
+            return false;
+        }
+        current_index = static_cast<size_t>(index);
+        return true;
     }
     
 } // namespace backtest
\ No newline at end of file
@@ -8,11 +8,47 @@
 
 #ifndef DATA_HANDLER_HPP
 #define DATA_HANDLER_HPP
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <vector>
+#include "bar_cursor.hpp"
+#include "bar_store.hpp"
+#include "bar_validator.hpp"
+#include "chunked_bar_reader.hpp"
+#include "compact_bar_store.hpp"
 #include "market_data.hpp"
+#include "../util/snapshot.hpp"
 
 namespace backtest {
+
+    /**
+     * @enum LoadMode
+     * @brief Selects the CSV parsing implementation used by DataHandler::load_csv
+     */
+    enum class LoadMode {
+        Stream,        ///< std::ifstream + std::istringstream per line (original loader)
+        MemoryMapped   ///< mmap() the file and parse fields in place, no per-line allocations
+    };
+
+    /**
+     * @enum CachePolicy
+     * @brief Whether DataHandler::load_csv uses a binary sidecar (see bar_cache.hpp)
+     */
+    enum class CachePolicy {
+        Disabled,   ///< Always parse the CSV
+        ReadWrite   ///< Map `<csv>.bars` if it matches the CSV, otherwise parse and (re)write it
+    };
+
+    /**
+     * @struct LoadStats
+     * @brief Summary of the most recent load_csv() call
+     */
+    struct LoadStats {
+        size_t rows_loaded = 0;     ///< Data rows appended to the dataset
+        size_t rows_malformed = 0;  ///< Data rows rejected because a field (or the timestamp) failed to parse
+        size_t bytes_read = 0;      ///< Size of the source file in bytes
+        bool from_cache = false;    ///< true if the bars came from a binary sidecar instead of parsing
+    };
     
     /**
      * @class DataHandler
@@ -23,35 +59,117 @@ namespace backtest {
      */
     class DataHandler {
         private: 
-            std::vector<Bar> bars_;        ///< Storage for all loaded price bars
+            BarStore store_;               ///< Columnar storage for all loaded price bars
             size_t current_index;          ///< Current position in the data sequence
+            LoadStats last_load_stats_;    ///< Statistics of the most recent load
+            std::unique_ptr<ChunkedBarReader> stream_;  ///< Background reader while in streaming mode
+            Bar last_streamed_;            ///< Bar most recently delivered in streaming mode
+            bool validate_ = false;        ///< Route parsed rows through a BarValidator
+            ValidationConfig validation_;  ///< Settings used when validate_ is set
+            DataQualityReport last_quality_;  ///< Report of the most recent validated load
+
+            bool load_csv_stream(const std::string& file_path, const std::string& symbol);
+            bool load_csv_mapped(const std::string& file_path, const std::string& symbol);
+            bool load_csv_cached(const std::string& file_path, const std::string& symbol, LoadMode mode);
+            void report_malformed_row(const std::string& file_path, size_t line_number);
+            void report_malformed_summary(const std::string& file_path) const;
+            void finish_validation(BarValidator& validator);
             
         public:
             /**
-             * @brief Default constructor - initializes empty data handler
+             * @brief Initializes an empty data handler
+             * @param resource Memory resource for the loaded columns (e.g. a RunArena);
+             *                 mapped sidecar caches are used in place and allocate nothing
              */
-            DataHandler();
+            explicit DataHandler(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
             /**
              * @brief Loads historical market data from a CSV file
              * @param file_path Path to the CSV file containing OHLCV data
              * @param symbol Ticker symbol to assign to all bars (default: "UNKNOWN")
+             * @param mode Parsing implementation to use (default: LoadMode::Stream)
+             * @param cache Binary sidecar policy (default: CachePolicy::Disabled)
              * @return true if file loaded successfully, false otherwise
              * 
              * Expected CSV format: timestamp,open,high,low,close,volume
              * First line (header) is skipped automatically.
+             *
+             * Timestamps must be ISO 8601 dates or date-times and are stored as
+             * integer nanoseconds; the symbol is interned once per file. Rows whose
+             * timestamp does not parse are skipped in both modes. LoadMode::MemoryMapped
+             * additionally skips rows that do not have six fields or whose numeric
+             * fields fail to parse. Skipped rows are reported on std::cerr and in
+             * last_load_stats().
+             *
+             * With CachePolicy::ReadWrite the CSV is checksummed (a single cheap
+             * pass) and, if `<file_path>.bars` was built from identical bytes for
+             * the same symbol, its columns are used in place without parsing.
+             * Otherwise the CSV is parsed with `mode` and the sidecar is rewritten;
+             * failing to write it only produces a warning. Malformed rows are
+             * reported only when the CSV is actually parsed.
+             *
+             * After set_validation() every parsed row passes through a
+             * BarValidator (see bar_validator.hpp) in the same pass, and
+             * rows_loaded counts the bars stored after repair and gap filling.
+             * Validated and raw loads use distinct sidecars; a validated cache
+             * hit stores the cleaned bars but leaves last_quality_report() empty.
              */
-            bool load_csv(const std::string& file_path, const std::string& symbol = "UNKNOWN");
+            bool load_csv(const std::string& file_path, const std::string& symbol = "UNKNOWN",
+                          LoadMode mode = LoadMode::Stream, CachePolicy cache = CachePolicy::Disabled);
             
+            /**
+             * @brief Parses a CSV file straight into reduced-precision columns
+             * @param file_path Path to the CSV file containing OHLCV data
+             * @param symbol Ticker symbol to assign to all bars
+             * @param out Store the bars are appended to (e.g. a CompactBarStore);
+             *            set the symbol's tick size on it first for tick storage
+             * @return false if the file cannot be opened or a price cannot be
+             *         encoded in out's layout (out then keeps the bars before it)
+             *
+             * Parses like LoadMode::MemoryMapped, but each row is encoded as it is
+             * read and no double columns are built: the handler's own store is
+             * left untouched, and peak memory is out's columns alone. Malformed
+             * rows are skipped and counted in last_load_stats(); set_validation()
+             * and sidecar caches do not apply.
+             */
+            template <typename Codec>
+            bool load_compact_csv(const std::string& file_path, const std::string& symbol,
+                                  BasicCompactBarStore<Codec>& out);
+
+            /**
+             * @brief Opens a CSV file in streaming mode instead of loading it
+             * @param file_path Path to the CSV file containing OHLCV data
+             * @param symbol Ticker symbol to assign to all bars
+             * @param chunk_rows Bars parsed ahead per chunk (two chunks are held)
+             * @return true if the file could be opened
+             *
+             * A background thread parses the file chunk by chunk while bars are
+             * consumed through has_next()/get_next_bar(), so memory stays bounded
+             * by 2 x chunk_rows bars however long the file is. Parsing follows
+             * LoadMode::MemoryMapped; set_validation() does not apply. In
+             * streaming mode the store is empty: size(), columns() and cursor()
+             * see no bars, and last_load_stats() counts the bars delivered so far. reset() restarts from the top of
+             * the file; load_csv() leaves streaming mode.
+             */
+            bool open_stream(const std::string& file_path, const std::string& symbol = "UNKNOWN",
+                             size_t chunk_rows = kDefaultChunkRows);
+
+            /**
+             * @brief Checks whether bars come from open_stream() rather than the store
+             */
+            bool is_streaming() const { return stream_ != nullptr; }
+
             /**
              * @brief Checks if more data bars are available
              * @return true if there are unprocessed bars remaining
+             *
+             * In streaming mode this may wait for the reader thread.
              */
             bool has_next() const;
             
             /**
              * @brief Retrieves the next bar and advances the iterator
-             * @return Next Bar in the sequence
+             * @return Next Bar in the sequence (a by-value record; no allocation)
              * @throws std::out_of_range if no more bars are available
              */
             Bar get_next_bar();
@@ -61,11 +179,92 @@ namespace backtest {
              */
             void reset();
 
+            /**
+             * @brief Number of bars delivered by get_next_bar() since the last reset()
+             */
+            size_t position() const { return current_index; }
+
+            /**
+             * @brief Appends the cursor position and the last delivered bar's timestamp and close
+             */
+            void save_cursor(SnapshotWriter& out) const;
+
+            /**
+             * @brief Moves the cursor to a position saved by save_cursor()
+             * @return false if the data has fewer bars than the saved position or
+             *         the bar before it differs; the cursor is then unchanged
+             *         (at the start of the file in streaming mode)
+             *
+             * Meant for data that has grown since the snapshot (e.g. bars
+             * appended to the file): the cursor is placed after the bars that
+             * were already processed, and the check on the last of them catches
+             * snapshots taken over different data. In loaded mode this is O(1);
+             * in streaming mode the stream is rewound and the processed bars are
+             * parsed and skipped.
+             */
+            bool load_cursor(SnapshotReader& in);
+
             /**
              * @brief Returns the total number of loaded bars
-             * @return Total count of bars in the dataset
+             * @return Total count of bars in the dataset (0 in streaming mode)
+             */
+            size_t size() const { return store_.size(); }
+
+            /**
+             * @brief Read-only access to the underlying columnar storage
+             */
+            const BarStore& store() const { return store_; }
+
+            /**
+             * @brief Column views over all loaded bars
+             *
+             * Indicators can run vectorized over these instead of pulling bars
+             * one at a time through get_next_bar().
+             */
+            Span<const Timestamp> timestamps() const { return store_.timestamps(); }
+            Span<const double> opens() const { return store_.opens(); }
+            Span<const double> highs() const { return store_.highs(); }
+            Span<const double> lows() const { return store_.lows(); }
+            Span<const double> closes() const { return store_.closes(); }
+            Span<const double> volumes() const { return store_.volumes(); }
+            BarColumns columns() const { return store_.columns(); }
+
+            /**
+             * @brief Creates an independent cursor over the loaded bars
+             *
+             * has_next()/get_next_bar() share one index and must not be used from
+             * several threads. Cursors carry their own position, so once loading
+             * is finished any number of threads can each replay the data through
+             * their own cursor.
+             */
+            BarCursor cursor() const { return BarCursor(store_.columns()); }
+
+            /**
+             * @brief Returns statistics about the most recent load_csv() call
+             */
+            const LoadStats& last_load_stats() const { return last_load_stats_; }
+
+            /**
+             * @brief Validates, repairs and gap-fills rows in subsequent load_csv() calls
+             */
+            void set_validation(const ValidationConfig& config) {
+                validation_ = config;
+                validate_ = true;
+            }
+
+            /**
+             * @brief Stores parsed rows as they are again (the default)
+             */
+            void disable_validation() { validate_ = false; }
+
+            bool validation_enabled() const { return validate_; }
+
+            /**
+             * @brief Returns what validation found in the most recent load_csv() call
+             *
+             * Empty if validation was disabled or the bars came from a sidecar.
              */
-            size_t size() const { return bars_.size(); }
+            const DataQualityReport& last_quality_report() const { return last_quality_; }
     };
     
 } // namespace backtest
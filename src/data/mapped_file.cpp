@@ -0,0 +1,128 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementation of the read-only file mapping wrapper
+ */
+
+#include "mapped_file.hpp"
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BACKTEST_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace backtest {
+
+    MappedFile::MappedFile() : data_(nullptr), size_(0), open_(false), mapped_(false) {}
+
+    MappedFile::~MappedFile() {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_(other.data_),
+          size_(other.size_),
+          open_(other.open_),
+          mapped_(other.mapped_),
+          fallback_(std::move(other.fallback_)) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+        other.mapped_ = false;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = other.data_;
+            size_ = other.size_;
+            open_ = other.open_;
+            mapped_ = other.mapped_;
+            fallback_ = std::move(other.fallback_);
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.open_ = false;
+            other.mapped_ = false;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Unmaps (or frees) the current file contents
+     */
+    void MappedFile::release() {
+#ifdef BACKTEST_HAVE_MMAP
+        if (mapped_ && data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+        fallback_.clear();
+        fallback_.shrink_to_fit();
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+        mapped_ = false;
+    }
+
+    /**
+     * @brief Maps the whole file read-only
+     * @param file_path Path of the file to map
+     * @return true on success, false if the file cannot be opened or mapped
+     *
+     * The file is mapped MAP_PRIVATE and advised for sequential access, which
+     * lets the kernel read ahead aggressively during a single front-to-back
+     * parse. Platforms without mmap() read the file into a buffer instead.
+     */
+    bool MappedFile::open(const std::string& file_path) {
+        release();
+
+#ifdef BACKTEST_HAVE_MMAP
+        int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            mapped_ = true;
+        }
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+#else
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::streamsize length = file.tellg();
+        file.seekg(0, std::ios::beg);
+        fallback_.resize(static_cast<size_t>(length));
+        if (length > 0 && !file.read(fallback_.data(), length)) {
+            fallback_.clear();
+            return false;
+        }
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+#endif
+        open_ = true;
+        return true;
+    }
+
+} // namespace backtest
@@ -0,0 +1,73 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory mapping of data files
+ *
+ * Provides an RAII wrapper that maps a whole file into memory so parsers can
+ * work directly on the file bytes without copying them into streams or strings.
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+    /**
+     * @class MappedFile
+     * @brief Read-only view of an entire file's contents
+     *
+     * On POSIX systems the file is mapped with mmap() and the pages are faulted
+     * in lazily by the kernel. On other platforms the file is read into a single
+     * heap buffer, so callers see the same contiguous [data(), data() + size())
+     * range either way. The mapping is released when the object is destroyed.
+     */
+    class MappedFile {
+        private:
+            const char* data_;            ///< Start of the mapped bytes (nullptr if not open)
+            size_t size_;                 ///< Number of mapped bytes
+            bool open_;                   ///< true while a file is held
+            bool mapped_;                 ///< true if data_ came from mmap(), false if from fallback_
+            std::vector<char> fallback_;  ///< Buffer used when memory mapping is unavailable
+
+            void release();
+
+        public:
+            /**
+             * @brief Default constructor - creates a closed mapping
+             */
+            MappedFile();
+
+            /**
+             * @brief Destructor - unmaps the file if it is open
+             */
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            /**
+             * @brief Maps a file into memory
+             * @param file_path Path of the file to map
+             * @return true if the file was opened and mapped, false otherwise
+             *
+             * Any previously mapped file is released first. Empty files open
+             * successfully with size() == 0.
+             */
+            bool open(const std::string& file_path);
+
+            /**
+             * @brief Checks whether a file is currently mapped
+             */
+            bool is_open() const { return open_; }
+
+            const char* data() const { return data_; }
+            const char* end() const { return data_ + size_; }
+            size_t size() const { return size_; }
+    };
+
+} // namespace backtest
+#endif // MAPPED_FILE_HPP
@@ -8,7 +8,8 @@
 
 #ifndef MARKET_DATA_HPP
 #define MARKET_DATA_HPP
-#include <string>
+#include "symbol_table.hpp"
+#include "timestamp.hpp"
 
 namespace backtest {
 
@@ -18,10 +19,14 @@ namespace backtest {
  * 
  * Contains OHLCV (Open, High, Low, Close, Volume) price data for a specific time period.
  * This is the fundamental unit of price information used throughout the backtesting system.
+ *
+ * Bar is trivially copyable and owns no heap memory: the time is an integer
+ * and the symbol an interned id, so passing bars around the event loop never
+ * allocates. Use format_timestamp() and symbol_name() to turn them into text.
  */
 struct Bar {
-    std::string timestamp;  ///< ISO 8601 format timestamp (e.g., "2024-01-15T09:30:00")
-    std::string symbol;     ///< Ticker symbol for the asset
+    Timestamp timestamp;    ///< Nanoseconds since epoch (UTC)
+    SymbolId symbol_id;     ///< Interned ticker symbol for the asset
     double open;            ///< Opening price for the period
     double high;            ///< Highest price during the period
     double low;             ///< Lowest price during the period
@@ -30,21 +35,21 @@ struct Bar {
 
     /**
      * @brief Constructs a Bar with all OHLCV data and symbol
-     * @param ts Timestamp string
-     * @param sym Ticker symbol
+     * @param ts Timestamp in nanoseconds since epoch
+     * @param sym Interned ticker symbol id
      * @param o Opening price
      * @param h High price
      * @param l Low price
      * @param c Closing price
      * @param v Trading volume
      */
-    Bar(const std::string& ts, const std::string& sym, double o, double h, double l, double c, double v)
-        : timestamp(ts), symbol(sym), open(o), high(h), low(l), close(c), volume(v) {}
+    Bar(Timestamp ts, SymbolId sym, double o, double h, double l, double c, double v)
+        : timestamp(ts), symbol_id(sym), open(o), high(h), low(l), close(c), volume(v) {}
 
     /**
-     * @brief Default constructor - initializes with zero/empty values
+     * @brief Default constructor - initializes with zero values
      */
-    Bar() : timestamp(""), symbol(""), open(0), high(0), low(0), close(0), volume(0) {}
+    Bar() : timestamp(0), symbol_id(0), open(0), high(0), low(0), close(0), volume(0) {}
 };
 
 } // namespace backtest
@@ -0,0 +1,123 @@
+/**
+ * @file multi_symbol_data_handler.cpp
+ * @brief Implementation of the k-way timestamp merge over per-symbol streams
+ */
+
+#include "multi_symbol_data_handler.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace backtest {
+
+    MultiSymbolDataHandler::MultiSymbolDataHandler() : heap_size_(0), total_bars_(0), emitted_(0) {}
+
+    bool MultiSymbolDataHandler::add_file(const std::string& file_path, const std::string& symbol,
+                                          LoadMode mode, CachePolicy cache) {
+        DataHandler data;
+        if (!data.load_csv(file_path, symbol, mode, cache)) {
+            return false;
+        }
+        return add_stream(std::move(data), file_path);
+    }
+
+    bool MultiSymbolDataHandler::add_files(const std::vector<DataFile>& files, const ParallelLoadConfig& config,
+                                           ParallelLoadStats* stats) {
+        std::vector<DataHandler> loaded;
+        ParallelLoadStats load_stats;
+        bool ok = load_files_parallel(files, loaded, config, &load_stats);
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            if (load_stats.files[i].ok) {
+                ok = add_stream(std::move(loaded[i]), files[i].path) && ok;
+            }
+        }
+        if (stats) {
+            *stats = std::move(load_stats);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Checks that a loaded file is sorted and appends it as a stream
+     */
+    bool MultiSymbolDataHandler::add_stream(DataHandler&& data, const std::string& file_path) {
+        const Span<const Timestamp> timestamps = data.timestamps();
+        for (size_t i = 1; i < timestamps.size(); ++i) {
+            if (timestamps[i] < timestamps[i - 1]) {
+                std::cerr << file_path << ": bars are not sorted by timestamp (bar " << i + 1
+                          << ")" << std::endl;
+                return false;
+            }
+        }
+
+        // Moving a DataHandler keeps its column buffers (or mapping), so the
+        // view stays valid when streams_ reallocates
+        total_bars_ += data.size();
+        columns_.push_back(data.columns());
+        streams_.push_back(std::move(data));
+        positions_.resize(streams_.size());
+        heap_.resize(streams_.size());
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Restores the heap property below position i
+     */
+    void MultiSymbolDataHandler::sift_down(size_t i) {
+        const HeapEntry moving = heap_[i];
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= heap_size_) {
+                break;
+            }
+            if (child + 1 < heap_size_ && before(heap_[child + 1], heap_[child])) {
+                ++child;
+            }
+            if (!before(heap_[child], moving)) {
+                break;
+            }
+            heap_[i] = heap_[child];
+            i = child;
+        }
+        heap_[i] = moving;
+    }
+
+    Bar MultiSymbolDataHandler::get_next_bar() {
+        if (!has_next()) {
+            throw std::out_of_range("No more bars available");
+        }
+
+        HeapEntry& top = heap_[0];
+        const BarColumns& columns = columns_[top.stream];
+        size_t& position = positions_[top.stream];
+        const Bar bar = columns.bar(position++);
+        ++emitted_;
+
+        if (position < columns.size()) {
+            top.timestamp = columns.timestamps[position];
+        } else {
+            top = heap_[--heap_size_];
+        }
+        if (heap_size_ > 1) {
+            sift_down(0);
+        }
+        return bar;
+    }
+
+    void MultiSymbolDataHandler::reset() {
+        heap_size_ = 0;
+        emitted_ = 0;
+        for (size_t s = 0; s < columns_.size(); ++s) {
+            positions_[s] = 0;
+            if (!columns_[s].empty()) {
+                heap_[heap_size_++] = HeapEntry{columns_[s].timestamps[0], static_cast<uint32_t>(s)};
+            }
+        }
+        // Bottom-up heap construction, O(streams)
+        for (size_t i = heap_size_ / 2; i-- > 0;) {
+            sift_down(i);
+        }
+    }
+
+} // namespace backtest
@@ -0,0 +1,139 @@
+/**
+ * @file multi_symbol_data_handler.hpp
+ * @brief Time-ordered feed over many per-symbol data files
+ *
+ * DataHandler assigns one symbol to a whole file. MultiSymbolDataHandler
+ * loads one file per instrument and replays all of them as a single stream
+ * in global timestamp order, by k-way merging the (already time-sorted)
+ * per-symbol columns.
+ */
+
+#ifndef MULTI_SYMBOL_DATA_HANDLER_HPP
+#define MULTI_SYMBOL_DATA_HANDLER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "data_handler.hpp"
+#include "parallel_loader.hpp"
+
+namespace backtest {
+
+    /**
+     * @class MultiSymbolDataHandler
+     * @brief Merges per-symbol bar streams into one timestamp-ordered feed
+     *
+     * Each added file becomes one stream, tagged with its interned symbol id.
+     * The merge keeps a binary min-heap with one entry per non-exhausted
+     * stream; an entry carries the stream's next timestamp inline, so the heap
+     * is a single small contiguous array (16 bytes per stream, ~48 KB for
+     * 3,000 tickers) and comparisons never chase pointers. The heap and the
+     * per-stream positions are sized when files are added, so has_next() /
+     * get_next_bar() and reset() never allocate.
+     *
+     * Bars with equal timestamps are emitted in the order their files were
+     * added. Every file must be sorted by timestamp (non-decreasing).
+     */
+    class MultiSymbolDataHandler {
+        private:
+            /**
+             * @struct HeapEntry
+             * @brief Next pending bar of one stream
+             */
+            struct HeapEntry {
+                Timestamp timestamp;  ///< Timestamp of the stream's next bar
+                uint32_t stream;      ///< Index into streams_
+            };
+
+            std::vector<DataHandler> streams_;  ///< One loaded file per symbol
+            std::vector<BarColumns> columns_;   ///< Column views of streams_, for the merge loop
+            std::vector<size_t> positions_;     ///< Next row of each stream
+            std::vector<HeapEntry> heap_;       ///< Min-heap by (timestamp, stream); capacity = streams
+            size_t heap_size_;                  ///< Live entries in heap_
+            size_t total_bars_;                 ///< Sum of all stream sizes
+            size_t emitted_;                    ///< Bars returned since the last reset()
+
+            static bool before(const HeapEntry& a, const HeapEntry& b) {
+                return a.timestamp < b.timestamp || (a.timestamp == b.timestamp && a.stream < b.stream);
+            }
+            void sift_down(size_t i);
+            bool add_stream(DataHandler&& data, const std::string& file_path);
+
+        public:
+            /**
+             * @brief Creates an empty feed
+             */
+            MultiSymbolDataHandler();
+
+            /**
+             * @brief Loads one instrument's file as an additional stream
+             * @param file_path CSV file with the instrument's bars, oldest first
+             * @param symbol Ticker assigned to every bar of the file (interned)
+             * @param mode Parsing implementation (see DataHandler::load_csv)
+             * @param cache Binary sidecar policy (see DataHandler::load_csv)
+             * @return false if the file cannot be loaded or is not sorted by timestamp
+             *
+             * Adding a stream rewinds the feed to the first bar.
+             */
+            bool add_file(const std::string& file_path, const std::string& symbol,
+                          LoadMode mode = LoadMode::MemoryMapped, CachePolicy cache = CachePolicy::Disabled);
+
+            /**
+             * @brief Loads many files on worker threads and adds them as streams, in list order
+             * @param files Files and their tickers (see list_data_files())
+             * @param config Threads and per-file load settings (see load_files_parallel())
+             * @param stats Optional per-file and aggregate load statistics
+             * @return false if any file cannot be loaded or is not sorted; the others are still added
+             *
+             * Gives the same streams and symbol ids as calling add_file() for
+             * each file in order. The loaded columns become the streams as
+             * they are, without a copy.
+             */
+            bool add_files(const std::vector<DataFile>& files, const ParallelLoadConfig& config = ParallelLoadConfig(),
+                           ParallelLoadStats* stats = nullptr);
+
+            /**
+             * @brief Checks if more bars are available in any stream
+             */
+            bool has_next() const { return heap_size_ != 0; }
+
+            /**
+             * @brief Returns the earliest pending bar across all streams and advances
+             * @throws std::out_of_range if no more bars are available
+             */
+            Bar get_next_bar();
+
+            /**
+             * @brief Timestamp of the bar get_next_bar() would return
+             * @pre has_next()
+             */
+            Timestamp next_timestamp() const { return heap_[0].timestamp; }
+
+            /**
+             * @brief Rewinds every stream to its first bar
+             */
+            void reset();
+
+            /**
+             * @brief Total number of bars over all streams
+             */
+            size_t size() const { return total_bars_; }
+
+            /**
+             * @brief Bars returned since the last reset()
+             */
+            size_t position() const { return emitted_; }
+
+            /**
+             * @brief Number of streams (symbols)
+             */
+            size_t stream_count() const { return streams_.size(); }
+
+            /**
+             * @brief Loaded bars of stream i, in file order
+             */
+            const DataHandler& stream(size_t i) const { return streams_[i]; }
+    };
+
+} // namespace backtest
+#endif // MULTI_SYMBOL_DATA_HANDLER_HPP
@@ -0,0 +1,165 @@
+/**
+ * @file parallel_loader.cpp
+ * @brief Implementation of file discovery and multi-threaded loading
+ */
+
+#include "parallel_loader.hpp"
+#include "../util/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace backtest {
+
+    namespace {
+
+        std::string file_symbol(const std::filesystem::path& path) { return path.stem().string(); }
+
+        bool read_file_list(const std::string& list_path, std::vector<DataFile>& files) {
+            std::ifstream list(list_path);
+            if (!list.is_open()) {
+                std::cerr << "Error: Could not open file list " << list_path << std::endl;
+                return false;
+            }
+            std::string line;
+            while (std::getline(list, line)) {
+                std::istringstream fields(line);
+                std::string first;
+                if (!(fields >> first) || first[0] == '#') {
+                    continue;
+                }
+                std::string second;
+                if (fields >> second) {
+                    files.push_back(DataFile{second, first});
+                } else {
+                    files.push_back(DataFile{first, file_symbol(first)});
+                }
+            }
+            return true;
+        }
+
+    } // namespace
+
+    bool list_data_files(const std::string& path, std::vector<DataFile>& files) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error)) {
+            if (std::filesystem::path(path).extension() == ".csv") {
+                files.push_back(DataFile{path, file_symbol(path)});
+                return true;
+            }
+            return read_file_list(path, files);
+        }
+
+        std::vector<DataFile> found;
+        for (std::filesystem::directory_iterator it(path, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_regular_file(error) && it->path().extension() == ".csv") {
+                found.push_back(DataFile{it->path().string(), file_symbol(it->path())});
+            }
+        }
+        if (error) {
+            std::cerr << "Error: Could not list " << path << ": " << error.message() << std::endl;
+            return false;
+        }
+        std::sort(found.begin(), found.end(),
+                  [](const DataFile& a, const DataFile& b) { return a.path < b.path; });
+        files.insert(files.end(), found.begin(), found.end());
+        return true;
+    }
+
+    bool load_files_parallel(const std::vector<DataFile>& files, std::vector<DataHandler>& out,
+                             const ParallelLoadConfig& config, ParallelLoadStats* stats) {
+        const auto start = std::chrono::steady_clock::now();
+        out.clear();
+        out.resize(files.size());
+        std::vector<FileLoadStats> results(files.size());
+
+        // Ids in file order, whichever worker reaches a file first
+        std::vector<size_t> sizes(files.size(), 0);
+        for (size_t i = 0; i < files.size(); ++i) {
+            results[i].path = files[i].path;
+            results[i].symbol = intern_symbol(files[i].symbol);
+            std::error_code error;
+            const auto size = std::filesystem::file_size(files[i].path, error);
+            sizes[i] = error ? 0 : static_cast<size_t>(size);
+        }
+
+        // Largest first, so the longest loads start early and short ones fill in at the end
+        std::vector<size_t> order(files.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+        const size_t threads = std::max<size_t>(
+            std::min<size_t>(config.threads == 0 ? std::thread::hardware_concurrency() : config.threads,
+                             files.size()),
+            1);
+        std::atomic<size_t> next(0);
+        auto load_next = [&](size_t worker) {
+            for (size_t k = next.fetch_add(1, std::memory_order_relaxed); k < order.size();
+                 k = next.fetch_add(1, std::memory_order_relaxed)) {
+                const size_t i = order[k];
+                DataHandler& data = out[i];
+                if (config.validate) {
+                    data.set_validation(config.validation);
+                }
+                const auto file_start = std::chrono::steady_clock::now();
+                results[i].ok = data.load_csv(files[i].path, files[i].symbol, config.mode, config.cache);
+                results[i].seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - file_start).count();
+                results[i].load = data.last_load_stats();
+                results[i].worker = worker;
+            }
+        };
+        if (threads > 1) {
+            ThreadPool pool(threads);
+            pool.parallel_for(threads, [&](size_t) { load_next(pool.current_worker()); });
+        } else {
+            load_next(0);
+        }
+
+        bool ok = true;
+        ParallelLoadStats totals;
+        totals.threads = threads;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!results[i].ok) {
+                ok = false;
+                ++totals.failed;
+                continue;
+            }
+            totals.bytes += results[i].load.bytes_read;
+            totals.rows += results[i].load.rows_loaded;
+        }
+        totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        totals.files = std::move(results);
+        if (stats) {
+            *stats = std::move(totals);
+        }
+        return ok;
+    }
+
+    void print_load_stats(std::ostream& os, const ParallelLoadStats& stats, bool per_file) {
+        char line[512];
+        if (per_file) {
+            for (const FileLoadStats& file : stats.files) {
+                std::snprintf(line, sizeof(line), "%-40s %-8s %10zu rows %9.2f MB %9.2f ms %9.1f MB/s  worker %zu%s\n",
+                              file.path.c_str(), symbol_name(file.symbol).c_str(), file.load.rows_loaded,
+                              static_cast<double>(file.load.bytes_read) / (1024.0 * 1024.0), file.seconds * 1e3,
+                              file.mb_per_second(), file.worker,
+                              !file.ok ? "  FAILED" : file.load.from_cache ? "  (cache)" : "");
+                os << line;
+            }
+        }
+        std::snprintf(line, sizeof(line),
+                      "%zu files (%zu failed), %zu rows, %.2f MB in %.2f ms on %zu threads: %.1f MB/s, %.0f rows/s\n",
+                      stats.files.size(), stats.failed, stats.rows, static_cast<double>(stats.bytes) / (1024.0 * 1024.0),
+                      stats.seconds * 1e3, stats.threads, stats.mb_per_second(), stats.rows_per_second());
+        os << line;
+    }
+
+} // namespace backtest
@@ -0,0 +1,114 @@
+/**
+ * @file parallel_loader.hpp
+ * @brief Loading many per-symbol data files at once on worker threads
+ *
+ * A multi-symbol run starts by loading one file per instrument. Loading them
+ * one after another leaves all but one core idle and keeps a single read in
+ * flight, so a cold start over thousands of files is bound by latency long
+ * before the disk is busy. load_files_parallel() loads the files on a fixed
+ * set of workers instead:
+ *
+ * - every file is parsed into its own DataHandler, which is also that load's
+ *   buffer: the handler's columns are reserved from a row estimate, filled in
+ *   place and then used as they are, so no bar is copied after parsing;
+ * - workers pull the next file from a shared counter, largest files first,
+ *   so one huge file cannot end up last on a busy worker;
+ * - symbols are interned into the global SymbolTable in file order before
+ *   any worker starts, so ids do not depend on thread timing.
+ *
+ * Per-file and aggregate timings and sizes are returned in ParallelLoadStats.
+ */
+
+#ifndef PARALLEL_LOADER_HPP
+#define PARALLEL_LOADER_HPP
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "data_handler.hpp"
+
+namespace backtest {
+
+    /**
+     * @struct DataFile
+     * @brief One file to load and the symbol its bars belong to
+     */
+    struct DataFile {
+        std::string path;
+        std::string symbol;
+    };
+
+    /**
+     * @brief Collects the data files named by path
+     * @param path A directory (every `*.csv` in it, symbol = file name without
+     *             extension, sorted by name), a single `.csv` file, or a list
+     *             file with one "SYMBOL PATH" or "PATH" per line ('#' starts a comment)
+     * @return false if path cannot be read; reported on std::cerr
+     */
+    bool list_data_files(const std::string& path, std::vector<DataFile>& files);
+
+    /**
+     * @struct ParallelLoadConfig
+     * @brief How load_files_parallel() loads each file
+     */
+    struct ParallelLoadConfig {
+        size_t threads = 0;                       ///< Workers (0 = hardware concurrency), at most one per file
+        LoadMode mode = LoadMode::MemoryMapped;   ///< See DataHandler::load_csv
+        CachePolicy cache = CachePolicy::Disabled;
+        bool validate = false;                    ///< Pass validation to each handler (see bar_validator.hpp)
+        ValidationConfig validation;
+    };
+
+    /**
+     * @struct FileLoadStats
+     * @brief Outcome of loading one file
+     */
+    struct FileLoadStats {
+        std::string path;
+        SymbolId symbol = kInvalidSymbol;
+        bool ok = false;
+        LoadStats load;           ///< The handler's last_load_stats()
+        double seconds = 0.0;     ///< Time spent in load_csv()
+        size_t worker = 0;        ///< Worker that loaded the file
+
+        double mb_per_second() const {
+            return seconds > 0.0 ? static_cast<double>(load.bytes_read) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @struct ParallelLoadStats
+     * @brief Per-file statistics (in input order) and their totals
+     */
+    struct ParallelLoadStats {
+        std::vector<FileLoadStats> files;
+        size_t threads = 0;       ///< Workers used
+        double seconds = 0.0;     ///< Wall time of the whole load
+        size_t bytes = 0;         ///< Bytes of all files read
+        size_t rows = 0;          ///< Bars loaded over all files
+        size_t failed = 0;        ///< Files that could not be loaded
+
+        double mb_per_second() const {
+            return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+        double rows_per_second() const { return seconds > 0.0 ? static_cast<double>(rows) / seconds : 0.0; }
+    };
+
+    /**
+     * @brief Loads every file into its own DataHandler, several files at a time
+     * @param files Files to load; out[i] receives files[i]
+     * @param out Replaced by one handler per file (empty for files that failed)
+     * @param stats Optional per-file and aggregate statistics
+     * @return false if any file failed to load
+     */
+    bool load_files_parallel(const std::vector<DataFile>& files, std::vector<DataHandler>& out,
+                             const ParallelLoadConfig& config = ParallelLoadConfig(),
+                             ParallelLoadStats* stats = nullptr);
+
+    /**
+     * @brief Prints the aggregate throughput, preceded by one line per file if per_file is set
+     */
+    void print_load_stats(std::ostream& os, const ParallelLoadStats& stats, bool per_file);
+
+} // namespace backtest
+#endif // PARALLEL_LOADER_HPP
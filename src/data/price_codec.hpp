@@ -0,0 +1,129 @@
+/**
+ * @file price_codec.hpp
+ * @brief Storage layouts for prices and the one selected at configure time
+ *
+ * BarStore keeps every price as a double. Runs over long histories or large
+ * universes stream those columns from memory on every pass and are bound by
+ * bandwidth rather than arithmetic, so prices can instead be stored in a
+ * narrower layout and widened to double where they are used:
+ *
+ * - Float32PriceCodec: prices as float (about 7 significant digits);
+ * - TickPriceCodec:    prices as int32 multiples of a per-symbol tick size;
+ * - DoublePriceCodec:  prices as double, the reference layout.
+ *
+ * The CMake option BACKTEST_PRICE_STORAGE (double, float or ticks) selects
+ * PriceCodec, the layout of CompactBarStore (data/compact_bar_store.hpp) and
+ * of the prices inside Position. All arithmetic on decoded prices (rolling
+ * sums, P&L, valuation) stays in double.
+ */
+
+#ifndef PRICE_CODEC_HPP
+#define PRICE_CODEC_HPP
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "../indicators/crossover_kernel.hpp"
+
+namespace backtest {
+
+    /// Tick size of symbols without an explicit one (cents)
+    constexpr double kDefaultTickSize = 0.01;
+
+    /**
+     * @brief Stores prices as doubles (no loss)
+     *
+     * Codecs receive the symbol's scale, ticks per price unit (100 for cents).
+     * PositionPrice is how a Position holds its entry and current prices.
+     */
+    struct DoublePriceCodec {
+        using Stored = double;
+        using PositionPrice = double;
+        static constexpr const char* name = "double";
+        static constexpr bool kScaled = false;  ///< Whether decoding depends on the symbol's scale
+        static bool encode(double price, double, Stored& out) {
+            out = price;
+            return true;
+        }
+        static double decode(Stored value, double) { return value; }
+        static void decode_block(const Stored* in, size_t n, double, double* out) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = in[i];
+            }
+        }
+    };
+
+    /**
+     * @brief Stores prices as IEEE single precision
+     *
+     * Positions keep float prices too: an average entry price rounded to
+     * float is as precise as the market prices it was averaged from.
+     */
+    struct Float32PriceCodec {
+        using Stored = float;
+        using PositionPrice = float;
+        static constexpr const char* name = "float32";
+        static constexpr bool kScaled = false;
+        static bool encode(double price, double, Stored& out) {
+            out = static_cast<float>(price);
+            return true;
+        }
+        static double decode(Stored value, double) { return static_cast<double>(value); }
+        static void decode_block(const Stored* in, size_t n, double, double* out) {
+            widen_prices_kernel(in, n, out);
+        }
+    };
+
+    /**
+     * @brief Stores prices as int32 tick counts; fails for non-finite, out-of-range or off-grid prices
+     *
+     * Decoding divides by the integral scale instead of multiplying by the
+     * tick size, so a price on the tick grid decodes to the same double the
+     * CSV parser produced (10123 / 100 == 101.23, while 10123 * 0.01 is not).
+     * A price that does not decode back to within half an ulp of itself lies
+     * off the grid (e.g. 1.23456 with a cent tick) and is rejected rather
+     * than snapped to the nearest tick.
+     *
+     * Ticks are int32 so a compact bar stays half the size of a double one,
+     * which limits |price| to kMaxTicks ticks: about 21.4 million at a cent
+     * tick, but only about 21.4 at a tick of 1e-8. Larger prices fail to
+     * encode. Position prices stay double, since an average entry price is
+     * generally not on the tick grid.
+     */
+    struct TickPriceCodec {
+        using Stored = int32_t;
+        using PositionPrice = double;
+        static constexpr const char* name = "ticks";
+        static constexpr bool kScaled = true;
+        static constexpr int64_t kMaxTicks = INT32_MAX;
+        static bool encode(double price, double scale, Stored& out) {
+            const double ticks = std::round(price * scale);
+            if (!(ticks >= static_cast<double>(-kMaxTicks) && ticks <= static_cast<double>(kMaxTicks))) {
+                return false;
+            }
+            const double magnitude = std::fabs(price);
+            const double half_ulp = 0.5 * (std::nextafter(magnitude, INFINITY) - magnitude);
+            if (std::fabs(ticks / scale - price) > half_ulp) {
+                return false;
+            }
+            out = static_cast<int32_t>(ticks);
+            return true;
+        }
+        static double decode(Stored value, double scale) { return static_cast<double>(value) / scale; }
+        static void decode_block(const Stored* in, size_t n, double scale, double* out) {
+            ticks_to_prices_kernel(in, n, scale, out);
+        }
+    };
+
+#if defined(BACKTEST_PRICE_STORAGE_FLOAT)
+    using PriceCodec = Float32PriceCodec;
+#elif defined(BACKTEST_PRICE_STORAGE_TICKS)
+    using PriceCodec = TickPriceCodec;
+#else
+    using PriceCodec = DoublePriceCodec;
+#endif
+
+    /// How Position stores its entry and current prices in this build
+    using PositionPrice = PriceCodec::PositionPrice;
+
+} // namespace backtest
+#endif // PRICE_CODEC_HPP
@@ -0,0 +1,47 @@
+/**
+ * @file symbol_table.cpp
+ * @brief Implementation of symbol interning
+ */
+
+#include "symbol_table.hpp"
+#include <stdexcept>
+
+namespace backtest {
+
+    SymbolId SymbolTable::intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        const SymbolId id = static_cast<SymbolId>(names_.size());
+        names_.emplace_back(name);
+        ids_.emplace(std::string_view(names_.back()), id);
+        return id;
+    }
+
+    SymbolId SymbolTable::find(std::string_view name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : kInvalidSymbol;
+    }
+
+    const std::string& SymbolTable::name(SymbolId id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id >= names_.size()) {
+            throw std::out_of_range("Unknown symbol id");
+        }
+        return names_[id];
+    }
+
+    size_t SymbolTable::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size();
+    }
+
+    SymbolTable& SymbolTable::global() {
+        static SymbolTable table;
+        return table;
+    }
+
+} // namespace backtest
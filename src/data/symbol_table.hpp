@@ -0,0 +1,81 @@
+/**
+ * @file symbol_table.hpp
+ * @brief Interning of ticker symbols into small integer ids
+ *
+ * Bars, positions and feeds refer to instruments by SymbolId instead of by
+ * std::string, so hot paths compare and index integers rather than hashing or
+ * copying strings. The name is only looked up again for output.
+ */
+
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace backtest {
+
+    /// Dense integer id of an interned ticker symbol
+    using SymbolId = uint32_t;
+
+    /// Id returned by SymbolTable::find() for names that were never interned
+    constexpr SymbolId kInvalidSymbol = UINT32_MAX;
+
+    /**
+     * @class SymbolTable
+     * @brief Thread-safe bidirectional map between symbol names and ids
+     *
+     * Ids are assigned densely from 0 in interning order and are never reused,
+     * so they can index plain arrays. Interning takes a lock and is meant for
+     * load time; name() returns a reference that stays valid for the lifetime
+     * of the table.
+     */
+    class SymbolTable {
+        private:
+            mutable std::mutex mutex_;
+            std::deque<std::string> names_;                   ///< id -> name (deque keeps references stable)
+            std::unordered_map<std::string_view, SymbolId> ids_;  ///< name -> id, keys view into names_
+
+        public:
+            /**
+             * @brief Returns the id for name, assigning a new one if needed
+             */
+            SymbolId intern(std::string_view name);
+
+            /**
+             * @brief Looks up an existing id without interning
+             * @return The id, or kInvalidSymbol if name is unknown
+             */
+            SymbolId find(std::string_view name) const;
+
+            /**
+             * @brief Returns the name of an interned id
+             * @throws std::out_of_range if id was never assigned
+             */
+            const std::string& name(SymbolId id) const;
+
+            /**
+             * @brief Number of interned symbols
+             */
+            size_t size() const;
+
+            /**
+             * @brief Process-wide table shared by all data handlers and portfolios
+             *
+             * Using one table keeps ids consistent across every component of a
+             * run, e.g. a Portfolio can index positions by the ids in incoming bars.
+             */
+            static SymbolTable& global();
+    };
+
+    /// Shorthand for SymbolTable::global().intern(name)
+    inline SymbolId intern_symbol(std::string_view name) { return SymbolTable::global().intern(name); }
+
+    /// Shorthand for SymbolTable::global().name(id)
+    inline const std::string& symbol_name(SymbolId id) { return SymbolTable::global().name(id); }
+
+} // namespace backtest
+#endif // SYMBOL_TABLE_HPP
@@ -0,0 +1,221 @@
+/**
+ * @file timestamp.cpp
+ * @brief Conversion between ISO 8601 text and integer timestamps
+ */
+
+#include "timestamp.hpp"
+
+namespace backtest {
+
+    namespace {
+
+        /**
+         * @brief Parses exactly `width` decimal digits at p (the caller checks the length)
+         */
+        bool parse_digits(const char* p, size_t width, unsigned& out) {
+            unsigned value = 0;
+            for (size_t i = 0; i < width; ++i) {
+                const unsigned digit = static_cast<unsigned char>(p[i]) - unsigned('0');
+                if (digit > 9) {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            out = value;
+            return true;
+        }
+
+        bool is_digit(char c) {
+            return static_cast<unsigned char>(c) - unsigned('0') <= 9;
+        }
+
+        /**
+         * @brief Writes value as exactly `width` decimal digits, zero-padded
+         */
+        char* write_digits(char* p, unsigned value, size_t width) {
+            for (size_t i = width; i > 0; --i) {
+                p[i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            return p + width;
+        }
+
+        /**
+         * @brief Inverse of days_from_civil()
+         */
+        void civil_from_days(int64_t z, int64_t& year, unsigned& month, unsigned& day) {
+            z += 719468;
+            const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+            const unsigned doe = static_cast<unsigned>(z - era * 146097);
+            const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp = (5 * doy + 2) / 153;
+            day = doy - (153 * mp + 2) / 5 + 1;
+            month = mp < 10 ? mp + 3 : mp - 9;
+            year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+        }
+
+        bool is_leap(unsigned year) {
+            return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        }
+
+        unsigned days_in_month(unsigned year, unsigned month) {
+            static const unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+            return (month == 2 && is_leap(year)) ? 29 : kDays[month - 1];
+        }
+
+    } // namespace
+
+    /**
+     * @brief Howard Hinnant's days_from_civil algorithm
+     */
+    int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+        year -= month <= 2 ? 1 : 0;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    bool parse_timestamp(std::string_view text, Timestamp& out) {
+        const char* p = text.data();
+        const size_t size = text.size();
+        unsigned year, month, day;
+        if (size < 10 || p[4] != '-' || p[7] != '-' || !parse_digits(p, 4, year) ||
+            !parse_digits(p + 5, 2, month) || !parse_digits(p + 8, 2, day)) {
+            return false;
+        }
+        if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)) {
+            return false;
+        }
+
+        int64_t nanos = 0;        // Since midnight of the local date
+        int64_t zone_offset = 0;  // Local time minus UTC, in nanoseconds
+        size_t i = 10;
+        if (i < size) {
+            unsigned hour, minute, second = 0;
+            if ((p[i] != 'T' && p[i] != ' ') || size < i + 6 || p[i + 3] != ':' ||
+                !parse_digits(p + i + 1, 2, hour) || !parse_digits(p + i + 4, 2, minute)) {
+                return false;
+            }
+            i += 6;
+            if (i < size && p[i] == ':') {
+                if (size < i + 3 || !parse_digits(p + i + 1, 2, second)) {
+                    return false;
+                }
+                i += 3;
+            }
+            if (hour > 23 || minute > 59 || second > 60) {
+                return false;
+            }
+            nanos = (static_cast<int64_t>(hour) * 3600 + minute * 60 + second) * kNanosPerSecond;
+
+            // Fraction: up to nine significant digits, the rest truncated
+            if (i < size && (p[i] == '.' || p[i] == ',')) {
+                ++i;
+                const size_t first = i;
+                int64_t fraction = 0;
+                int64_t scale = kNanosPerSecond;
+                for (; i < size && is_digit(p[i]); ++i) {
+                    if (scale > 1) {
+                        scale /= 10;
+                        fraction += (p[i] - '0') * scale;
+                    }
+                }
+                if (i == first) {
+                    return false;
+                }
+                nanos += fraction;
+            }
+
+            // Zone designator
+            if (i < size) {
+                if (p[i] == 'Z') {
+                    ++i;
+                } else if (p[i] == '+' || p[i] == '-') {
+                    const int64_t sign = p[i] == '-' ? -1 : 1;
+                    unsigned zone_hour, zone_minute = 0;
+                    if (size < i + 3 || !parse_digits(p + i + 1, 2, zone_hour)) {
+                        return false;
+                    }
+                    i += 3;
+                    if (i < size) {
+                        if (p[i] == ':') {
+                            ++i;
+                        }
+                        if (size < i + 2 || !parse_digits(p + i, 2, zone_minute)) {
+                            return false;
+                        }
+                        i += 2;
+                    }
+                    if (zone_hour > 23 || zone_minute > 59) {
+                        return false;
+                    }
+                    zone_offset = sign * (zone_hour * kNanosPerHour + zone_minute * kNanosPerMinute);
+                } else {
+                    return false;
+                }
+            }
+            if (i != size) {
+                return false;
+            }
+        }
+
+        // Dates outside about 1677-2262 do not fit in int64 nanoseconds
+        int64_t midnight, result;
+        if (__builtin_mul_overflow(days_from_civil(year, month, day), kNanosPerDay, &midnight) ||
+            __builtin_add_overflow(midnight, nanos - zone_offset, &result)) {
+            return false;
+        }
+        out = result;
+        return true;
+    }
+
+    std::string format_timestamp(Timestamp ts) {
+        char buffer[kTimestampBufferSize];
+        const size_t length = format_timestamp(ts, buffer);
+        return std::string(buffer, length);
+    }
+
+    size_t format_timestamp(Timestamp ts, char* buffer) {
+        const int64_t days = days_since_epoch(ts);
+        const int64_t rem = ts - days * kNanosPerDay;
+
+        int64_t year;
+        unsigned month, day;
+        civil_from_days(days, year, month, day);
+
+        // int64 nanoseconds span the years 1677-2262, so the year always has four digits
+        char* p = buffer;
+        p = write_digits(p, static_cast<unsigned>(year), 4);
+        *p++ = '-';
+        p = write_digits(p, month, 2);
+        *p++ = '-';
+        p = write_digits(p, day, 2);
+
+        if (rem != 0) {
+            const unsigned secs = static_cast<unsigned>(rem / kNanosPerSecond);
+            const unsigned fraction = static_cast<unsigned>(rem % kNanosPerSecond);
+            *p++ = 'T';
+            p = write_digits(p, secs / 3600, 2);
+            *p++ = ':';
+            p = write_digits(p, (secs / 60) % 60, 2);
+            *p++ = ':';
+            p = write_digits(p, secs % 60, 2);
+            if (fraction != 0) {
+                *p++ = '.';
+                if (fraction % 1000000 == 0) {
+                    p = write_digits(p, fraction / 1000000, 3);
+                } else if (fraction % 1000 == 0) {
+                    p = write_digits(p, fraction / 1000, 6);
+                } else {
+                    p = write_digits(p, fraction, 9);
+                }
+            }
+        }
+        *p = '\0';
+        return static_cast<size_t>(p - buffer);
+    }
+
+} // namespace backtest
@@ -0,0 +1,92 @@
+/**
+ * @file timestamp.hpp
+ * @brief Integer time representation for market data
+ *
+ * Timestamps are stored as signed 64-bit nanoseconds since the Unix epoch
+ * (UTC), so ordering and arithmetic are plain integer operations. Text is
+ * only parsed when a file is loaded and only formatted for output; both
+ * directions are hand-rolled digit loops that never allocate.
+ */
+
+#ifndef TIMESTAMP_HPP
+#define TIMESTAMP_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace backtest {
+
+    /// Nanoseconds since 1970-01-01T00:00:00Z
+    using Timestamp = int64_t;
+
+    constexpr Timestamp kNanosPerSecond = 1000000000LL;
+    constexpr Timestamp kNanosPerMinute = 60LL * kNanosPerSecond;
+    constexpr Timestamp kNanosPerHour = 60LL * kNanosPerMinute;
+    constexpr Timestamp kNanosPerDay = 24LL * kNanosPerHour;
+
+    /**
+     * @brief Parses an ISO 8601 date or date-time
+     * @param text "YYYY-MM-DD", optionally followed by 'T' or ' ' and
+     *             "HH:MM[:SS[.fffffffff]]" and a zone designator
+     *             ("Z", "+HH", "+HHMM" or "+HH:MM", also with '-')
+     * @param out Receives nanoseconds since epoch (UTC) on success
+     * @return true if text is a valid date/date-time, false otherwise
+     *
+     * Fractional seconds may use '.' or ',' and are kept to the nanosecond;
+     * further digits are truncated. Times with a zone offset are converted to
+     * UTC; times without one are taken as UTC.
+     */
+    bool parse_timestamp(std::string_view text, Timestamp& out);
+
+    /**
+     * @brief Formats a timestamp as ISO 8601 (UTC)
+     * @return "YYYY-MM-DD" for midnight timestamps, "YYYY-MM-DDTHH:MM:SS" otherwise,
+     *         with ".mmm", ".uuuuuu" or ".nnnnnnnnn" appended for sub-second times
+     */
+    std::string format_timestamp(Timestamp ts);
+
+    /// Buffer size that fits any output of format_timestamp(), including the terminator
+    constexpr size_t kTimestampBufferSize = 32;
+
+    /**
+     * @brief Formats a timestamp into a caller-provided buffer (no allocation)
+     * @param ts Timestamp to format
+     * @param buffer Destination of at least kTimestampBufferSize characters
+     * @return Number of characters written, excluding the terminating '\0'
+     */
+    size_t format_timestamp(Timestamp ts, char* buffer);
+
+    /**
+     * @brief Days since 1970-01-01 for a proleptic Gregorian calendar date
+     */
+    int64_t days_from_civil(int64_t year, unsigned month, unsigned day);
+
+    /**
+     * @brief Days since 1970-01-01 of the UTC day containing ts
+     */
+    inline int64_t days_since_epoch(Timestamp ts) {
+        const int64_t days = ts / kNanosPerDay;
+        return (ts % kNanosPerDay < 0) ? days - 1 : days;
+    }
+
+    /**
+     * @brief Midnight (UTC) of the day containing ts
+     */
+    inline Timestamp start_of_day(Timestamp ts) { return days_since_epoch(ts) * kNanosPerDay; }
+
+    /**
+     * @brief Nanoseconds since midnight (UTC), in [0, kNanosPerDay)
+     */
+    inline Timestamp time_of_day(Timestamp ts) { return ts - start_of_day(ts); }
+
+    /**
+     * @brief ISO weekday of ts (UTC): 1 = Monday ... 7 = Sunday
+     */
+    inline unsigned day_of_week(Timestamp ts) {
+        // 1970-01-01 was a Thursday
+        const int64_t offset = days_since_epoch(ts) % 7;
+        return static_cast<unsigned>((offset + 10) % 7) + 1;
+    }
+
+} // namespace backtest
+#endif // TIMESTAMP_HPP
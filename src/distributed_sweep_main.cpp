@@ -0,0 +1,175 @@
+/**
+ * @file distributed_sweep_main.cpp
+ * @brief Command-line driver for sweeps sharded across worker processes
+ *
+ * Usage:
+ *   dsweep coordinator (--symbols=FILE | --data=CSV) [--port=7878] [--grid=2:10:1,5:40:5]
+ *                      [--top=10] [--unit=256] [--rank=return|sharpe|sortino|drawdown] [--local=N]
+ *   dsweep worker [--host=localhost] [--port=7878] [--threads=0]
+ *
+ * The symbol file lists one "SYMBOL PATH" per line; every path must be
+ * readable on every worker node (shared storage or identical copies), and
+ * each worker maps the file's .bars cache, writing it on first use. The grid
+ * is "short_min:short_max:step,long_min:long_max:step". --local=N also runs N
+ * workers as threads of the coordinator process, over loopback.
+ */
+
+#include "sweep/distributed_sweep.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// Value of "--name=value", or nullptr if arg is a different option
+    const char* option_value(const char* arg, const char* name) {
+        const size_t length = std::strlen(name);
+        if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') {
+            return nullptr;
+        }
+        return arg + length + 1;
+    }
+
+    std::vector<size_t> make_range(size_t first, size_t last, size_t step) {
+        std::vector<size_t> values;
+        for (size_t v = first; v <= last; v += (step == 0 ? 1 : step)) {
+            values.push_back(v);
+        }
+        return values;
+    }
+
+    bool parse_grid(const char* text, std::vector<backtest::SmaParams>& grid) {
+        unsigned long long s[3];
+        unsigned long long l[3];
+        if (std::sscanf(text, "%llu:%llu:%llu,%llu:%llu:%llu", &s[0], &s[1], &s[2], &l[0], &l[1], &l[2]) != 6) {
+            return false;
+        }
+        grid = backtest::SweepEngine::make_grid(make_range(s[0], s[1], s[2]), make_range(l[0], l[1], l[2]));
+        return true;
+    }
+
+    int usage() {
+        std::cerr << "Usage: dsweep coordinator (--symbols=FILE | --data=CSV) [--port=N] [--grid=S:S:S,L:L:L]\n"
+                  << "                          [--top=N] [--unit=N] [--rank=NAME] [--local=N]\n"
+                  << "       dsweep worker [--host=HOST] [--port=N] [--threads=N]" << std::endl;
+        return 1;
+    }
+
+    int run_worker(int argc, char** argv) {
+        std::string host = "localhost";
+        uint16_t port = backtest::kDefaultSweepPort;
+        size_t threads = 0;
+        for (int i = 2; i < argc; ++i) {
+            if (const char* value = option_value(argv[i], "--host")) {
+                host = value;
+            } else if (const char* value = option_value(argv[i], "--port")) {
+                port = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+            } else if (const char* value = option_value(argv[i], "--threads")) {
+                threads = std::strtoull(value, nullptr, 10);
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                return usage();
+            }
+        }
+        backtest::SweepWorker worker(threads);
+        const bool ok = worker.run(host, port);
+        std::cout << "Worker finished " << worker.units_done() << " units" << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    int run_coordinator(int argc, char** argv) {
+        std::vector<backtest::SweepSymbol> symbols;
+        std::vector<backtest::SmaParams> grid;
+        parse_grid("2:10:1,5:40:5", grid);
+        backtest::DistributedSweepConfig config;
+        uint16_t port = backtest::kDefaultSweepPort;
+        size_t local_workers = 0;
+        for (int i = 2; i < argc; ++i) {
+            if (const char* value = option_value(argv[i], "--symbols")) {
+                if (!backtest::load_symbol_list(value, symbols)) {
+                    return 1;
+                }
+            } else if (const char* value = option_value(argv[i], "--data")) {
+                symbols.push_back(backtest::SweepSymbol{"SPY", value});
+            } else if (const char* value = option_value(argv[i], "--port")) {
+                port = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+            } else if (const char* value = option_value(argv[i], "--grid")) {
+                if (!parse_grid(value, grid)) {
+                    std::cerr << "Invalid grid: " << value << std::endl;
+                    return usage();
+                }
+            } else if (const char* value = option_value(argv[i], "--top")) {
+                config.top_k = std::strtoull(value, nullptr, 10);
+            } else if (const char* value = option_value(argv[i], "--unit")) {
+                config.params_per_unit = std::strtoull(value, nullptr, 10);
+            } else if (const char* value = option_value(argv[i], "--rank")) {
+                if (!backtest::parse_sweep_ranking(value, config.sweep.rank_by)) {
+                    std::cerr << "Unknown ranking: " << value << " (expected return, sharpe, sortino or drawdown)"
+                              << std::endl;
+                    return 1;
+                }
+            } else if (const char* value = option_value(argv[i], "--local")) {
+                local_workers = std::strtoull(value, nullptr, 10);
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                return usage();
+            }
+        }
+        if (symbols.empty()) {
+            std::cerr << "No symbols given" << std::endl;
+            return usage();
+        }
+
+        backtest::SweepCoordinator coordinator(symbols, grid, config);
+        if (!coordinator.listen(port)) {
+            return 1;
+        }
+        std::cout << "Coordinator on port " << coordinator.port() << ": " << symbols.size() << " symbols x "
+                  << grid.size() << " window combinations in " << coordinator.units() << " units" << std::endl;
+
+        // Local workers split the cores between them
+        std::vector<std::thread> workers;
+        const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t threads = std::max<size_t>(cores / std::max<size_t>(local_workers, 1), 1);
+        const uint16_t bound = coordinator.port();
+        for (size_t i = 0; i < local_workers; ++i) {
+            workers.emplace_back([threads, bound] {
+                backtest::SweepWorker worker(threads);
+                worker.run("127.0.0.1", bound);
+            });
+        }
+
+        const std::vector<backtest::DistributedResult> results = coordinator.run(&std::cerr);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        const backtest::DistributedSweepStats& stats = coordinator.stats();
+        backtest::print_distributed_results(std::cout, results);
+        std::cout << "----------------------------------------" << std::endl;
+        std::cout << stats.runs << " runs on " << stats.workers << " workers in " << stats.seconds * 1e3 << " ms ("
+                  << stats.bars_per_second() / 1e6 << " M bars/s) | " << stats.completed << "/" << stats.units
+                  << " units, " << stats.failed << " failed, " << stats.requeued << " requeued, "
+                  << stats.speculative << " speculative, " << stats.lost_workers << " workers lost" << std::endl;
+        return stats.failed == 0 ? 0 : 1;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage();
+    }
+    if (std::strcmp(argv[1], "coordinator") == 0) {
+        return run_coordinator(argc, argv);
+    }
+    if (std::strcmp(argv[1], "worker") == 0) {
+        return run_worker(argc, argv);
+    }
+    return usage();
+}
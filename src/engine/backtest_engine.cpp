@@ -0,0 +1,40 @@
+/**
+ * @file backtest_engine.cpp
+ * @brief Order sizing and the instantiation of the dynamic backtest engine
+ */
+
+#include "backtest_engine.hpp"
+#include <climits>
+#include <cmath>
+
+namespace backtest {
+
+template class BasicBacktestEngine<Strategy>;
+
+int affordable_quantity(const ExecutionModel& execution, const OrderEvent& probe, const Bar& bar,
+                        double budget) {
+    OrderEvent buy = probe;
+    buy.quantity = 1;
+    const double price = execution.fill_price(buy, bar);
+    if (!(price > 0.0) || !(budget > 0.0)) {
+        return 0;
+    }
+
+    double shares = std::floor(budget / price);
+    if (shares > INT_MAX) {
+        shares = INT_MAX;
+    }
+    int quantity = static_cast<int>(shares);
+    // Commission may depend on the size; shrink until the whole fill is affordable
+    while (quantity > 0) {
+        const double fee = execution.commission(quantity, price);
+        if (quantity * price + fee <= budget) {
+            break;
+        }
+        const double fitting = std::floor((budget - fee) / price);
+        quantity = fitting < quantity ? static_cast<int>(std::fmax(fitting, 0.0)) : quantity - 1;
+    }
+    return quantity;
+}
+
+} // namespace backtest
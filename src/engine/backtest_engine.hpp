@@ -0,0 +1,369 @@
+/**
+ * @file backtest_engine.hpp
+ * @brief Event-driven backtest loop connecting a Strategy to a Portfolio
+ *
+ * The engine replays bars through a Strategy, turns BUY/SELL signals into
+ * sized orders, prices them with an ExecutionModel and books the fills in a
+ * Portfolio, recording the portfolio value after every bar. All events go
+ * through one preallocated EventQueue, so the per-bar loop does not allocate.
+ * The engine is a template on the strategy type so that statically
+ * dispatched strategies can be inlined into the loop.
+ */
+
+#ifndef BACKTEST_ENGINE_HPP
+#define BACKTEST_ENGINE_HPP
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <utility>
+#include "event.hpp"
+#include "equity_curve.hpp"
+#include "execution_model.hpp"
+#include "performance_tracker.hpp"
+#include "../data/bar_store.hpp"
+#include "../data/compact_bar_store.hpp"
+#include "../data/data_handler.hpp"
+#include "../portfolio/portfolio.hpp"
+#include "../strategy/strategy_base.hpp"
+#include "../util/profiler.hpp"
+#include "../util/snapshot.hpp"
+
+namespace backtest {
+
+/**
+ * @struct EngineConfig
+ * @brief Settings of one BacktestEngine run
+ */
+struct EngineConfig {
+    double initial_capital = 100000.0;  ///< Starting cash of the Portfolio
+    double allocation = 1.0;            ///< Fraction of cash committed by each entry (0, 1]
+    size_t event_capacity = 64;         ///< Slots of the event ring
+    double periods_per_year = kDefaultPeriodsPerYear;  ///< Bars per year, for annualized metrics
+    bool record_equity = true;          ///< Keep the per-bar equity curve (metrics are tracked either way)
+};
+
+/**
+ * @struct EngineStats
+ * @brief Counters and timing of the last run
+ */
+struct EngineStats {
+    size_t bars = 0;            ///< Market events processed
+    size_t events = 0;          ///< Events dispatched, of any type
+    size_t signals = 0;         ///< BUY/SELL signals emitted by the strategy
+    size_t orders = 0;          ///< Orders sent to the execution model
+    size_t fills = 0;           ///< Fills booked in the portfolio
+    size_t events_dropped = 0;  ///< Events lost because the ring was full
+    double commission = 0.0;    ///< Total commission paid
+    double slippage = 0.0;      ///< Total cost of slippage
+    double seconds = 0.0;       ///< Wall time of the loop
+
+    double bars_per_second() const { return seconds > 0.0 ? bars / seconds : 0.0; }
+};
+
+/**
+ * @brief Largest share count whose fill price and commission fit in budget
+ * @param execution Model pricing the order
+ * @param probe Order to size (its quantity is ignored)
+ * @param bar Bar the order executes on
+ * @param budget Cash available for the entry
+ */
+int affordable_quantity(const ExecutionModel& execution, const OrderEvent& probe, const Bar& bar,
+                        double budget);
+
+/**
+ * @class BasicBacktestEngine
+ * @brief Runs one strategy against one portfolio, bar by bar
+ * @tparam StrategyT Strategy (virtual calls) or a StaticStrategy type (direct calls)
+ *
+ * For every bar the engine pushes a market event and drains the queue:
+ * - Market: marks the held position at the close, feeds the bar to the
+ *   strategy and emits a signal event for BUY or SELL.
+ * - Signal: BUY while flat buys as many shares as allocation * cash covers
+ *   including commission; SELL while long sells the whole position. Other
+ *   signals are ignored (the engine trades long/flat, like SweepEngine).
+ * - Order: priced by the ExecutionModel against the current bar.
+ * - Fill: booked with Portfolio::open_position() or close_position().
+ * Then Portfolio::total_value() is fed to the PerformanceTracker and, unless
+ * EngineConfig::record_equity is off, appended to the equity curve.
+ *
+ * The strategy is fed bar by bar because fills feed back into the state
+ * between bars. With StrategyT = Strategy (the BacktestEngine alias) each bar
+ * costs two virtual calls, which keeps plugins possible; instantiating the
+ * engine on a concrete StaticStrategy type lets the compiler inline the
+ * strategy into the loop. Both produce the same results for strategies that
+ * produce the same signals.
+ *
+ * The strategy and execution model are borrowed and must outlive the engine;
+ * use a fresh strategy for every run() and the same one, continued or restored
+ * with load_state(), for resume(). The portfolio, event ring and equity
+ * curve are allocated from the resource given at construction, typically the
+ * same per-run arena as the strategy's.
+ */
+template <typename StrategyT>
+class BasicBacktestEngine {
+public:
+    /// Called after the strategy has seen each bar, with the signal it produced
+    using BarListener = std::function<void(const Bar& bar, const Signal& signal)>;
+    /// Called for every fill after it has been booked
+    using FillListener = std::function<void(const FillEvent& fill)>;
+
+    BasicBacktestEngine(StrategyT& strategy, const ExecutionModel& execution,
+                        const EngineConfig& config = EngineConfig(),
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : strategy_(strategy), execution_(execution), config_(config), resource_(resource),
+          portfolio_(config.initial_capital, resource), queue_(config.event_capacity, resource),
+          equity_(resource), performance_(config.initial_capital, config.periods_per_year) {
+        if (!(config_.allocation > 0.0) || config_.allocation > 1.0) {
+            config_.allocation = 1.0;
+        }
+    }
+
+    /**
+     * @brief Replays every remaining bar of data (loaded or streaming)
+     * @return Counters of the run
+     */
+    const EngineStats& run(DataHandler& data) {
+        begin(data.is_streaming() ? 0 : data.size() - data.position());
+        while (data.has_next()) {
+            process_bar(data.get_next_bar());
+        }
+        return finish();
+    }
+
+    /**
+     * @brief Replays the remaining bars of data without resetting the portfolio
+     * @return Counters of this call
+     *
+     * Continues from the current portfolio and strategy state, e.g. after
+     * load_state() or an earlier run over a prefix of the data, so only the
+     * bars not seen yet are processed. Stats and the equity curve cover the
+     * bars of this call only; metrics() continue across calls.
+     */
+    const EngineStats& resume(DataHandler& data) {
+        begin(data.is_streaming() ? 0 : data.size() - data.position(), false);
+        while (data.has_next()) {
+            process_bar(data.get_next_bar());
+        }
+        return finish();
+    }
+
+    /**
+     * @brief Replays bars, oldest first
+     */
+    const EngineStats& run(const BarColumns& bars) {
+        begin(bars.size());
+        for (size_t i = 0; i < bars.size(); ++i) {
+            process_bar(bars.bar(i));
+        }
+        return finish();
+    }
+
+    /**
+     * @brief Replays reduced-precision bars, oldest first, decoding each row once
+     */
+    template <typename Codec>
+    const EngineStats& run(const BasicCompactBarStore<Codec>& bars) {
+        begin(bars.size());
+        for (size_t i = 0; i < bars.size(); ++i) {
+            process_bar(bars.bar(i));
+        }
+        return finish();
+    }
+
+    /**
+     * @brief Starts a run whose bars the caller feeds through step()
+     * @param expected_bars Bars to reserve equity room for (0 if unknown)
+     * @param reset_portfolio false to continue from the current portfolio, as resume() does
+     *
+     * For drivers that own the bar loop, such as Pipeline: begin(), step()
+     * for every bar and finish() do exactly what run() does.
+     */
+    void begin(size_t expected_bars, bool reset_portfolio = true) {
+        if (reset_portfolio) {
+            portfolio_ = Portfolio(config_.initial_capital, resource_);
+            performance_.reset(config_.initial_capital, config_.periods_per_year);
+        }
+        queue_.clear();
+        equity_.clear();
+        if (config_.record_equity) {
+            equity_.reserve(expected_bars);
+        }
+        stats_ = EngineStats{};
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Runs the event chain of one bar (between begin() and finish())
+     */
+    void step(const Bar& bar) { process_bar(bar); }
+
+    /**
+     * @brief Ends a run started with begin()
+     * @return Counters of the run, timed from begin()
+     */
+    const EngineStats& finish() {
+        stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        return stats_;
+    }
+
+    /**
+     * @brief Installs a callback invoked for every bar (e.g. for printing); pass {} to remove
+     */
+    void set_bar_listener(BarListener listener) { listener_ = std::move(listener); }
+
+    /**
+     * @brief Installs a callback invoked for every fill (e.g. for a trade log); pass {} to remove
+     */
+    void set_fill_listener(FillListener listener) { fill_listener_ = std::move(listener); }
+
+    /**
+     * @brief Appends the portfolio, metrics and strategy state after the last processed bar
+     * @return false if the strategy does not support checkpoints
+     *
+     * The event ring is always empty between bars and is not saved.
+     */
+    bool save_state(SnapshotWriter& out) const {
+        portfolio_.save_state(out);
+        performance_.save_state(out);
+        return strategy_.save_state(out);
+    }
+
+    /**
+     * @brief Restores a state written by save_state(); follow with resume()
+     * @return false, leaving the portfolio and metrics unchanged, if the snapshot does not
+     *         fit (the strategy may then have been restored already)
+     */
+    bool load_state(SnapshotReader& in) {
+        Portfolio portfolio(config_.initial_capital, resource_);
+        PerformanceTracker performance;
+        if (!portfolio.load_state(in) || !performance.load_state(in) || !strategy_.load_state(in)) {
+            return false;
+        }
+        portfolio_ = std::move(portfolio);
+        performance_ = performance;
+        return true;
+    }
+
+    const Portfolio& portfolio() const { return portfolio_; }
+    const EquityCurve& equity_curve() const { return equity_; }
+    const EngineStats& stats() const { return stats_; }
+
+    /**
+     * @brief Metrics since the last run() (resume() continues them)
+     */
+    PerformanceMetrics metrics() const { return performance_.metrics(); }
+    const PerformanceTracker& performance() const { return performance_; }
+    const EngineConfig& config() const { return config_; }
+
+private:
+    void push(const Event& event) {
+        if (!queue_.push(event)) {
+            ++stats_.events_dropped;
+        }
+    }
+
+    /**
+     * @brief Runs the event chain of one bar to completion and records equity
+     */
+    void process_bar(const Bar& bar) {
+        BT_PROFILE_SCOPE(Bar);
+        BT_PROFILE_COUNT(Bars, 1);
+        push(Event::make_market(bar));
+        Event event;
+        while (queue_.pop(event)) {
+            ++stats_.events;
+            dispatch(event, bar);
+        }
+        const double value = portfolio_.total_value();
+        if (config_.record_equity) {
+            equity_.record(bar.timestamp, value);
+        }
+        performance_.on_bar(value);
+    }
+
+    void dispatch(const Event& event, const Bar& bar) {
+        switch (event.type) {
+        case EventType::Market: {
+            const Bar& market = event.market;
+            ++stats_.bars;
+            portfolio_.update_price(market.symbol_id, market.close);
+            strategy_.on_new_bar(market);
+            const Signal signal = strategy_.generate_signal();
+            if (listener_) {
+                listener_(market, signal);
+            }
+            if (signal.type != SignalType::HOLD) {
+                ++stats_.signals;
+                BT_PROFILE_COUNT(Signals, 1);
+                push(Event::make_signal(SignalEvent{market.symbol_id, signal}));
+            }
+            break;
+        }
+        case EventType::Signal: {
+            BT_PROFILE_SCOPE(Execution);
+            const SignalEvent& signal = event.signal;
+            const Position* held = portfolio_.get_position(signal.symbol_id);
+            OrderEvent order{bar.timestamp, signal.symbol_id, 0, bar.close};
+            if (signal.signal.type == SignalType::BUY && held == nullptr) {
+                order.quantity = affordable_quantity(execution_, order, bar,
+                                                     portfolio_.cash() * config_.allocation);
+            } else if (signal.signal.type == SignalType::SELL && held != nullptr && held->quantity() > 0) {
+                order.quantity = -held->quantity();
+            }
+            if (order.quantity != 0) {
+                ++stats_.orders;
+                push(Event::make_order(order));
+            }
+            break;
+        }
+        case EventType::Order: {
+            BT_PROFILE_SCOPE(Execution);
+            push(Event::make_fill(execution_.execute(event.order, bar)));
+            break;
+        }
+        case EventType::Fill: {
+            const FillEvent& fill = event.fill;
+            performance_.on_fill(fill.quantity * fill.price);
+            if (fill.quantity > 0) {
+                portfolio_.open_position(fill.symbol_id, fill.quantity, fill.price, fill.commission);
+            } else {
+                const double realized = portfolio_.realized_pnl();
+                portfolio_.close_position(fill.symbol_id, -fill.quantity, fill.price, fill.commission);
+                performance_.on_round_trip(portfolio_.realized_pnl() - realized);
+            }
+            ++stats_.fills;
+            BT_PROFILE_COUNT(Fills, 1);
+            stats_.commission += fill.commission;
+            stats_.slippage += fill.slippage;
+            if (fill_listener_) {
+                fill_listener_(fill);
+            }
+            break;
+        }
+        }
+    }
+
+    StrategyT& strategy_;
+    const ExecutionModel& execution_;
+    EngineConfig config_;
+    std::pmr::memory_resource* resource_;
+    Portfolio portfolio_;
+    EventQueue queue_;
+    EquityCurve equity_;
+    PerformanceTracker performance_;
+    EngineStats stats_;
+    std::chrono::steady_clock::time_point start_;
+    BarListener listener_;
+    FillListener fill_listener_;
+};
+
+/// Engine over the virtual Strategy interface
+using BacktestEngine = BasicBacktestEngine<Strategy>;
+
+// The dynamic engine is compiled once, in backtest_engine.cpp
+extern template class BasicBacktestEngine<Strategy>;
+
+} // namespace backtest
+
+#endif // BACKTEST_ENGINE_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Reading and writing checkpoint files
+ */
+
+#include "checkpoint.hpp"
+#include "../data/bar_cache.hpp"
+#include "../util/snapshot.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+
+} // namespace
+
+bool save_checkpoint(const std::string& path, const BacktestEngine& engine, const DataHandler& data) {
+    SnapshotWriter payload;
+    data.save_cursor(payload);
+    if (!engine.save_state(payload)) {
+        std::cerr << "Strategy does not support checkpoints" << std::endl;
+        return false;
+    }
+
+    CheckpointHeader header{};
+    header.magic = kCheckpointMagic;
+    header.version = kCheckpointVersion;
+    header.byte_order = kByteOrderMark;
+    header.payload_size = payload.size();
+    header.payload_checksum = checksum_bytes(payload.bytes().data(), payload.size());
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error writing checkpoint: " << path << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.bytes().data(), static_cast<std::streamsize>(payload.size()));
+        out.flush();
+        if (!out) {
+            out.close();
+            std::remove(tmp_path.c_str());
+            std::cerr << "Error writing checkpoint: " << path << std::endl;
+            return false;
+        }
+    }
+
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        std::cerr << "Error writing checkpoint: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool load_checkpoint(const std::string& path, BacktestEngine& engine, DataHandler& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error opening checkpoint: " << path << std::endl;
+        return false;
+    }
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    CheckpointHeader header{};
+    if (bytes.size() < sizeof(header)) {
+        std::cerr << "Checkpoint is truncated: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != kCheckpointMagic || header.byte_order != kByteOrderMark) {
+        std::cerr << "Not a checkpoint file: " << path << std::endl;
+        return false;
+    }
+    if (header.version != kCheckpointVersion) {
+        std::cerr << "Unsupported checkpoint version " << header.version << ": " << path << std::endl;
+        return false;
+    }
+    const char* payload = bytes.data() + sizeof(header);
+    if (header.payload_size != bytes.size() - sizeof(header) ||
+        header.payload_checksum != checksum_bytes(payload, header.payload_size)) {
+        std::cerr << "Checkpoint is corrupt: " << path << std::endl;
+        return false;
+    }
+
+    SnapshotReader reader(payload, header.payload_size);
+    if (!data.load_cursor(reader)) {
+        return false;
+    }
+    if (!engine.load_state(reader) || reader.remaining() != 0) {
+        std::cerr << "Checkpoint does not match the strategy: " << path << std::endl;
+        data.reset();
+        return false;
+    }
+    return true;
+}
+
+} // namespace backtest
@@ -0,0 +1,69 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Checkpoint files for resuming a backtest after new bars arrive
+ *
+ * A checkpoint holds everything a BacktestEngine run needs to continue after
+ * its last processed bar: the DataHandler cursor, the Portfolio, the running
+ * performance metrics and the strategy's indicator state. When new bars are
+ * appended to a history file, the next run reloads the file, restores the
+ * checkpoint and processes only the new bars, with results identical to
+ * replaying the whole file.
+ *
+ * Layout (native byte order):
+ *
+ *   CheckpointHeader
+ *   payload : DataHandler::save_cursor(), then BacktestEngine::save_state()
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+#include <cstdint>
+#include <string>
+#include "backtest_engine.hpp"
+#include "../data/data_handler.hpp"
+
+namespace backtest {
+
+/// File signature of a checkpoint (the bytes "BTCHKPNT" read as a little-endian integer)
+constexpr uint64_t kCheckpointMagic = 0x544E504B48435442ULL;
+
+/// Format version; bumped whenever the payload of any component changes
+constexpr uint32_t kCheckpointVersion = 2;
+
+/**
+ * @struct CheckpointHeader
+ * @brief Fixed-size header at offset 0 of a checkpoint file
+ */
+struct CheckpointHeader {
+    uint64_t magic;             ///< kCheckpointMagic
+    uint32_t version;           ///< kCheckpointVersion
+    uint32_t byte_order;        ///< 0x01020304 as written by the producing machine
+    uint64_t payload_size;      ///< Bytes following the header
+    uint64_t payload_checksum;  ///< checksum_bytes() of the payload
+};
+
+/**
+ * @brief Writes the state after the last bar processed by engine to path
+ * @return false if the strategy does not support checkpoints or the file
+ *         could not be written
+ *
+ * The file is written next to path and renamed over it, so an interrupted
+ * save never leaves a truncated checkpoint behind.
+ */
+bool save_checkpoint(const std::string& path, const BacktestEngine& engine, const DataHandler& data);
+
+/**
+ * @brief Restores a checkpoint into engine and positions data after the checkpointed bars
+ * @param engine Engine over a strategy of the kind (and windows) that was saved
+ * @param data Handler with the data of the checkpointed run loaded, possibly
+ *             with bars appended since
+ * @return false if the file is missing, corrupt, of another version or does
+ *         not match the strategy or the data; problems are reported on std::cerr
+ *
+ * Follow a successful load with BacktestEngine::resume(data).
+ */
+bool load_checkpoint(const std::string& path, BacktestEngine& engine, DataHandler& data);
+
+} // namespace backtest
+
+#endif // CHECKPOINT_HPP
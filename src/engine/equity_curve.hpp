@@ -0,0 +1,72 @@
+/**
+ * @file equity_curve.hpp
+ * @brief Per-bar record of portfolio value
+ */
+
+#ifndef EQUITY_CURVE_HPP
+#define EQUITY_CURVE_HPP
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include "../data/timestamp.hpp"
+#include "../util/span.hpp"
+
+namespace backtest {
+
+/**
+ * @class EquityCurve
+ * @brief Columns of (timestamp, total portfolio value), one row per bar
+ *
+ * BacktestEngine reserves room for every bar before the loop when the number
+ * of bars is known, so recording is a pair of stores.
+ */
+class EquityCurve {
+public:
+    explicit EquityCurve(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : timestamps_(resource), values_(resource) {}
+
+    void reserve(size_t points) {
+        timestamps_.reserve(points);
+        values_.reserve(points);
+    }
+
+    void record(Timestamp timestamp, double value) {
+        timestamps_.push_back(timestamp);
+        values_.push_back(value);
+    }
+
+    void clear() {
+        timestamps_.clear();
+        values_.clear();
+    }
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    Span<const Timestamp> timestamps() const { return timestamps_; }
+    Span<const double> values() const { return values_; }
+
+    /**
+     * @brief Largest peak-to-trough decline as a fraction of the peak (0 if none)
+     */
+    double max_drawdown() const {
+        double peak = 0.0;
+        double worst = 0.0;
+        for (double value : values_) {
+            if (value > peak) {
+                peak = value;
+            } else if (peak > 0.0 && (peak - value) / peak > worst) {
+                worst = (peak - value) / peak;
+            }
+        }
+        return worst;
+    }
+
+private:
+    std::pmr::vector<Timestamp> timestamps_;  ///< Bar time of each point
+    std::pmr::vector<double> values_;         ///< Portfolio::total_value() after the bar
+};
+
+} // namespace backtest
+
+#endif // EQUITY_CURVE_HPP
@@ -0,0 +1,182 @@
+/**
+ * @file event.hpp
+ * @brief Typed events of the backtest engine and the fixed-capacity queue that carries them
+ *
+ * One bar of market data travels through the engine as a short chain of
+ * events: the market event lets the strategy produce a signal, the signal is
+ * sized into an order, the execution model turns the order into a fill and
+ * the fill is booked in the Portfolio. Every event is a small trivially
+ * copyable record, and the queue is a preallocated ring, so dispatching
+ * events never touches the heap.
+ */
+
+#ifndef EVENT_HPP
+#define EVENT_HPP
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+#include "../data/market_data.hpp"
+#include "../strategy/strategy_base.hpp"
+
+namespace backtest {
+
+/**
+ * @enum EventType
+ * @brief Discriminator of Event
+ */
+enum class EventType {
+    Market,  ///< A new bar is available
+    Signal,  ///< The strategy produced a BUY or SELL
+    Order,   ///< A sized order waiting for execution
+    Fill     ///< An executed order to book in the portfolio
+};
+
+/**
+ * @struct SignalEvent
+ * @brief Trading signal for one symbol
+ */
+struct SignalEvent {
+    SymbolId symbol_id;  ///< Symbol the signal applies to
+    Signal signal;       ///< Signal as returned by Strategy::generate_signal()
+};
+
+/**
+ * @struct OrderEvent
+ * @brief Market order sized from a signal
+ */
+struct OrderEvent {
+    Timestamp timestamp;     ///< Time the order was placed
+    SymbolId symbol_id;      ///< Symbol to trade
+    int quantity;            ///< Shares, positive = buy, negative = sell
+    double reference_price;  ///< Price the order was sized at (the bar's close)
+};
+
+/**
+ * @struct FillEvent
+ * @brief Executed order, including its costs
+ */
+struct FillEvent {
+    Timestamp timestamp;   ///< Execution time
+    SymbolId symbol_id;    ///< Symbol traded
+    int quantity;          ///< Shares, positive = bought, negative = sold
+    double price;          ///< Execution price including slippage
+    double commission;     ///< Commission charged for the fill
+    double slippage;       ///< Cost of slippage: |quantity * (price - reference price)|
+};
+
+/**
+ * @struct Event
+ * @brief Tagged union of the engine's event payloads
+ */
+struct Event {
+    EventType type;
+    union {
+        Bar market;
+        SignalEvent signal;
+        OrderEvent order;
+        FillEvent fill;
+    };
+
+    Event() : type(EventType::Market), market() {}
+
+    static Event make_market(const Bar& bar) {
+        Event e;
+        e.type = EventType::Market;
+        e.market = bar;
+        return e;
+    }
+
+    static Event make_signal(const SignalEvent& signal) {
+        Event e;
+        e.type = EventType::Signal;
+        e.signal = signal;
+        return e;
+    }
+
+    static Event make_order(const OrderEvent& order) {
+        Event e;
+        e.type = EventType::Order;
+        e.order = order;
+        return e;
+    }
+
+    static Event make_fill(const FillEvent& fill) {
+        Event e;
+        e.type = EventType::Fill;
+        e.fill = fill;
+        return e;
+    }
+};
+
+static_assert(std::is_trivially_copyable<Event>::value,
+              "events are copied into preallocated ring slots");
+
+/**
+ * @class EventQueue
+ * @brief First-in first-out ring of events with a capacity fixed at construction
+ *
+ * Storage is rounded up to a power of two so wrapping is a mask. push() fails
+ * instead of growing when the ring is full, which keeps the engine loop free
+ * of allocations; the engine sizes the ring for the longest chain one bar can
+ * produce.
+ */
+class EventQueue {
+public:
+    /**
+     * @brief Creates an empty queue holding up to capacity events (at least 1)
+     * @param resource Memory resource for the ring storage
+     */
+    explicit EventQueue(size_t capacity = 64,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : mask_(round_up_pow2(capacity == 0 ? 1 : capacity) - 1),
+          events_(mask_ + 1, resource), head_(0), tail_(0) {}
+
+    /**
+     * @brief Appends an event
+     * @return false if the queue is full (the event is dropped)
+     */
+    bool push(const Event& event) {
+        if (size() > mask_) {
+            return false;
+        }
+        events_[tail_ & mask_] = event;
+        ++tail_;
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest event into out
+     * @return false if the queue is empty
+     */
+    bool pop(Event& out) {
+        if (head_ == tail_) {
+            return false;
+        }
+        out = events_[head_ & mask_];
+        ++head_;
+        return true;
+    }
+
+    void clear() { head_ = tail_ = 0; }
+
+    size_t size() const { return tail_ - head_; }
+    size_t capacity() const { return mask_ + 1; }
+    bool empty() const { return head_ == tail_; }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    size_t mask_;                      ///< Physical size - 1 (physical size is a power of two)
+    std::pmr::vector<Event> events_;   ///< Ring storage
+    size_t head_;                      ///< Events popped so far
+    size_t tail_;                      ///< Events pushed so far
+};
+
+} // namespace backtest
+
+#endif // EVENT_HPP
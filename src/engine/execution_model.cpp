@@ -0,0 +1,35 @@
+/**
+ * @file execution_model.cpp
+ * @brief Implementation of the fill simulation
+ */
+
+#include "execution_model.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace backtest {
+
+FillEvent ExecutionModel::execute(const OrderEvent& order, const Bar& bar) const {
+    const double price = fill_price(order, bar);
+    FillEvent fill;
+    fill.timestamp = bar.timestamp;
+    fill.symbol_id = order.symbol_id;
+    fill.quantity = order.quantity;
+    fill.price = price;
+    fill.commission = commission(order.quantity, price);
+    fill.slippage = std::abs(order.quantity * (price - order.reference_price));
+    return fill;
+}
+
+double SimulatedExecution::fill_price(const OrderEvent& order, const Bar& bar) const {
+    const double slip = config_.slippage_bps * 1e-4;
+    return order.quantity >= 0 ? bar.close * (1.0 + slip) : bar.close * (1.0 - slip);
+}
+
+double SimulatedExecution::commission(int quantity, double /*price*/) const {
+    const double fee = config_.commission_per_order + config_.commission_per_share * std::abs(quantity);
+    return std::max(config_.commission_min, fee);
+}
+
+} // namespace backtest
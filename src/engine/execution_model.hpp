@@ -0,0 +1,77 @@
+/**
+ * @file execution_model.hpp
+ * @brief Pluggable fill simulation: execution price and commission of an order
+ */
+
+#ifndef EXECUTION_MODEL_HPP
+#define EXECUTION_MODEL_HPP
+#include "event.hpp"
+
+namespace backtest {
+
+/**
+ * @class ExecutionModel
+ * @brief Decides at what price and cost an order is filled
+ *
+ * The engine asks the model to price every order against the bar that
+ * produced it, and also uses commission() to size orders so that a fill
+ * never spends more cash than is available. Implementations must be
+ * deterministic and must not allocate.
+ */
+class ExecutionModel {
+public:
+    virtual ~ExecutionModel() = default;
+
+    /**
+     * @brief Execution price of an order placed on bar
+     */
+    virtual double fill_price(const OrderEvent& order, const Bar& bar) const = 0;
+
+    /**
+     * @brief Commission for trading quantity shares (any sign) at price
+     */
+    virtual double commission(int quantity, double price) const = 0;
+
+    /**
+     * @brief Executes an order in full on bar
+     */
+    FillEvent execute(const OrderEvent& order, const Bar& bar) const;
+};
+
+/**
+ * @struct CostModelConfig
+ * @brief Parameters of SimulatedExecution
+ */
+struct CostModelConfig {
+    double commission_per_order = 0.0;  ///< Fixed commission per fill
+    double commission_per_share = 0.0;  ///< Commission per share traded
+    double commission_min = 0.0;        ///< Lower bound of the commission of a fill
+    double slippage_bps = 0.0;          ///< Adverse price move in basis points of the close
+};
+
+/**
+ * @class SimulatedExecution
+ * @brief Fills at the bar's close moved against the order by a fixed slippage
+ *
+ * Buys pay close * (1 + slippage_bps / 10000), sells receive
+ * close * (1 - slippage_bps / 10000). The commission is
+ * max(commission_min, commission_per_order + commission_per_share * |quantity|).
+ * The default configuration fills at the close for free, like the
+ * parameter sweep.
+ */
+class SimulatedExecution : public ExecutionModel {
+public:
+    explicit SimulatedExecution(const CostModelConfig& config = CostModelConfig()) : config_(config) {}
+
+    double fill_price(const OrderEvent& order, const Bar& bar) const override;
+    double commission(int quantity, double price) const override;
+
+    const CostModelConfig& config() const { return config_; }
+
+private:
+    CostModelConfig config_;
+};
+
+} // namespace backtest
+
+#endif // EXECUTION_MODEL_HPP
@@ -0,0 +1,44 @@
+/**
+ * @file performance_tracker.cpp
+ * @brief Metrics derived from the running aggregates of a PerformanceTracker
+ */
+
+#include "performance_tracker.hpp"
+#include <cmath>
+
+namespace backtest {
+
+PerformanceMetrics PerformanceTracker::metrics() const {
+    State s = state_;
+    if (s.flat_bars != 0) {
+        fold_flat_bars(s);
+    }
+    PerformanceMetrics m;
+    m.bars = static_cast<size_t>(s.bars);
+    m.round_trips = static_cast<size_t>(s.round_trips);
+    m.total_return = s.initial_value != 0.0 ? s.last_value / s.initial_value - 1.0 : 0.0;
+    m.max_drawdown = s.max_drawdown;
+    if (s.bars == 0) {
+        return m;
+    }
+
+    const double n = static_cast<double>(s.bars);
+    const double annualize = std::sqrt(s.periods_per_year);
+    m.mean_return = s.mean;
+    m.volatility = s.bars > 1 ? std::sqrt(s.m2 / (n - 1.0)) : 0.0;
+    m.sharpe = m.volatility > 0.0 ? s.mean / m.volatility * annualize : 0.0;
+    const double downside = std::sqrt(s.downside_squares / n);
+    m.sortino = downside > 0.0 ? s.mean / downside * annualize : 0.0;
+    const double mean_value = s.value_sum / n;
+    m.turnover = mean_value > 0.0 ? s.traded / mean_value : 0.0;
+    m.hit_rate = s.round_trips > 0 ? static_cast<double>(s.wins) / static_cast<double>(s.round_trips) : 0.0;
+    return m;
+}
+
+void print_performance(std::ostream& os, const PerformanceMetrics& metrics) {
+    os << "Sharpe: " << metrics.sharpe << " | Sortino: " << metrics.sortino
+       << " | Turnover: " << metrics.turnover << "x | Hit rate: " << metrics.hit_rate * 100.0 << "% ("
+       << metrics.round_trips << " round trips)" << std::endl;
+}
+
+} // namespace backtest
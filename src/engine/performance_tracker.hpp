@@ -0,0 +1,193 @@
+/**
+ * @file performance_tracker.hpp
+ * @brief Risk and trading metrics of a run, accumulated in one pass over its bars
+ *
+ * PerformanceTracker consumes the portfolio value after every bar and every
+ * fill, and keeps only running aggregates (Welford mean and variance of the
+ * per-bar returns, the downside sum of squares, the running peak, traded
+ * notional), so its size does not depend on the length of the run and no
+ * equity curve has to be stored and reprocessed to rank or report a run.
+ *
+ * on_bar() runs inside the per-bar loops of the engine and of every sweep
+ * run, so it is written without data-dependent branches (the sign of a
+ * return is as unpredictable as a coin flip), and a flat portfolio's zero
+ * returns are only counted: a run of them is folded into the moments at
+ * once with the pairwise form of Welford's update (Chan et al.).
+ */
+
+#ifndef PERFORMANCE_TRACKER_HPP
+#define PERFORMANCE_TRACKER_HPP
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "../util/snapshot.hpp"
+
+namespace backtest {
+
+/// Bars per year assumed when annualizing (daily bars)
+constexpr double kDefaultPeriodsPerYear = 252.0;
+
+/**
+ * @struct PerformanceMetrics
+ * @brief Summary of a run, as of the last bar seen by a PerformanceTracker
+ *
+ * Returns are simple per-bar returns of the portfolio value; Sharpe and
+ * Sortino use a zero risk-free rate and are annualized with
+ * sqrt(periods_per_year).
+ */
+struct PerformanceMetrics {
+    size_t bars = 0;              ///< Bars seen
+    double total_return = 0.0;    ///< Last value / initial value - 1
+    double mean_return = 0.0;     ///< Mean per-bar return
+    double volatility = 0.0;      ///< Sample standard deviation of the per-bar returns
+    double sharpe = 0.0;          ///< Annualized mean / volatility (0 if volatility is 0)
+    double sortino = 0.0;         ///< Annualized mean / downside deviation (0 if no down bars)
+    double max_drawdown = 0.0;    ///< Largest peak-to-trough decline as a fraction of the peak
+    double turnover = 0.0;        ///< Traded notional / mean portfolio value
+    double hit_rate = 0.0;        ///< Winning round trips / round trips (0 if none)
+    size_t round_trips = 0;       ///< Closing fills seen
+};
+
+/**
+ * @class PerformanceTracker
+ * @brief O(1)-per-bar accumulator of PerformanceMetrics
+ *
+ * Call on_bar() with the portfolio value after every bar, on_fill() with
+ * the notional of every fill and on_round_trip() with the realized P&L of
+ * every closing fill. The tracker holds a fixed set of doubles and counters,
+ * which save_state() writes as one block for checkpoints.
+ */
+class PerformanceTracker {
+public:
+    explicit PerformanceTracker(double initial_value = 0.0, double periods_per_year = kDefaultPeriodsPerYear) {
+        reset(initial_value, periods_per_year);
+    }
+
+    /**
+     * @brief Starts over from a portfolio worth initial_value
+     */
+    void reset(double initial_value, double periods_per_year = kDefaultPeriodsPerYear) {
+        state_ = State{};
+        state_.initial_value = initial_value;
+        state_.last_value = initial_value;
+        // The starting value is the first peak, so flat bars before any move keep the invariant below
+        state_.peak = initial_value;
+        state_.periods_per_year = periods_per_year > 0.0 ? periods_per_year : kDefaultPeriodsPerYear;
+    }
+
+    /**
+     * @brief Records the portfolio value after a bar
+     */
+    void on_bar(double value) {
+        State& s = state_;
+        s.value_sum += value;
+        if (value == s.last_value) {
+            // Zero return; last_value never exceeds peak, so peak and drawdown cannot change either
+            ++s.bars;
+            ++s.flat_bars;
+            return;
+        }
+        if (s.flat_bars != 0) {
+            fold_flat_bars(s);
+        }
+        const double r = s.last_value != 0.0 ? value / s.last_value - 1.0 : 0.0;
+        s.last_value = value;
+        ++s.bars;
+
+        // Welford update; the reciprocal keeps the division off the mean's dependency chain
+        const double weight = 1.0 / static_cast<double>(s.bars);
+        const double delta = r - s.mean;
+        s.mean += delta * weight;
+        s.m2 += delta * (r - s.mean);
+
+        // min(r, 0) exactly (2r / 2), without the branch compilers emit for a select
+        const double down = 0.5 * (r - std::fabs(r));
+        s.downside_squares += down * down;
+
+        // Same rule as EquityCurve::max_drawdown(); new records are rare, so only they divide
+        s.peak = value > s.peak ? value : s.peak;
+        if (s.peak - value > s.max_drawdown * s.peak && s.peak > 0.0) {
+            s.max_drawdown = (s.peak - value) / s.peak;
+        }
+    }
+
+    /**
+     * @brief Records the absolute traded value (quantity x price) of a fill
+     */
+    void on_fill(double notional) { state_.traded += notional < 0.0 ? -notional : notional; }
+
+    /**
+     * @brief Records the realized P&L of a closing fill; positive counts as a win
+     */
+    void on_round_trip(double pnl) {
+        ++state_.round_trips;
+        if (pnl > 0.0) {
+            ++state_.wins;
+        }
+    }
+
+    PerformanceMetrics metrics() const;
+
+    size_t bars() const { return static_cast<size_t>(state_.bars); }
+    double last_value() const { return state_.last_value; }
+
+    /**
+     * @brief Appends the accumulated state
+     */
+    void save_state(SnapshotWriter& out) const { out.put(state_); }
+
+    /**
+     * @brief Restores a state written by save_state(); unchanged on failure
+     */
+    bool load_state(SnapshotReader& in) {
+        State restored;
+        if (!in.get(restored)) {
+            return false;
+        }
+        state_ = restored;
+        return true;
+    }
+
+private:
+    struct State {
+        double initial_value = 0.0;
+        double periods_per_year = kDefaultPeriodsPerYear;
+        double last_value = 0.0;        ///< Value after the last bar (initial_value before any)
+        uint64_t bars = 0;
+        uint64_t flat_bars = 0;         ///< Trailing zero returns not in mean and m2 yet
+        double mean = 0.0;              ///< Mean of the other bars' returns
+        double m2 = 0.0;                ///< Sum of their squared deviations from mean
+        double downside_squares = 0.0;  ///< Sum of r^2 over bars with r < 0
+        double value_sum = 0.0;         ///< Sum of the values, for the mean value
+        double peak = 0.0;
+        double max_drawdown = 0.0;
+        double traded = 0.0;            ///< Sum of |notional| of all fills
+        uint64_t round_trips = 0;
+        uint64_t wins = 0;
+    };
+
+    /**
+     * @brief Merges the pending zero returns into mean and m2
+     */
+    static void fold_flat_bars(State& s) {
+        const double zeros = static_cast<double>(s.flat_bars);
+        const double counted = static_cast<double>(s.bars - s.flat_bars);
+        const double total = static_cast<double>(s.bars);
+        const double delta = -s.mean;
+        s.mean += delta * (zeros / total);
+        s.m2 += delta * delta * (counted * zeros / total);
+        s.flat_bars = 0;
+    }
+
+    State state_;
+};
+
+/**
+ * @brief Prints the metrics on one line ("Sharpe: ... | Sortino: ... | ...")
+ */
+void print_performance(std::ostream& os, const PerformanceMetrics& metrics);
+
+} // namespace backtest
+
+#endif // PERFORMANCE_TRACKER_HPP
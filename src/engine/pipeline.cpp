@@ -0,0 +1,229 @@
+/**
+ * @file pipeline.cpp
+ * @brief Stage threads, waiting and reporting of the pipelined backtest
+ */
+
+#include "pipeline.hpp"
+#include "../util/spsc_queue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace backtest {
+
+namespace {
+
+    /// Consumers sample their queue's depth once per this many pops
+    constexpr size_t kDepthSamplePeriod = 16;
+
+    int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * @class Waiter
+     * @brief One stage's wait loop while a queue is empty or full
+     *
+     * Backoff spins for a few hundred pauses (a neighbour stage usually
+     * catches up within that), then yields, then sleeps 20 us at a time, so an
+     * idle pipeline does not keep cores busy. BusyPoll only ever pauses.
+     */
+    class Waiter {
+    public:
+        explicit Waiter(WaitPolicy policy) : policy_(policy), rounds_(0) {}
+
+        void wait() {
+            if (policy_ == WaitPolicy::BusyPoll || rounds_ < kSpinRounds) {
+                cpu_relax();
+            } else if (rounds_ < kSpinRounds + kYieldRounds) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+            ++rounds_;
+        }
+
+        void reset() { rounds_ = 0; }
+
+    private:
+        static constexpr size_t kSpinRounds = 256;
+        static constexpr size_t kYieldRounds = 64;
+
+        WaitPolicy policy_;
+        size_t rounds_;
+    };
+
+    /**
+     * @class StageQueue
+     * @brief SpscQueue plus the producer's and consumer's occupancy counters
+     *
+     * Each counter is written by one side only; stats() is read after both
+     * stage threads have been joined.
+     */
+    template <typename T>
+    class StageQueue {
+    public:
+        StageQueue(size_t capacity, WaitPolicy policy) : queue_(capacity), policy_(policy) {}
+
+        /// Producer side: blocks (per the wait policy) while the queue is full
+        void push(const T& message) {
+            if (queue_.try_push(message)) {
+                return;
+            }
+            ++full_waits_;
+            Waiter waiter(policy_);
+            while (!queue_.try_push(message)) {
+                waiter.wait();
+            }
+        }
+
+        /// Consumer side: blocks (per the wait policy) while the queue is empty
+        void pop(T& message) {
+            if (!queue_.try_pop(message)) {
+                ++empty_waits_;
+                Waiter waiter(policy_);
+                while (!queue_.try_pop(message)) {
+                    waiter.wait();
+                }
+            }
+            if (++pops_ % kDepthSamplePeriod == 0) {
+                const size_t depth = queue_.size();
+                max_depth_ = std::max(max_depth_, depth);
+                depth_sum_ += depth;
+                ++samples_;
+            }
+        }
+
+        QueueStats stats() const {
+            QueueStats stats;
+            stats.capacity = queue_.capacity();
+            stats.max_depth = max_depth_;
+            stats.mean_depth = samples_ > 0 ? static_cast<double>(depth_sum_) / samples_ : 0.0;
+            stats.full_waits = full_waits_;
+            stats.empty_waits = empty_waits_;
+            return stats;
+        }
+
+    private:
+        SpscQueue<T> queue_;
+        WaitPolicy policy_;
+        // Producer-owned
+        alignas(kCacheLineSize) size_t full_waits_ = 0;
+        // Consumer-owned
+        alignas(kCacheLineSize) size_t empty_waits_ = 0;
+        size_t pops_ = 0;
+        size_t samples_ = 0;
+        size_t depth_sum_ = 0;
+        size_t max_depth_ = 0;
+    };
+
+} // namespace
+
+Pipeline::Pipeline(Strategy& strategy, const ExecutionModel& execution, const PipelineConfig& config,
+                   std::pmr::memory_resource* resource)
+    : strategy_(strategy), config_(config), engine_(replay_, execution, config.engine, resource) {
+    if (config_.queue_capacity < 2) {
+        config_.queue_capacity = 2;
+    }
+}
+
+const PipelineStats& Pipeline::run(DataHandler& data) {
+    stats_ = PipelineStats{};
+    StageQueue<BarMessage> bars(config_.queue_capacity, config_.wait);
+    StageQueue<SignalMessage> signals(config_.queue_capacity, config_.wait);
+
+    engine_.begin(data.is_streaming() ? 0 : data.size() - data.position());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread reader([&] {
+        BarMessage message;
+        while (data.has_next()) {
+            message.bar = data.get_next_bar();
+            message.read_ns = now_ns();
+            bars.push(message);
+        }
+        message.last = true;
+        bars.push(message);
+    });
+
+    std::thread signaller([&] {
+        BarMessage in;
+        SignalMessage out;
+        for (;;) {
+            bars.pop(in);
+            if (in.last) {
+                break;
+            }
+            strategy_.on_new_bar(in.bar);
+            out.bar = in.bar;
+            out.signal = strategy_.generate_signal();
+            out.read_ns = in.read_ns;
+            signals.push(out);
+        }
+        out.last = true;
+        signals.push(out);
+    });
+
+    SignalMessage message;
+    for (;;) {
+        signals.pop(message);
+        if (message.last) {
+            break;
+        }
+        replay_.set(message.signal);
+        engine_.step(message.bar);
+        stats_.latency_ns.record(static_cast<uint64_t>(std::max<int64_t>(now_ns() - message.read_ns, 0)));
+    }
+
+    reader.join();
+    signaller.join();
+    const EngineStats& engine = engine_.finish();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats_.bars = engine.bars;
+    stats_.bar_queue = bars.stats();
+    stats_.signal_queue = signals.stats();
+    return stats_;
+}
+
+void print_pipeline_stats(std::ostream& os, const PipelineStats& stats) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-18s %8s %9s %10s %10s %11s\n",
+                  "queue", "capacity", "max_depth", "mean_depth", "full_waits", "empty_waits");
+    os << line;
+    const QueueStats* queues[2] = {&stats.bar_queue, &stats.signal_queue};
+    const char* names[2] = {"data->strategy", "strategy->account"};
+    for (size_t i = 0; i < 2; ++i) {
+        const QueueStats& q = *queues[i];
+        std::snprintf(line, sizeof(line), "%-18s %8zu %9zu %10.1f %10zu %11zu\n",
+                      names[i], q.capacity, q.max_depth, q.mean_depth, q.full_waits, q.empty_waits);
+        os << line;
+    }
+    std::snprintf(line, sizeof(line), "bar latency (read -> booked): p50 %llu ns  p99 %llu ns  p99.9 %llu ns\n",
+                  static_cast<unsigned long long>(stats.latency_ns.quantile(0.50)),
+                  static_cast<unsigned long long>(stats.latency_ns.quantile(0.99)),
+                  static_cast<unsigned long long>(stats.latency_ns.quantile(0.999)));
+    os << line;
+}
+
+bool parse_wait_policy(const std::string& name, WaitPolicy& policy) {
+    if (name == "spin" || name == "busy") {
+        policy = WaitPolicy::BusyPoll;
+    } else if (name == "backoff") {
+        policy = WaitPolicy::Backoff;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace backtest
@@ -0,0 +1,25 @@
+/**
+ * @file precision_check.cpp
+ * @brief Printing of storage precision reports
+ */
+
+#include "precision_check.hpp"
+#include <cstdio>
+
+namespace backtest {
+
+void print_precision_report(std::ostream& os, const PrecisionReport& report) {
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "Storage: %s, %zu bars, %.1f KB vs %.1f KB double (%.0f%%)\n"
+                  "Divergence: max price %.3g | max equity %.3g | final value %.3g | realized P&L %.3g | "
+                  "fills %zu vs %zu (%s)\n",
+                  report.precision, report.bars, report.compact_bytes / 1024.0, report.double_bytes / 1024.0,
+                  report.double_bytes > 0 ? 100.0 * report.compact_bytes / report.double_bytes : 0.0,
+                  report.max_price_error, report.max_equity_error, report.final_value_error(),
+                  report.realized_pnl_error(), report.fills[0], report.fills[1],
+                  report.same_fills() ? "same" : "DIFFERENT");
+    os << line;
+}
+
+} // namespace backtest
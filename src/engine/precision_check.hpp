@@ -0,0 +1,87 @@
+/**
+ * @file precision_check.hpp
+ * @brief P&L divergence of a reduced-precision bar layout from the double path
+ *
+ * Runs the same strategy twice through BacktestEngine, once over the double
+ * columns and once over a BasicCompactBarStore built from them, and reports
+ * how far prices, fills, the equity curve and the final P&L drift apart. A
+ * layout is safe for a dataset when the trades match and the value error is
+ * within tolerance.
+ */
+
+#ifndef PRECISION_CHECK_HPP
+#define PRECISION_CHECK_HPP
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include "backtest_engine.hpp"
+#include "../data/compact_bar_store.hpp"
+
+namespace backtest {
+
+/**
+ * @struct PrecisionReport
+ * @brief Double path vs compact path of one strategy over one dataset
+ */
+struct PrecisionReport {
+    const char* precision = "double";  ///< Codec name of the compact layout
+    size_t bars = 0;
+    size_t double_bytes = 0;           ///< Bytes of the double columns
+    size_t compact_bytes = 0;          ///< Bytes of the compact columns
+    double max_price_error = 0.0;      ///< Largest |decoded close - close|
+    double final_value[2] = {0.0, 0.0};   ///< Double path, compact path
+    double realized_pnl[2] = {0.0, 0.0};
+    size_t fills[2] = {0, 0};
+    double max_equity_error = 0.0;     ///< Largest per-bar |equity difference|
+
+    double final_value_error() const { return std::fabs(final_value[1] - final_value[0]); }
+    double realized_pnl_error() const { return std::fabs(realized_pnl[1] - realized_pnl[0]); }
+    bool same_fills() const { return fills[0] == fills[1]; }
+};
+
+/**
+ * @brief Backtests reference over bars and candidate over compact, with the same settings
+ * @param reference Fresh strategy for the double path
+ * @param candidate Fresh strategy of the same kind for the compact path
+ * @pre compact was assigned from bars
+ */
+template <typename Codec>
+PrecisionReport check_storage_precision(const BarColumns& bars, const BasicCompactBarStore<Codec>& compact,
+                                        Strategy& reference, Strategy& candidate,
+                                        const ExecutionModel& execution, EngineConfig config = EngineConfig()) {
+    PrecisionReport report;
+    report.precision = Codec::name;
+    report.bars = bars.size();
+    report.double_bytes = bars.size() * (sizeof(Timestamp) + sizeof(SymbolId) + 5 * sizeof(double));
+    report.compact_bytes = compact.bytes();
+    for (size_t i = 0; i < bars.size(); ++i) {
+        report.max_price_error = std::max(report.max_price_error, std::fabs(compact.bar(i).close - bars.close[i]));
+    }
+
+    config.record_equity = true;
+    BacktestEngine exact(reference, execution, config);
+    BacktestEngine reduced(candidate, execution, config);
+    report.fills[0] = exact.run(bars).fills;
+    report.fills[1] = reduced.run(compact).fills;
+    report.final_value[0] = exact.portfolio().total_value();
+    report.final_value[1] = reduced.portfolio().total_value();
+    report.realized_pnl[0] = exact.portfolio().realized_pnl();
+    report.realized_pnl[1] = reduced.portfolio().realized_pnl();
+
+    const Span<const double> a = exact.equity_curve().values();
+    const Span<const double> b = reduced.equity_curve().values();
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+        report.max_equity_error = std::max(report.max_equity_error, std::fabs(a[i] - b[i]));
+    }
+    return report;
+}
+
+/**
+ * @brief Prints the storage saving and the divergences of a report
+ */
+void print_precision_report(std::ostream& os, const PrecisionReport& report);
+
+} // namespace backtest
+
+#endif // PRECISION_CHECK_HPP
@@ -0,0 +1,251 @@
+/**
+ * @file crossover_kernel.cpp
+ * @brief Scalar, AVX2 and NEON implementations of the SMA crossover and price widening kernels
+ */
+
+#include "crossover_kernel.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BACKTEST_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define BACKTEST_HAVE_NEON_KERNEL 1
+#include <arm_neon.h>
+#endif
+
+namespace backtest {
+
+    namespace {
+
+        /**
+         * @brief Rolling mean ending at prefix position k (same expression as RollingSum::mean)
+         */
+        inline double window_mean(const double* sums, const double* comps, size_t k, size_t window) {
+            const double sum = (sums[k] - sums[k - window]) + (comps[k] - comps[k - window]);
+            return sum / static_cast<double>(window);
+        }
+
+#ifdef BACKTEST_HAVE_AVX2_KERNEL
+        __attribute__((target("avx2")))
+        inline __m256d window_mean_avx2(const double* sums, const double* comps, size_t k,
+                                        size_t window, __m256d divisor) {
+            const __m256d sum_diff = _mm256_sub_pd(_mm256_loadu_pd(sums + k),
+                                                   _mm256_loadu_pd(sums + k - window));
+            const __m256d comp_diff = _mm256_sub_pd(_mm256_loadu_pd(comps + k),
+                                                    _mm256_loadu_pd(comps + k - window));
+            return _mm256_div_pd(_mm256_add_pd(sum_diff, comp_diff), divisor);
+        }
+
+        __attribute__((target("avx2")))
+        void sma_crossover_kernel_avx2(const double* sums, const double* comps, size_t first, size_t last,
+                                       size_t short_window, size_t long_window, int8_t* out) {
+            const __m256d short_div = _mm256_set1_pd(static_cast<double>(short_window));
+            const __m256d long_div = _mm256_set1_pd(static_cast<double>(long_window));
+
+            size_t k = first;
+            for (; k + 4 <= last; k += 4) {
+                const __m256d short_mean = window_mean_avx2(sums, comps, k, short_window, short_div);
+                const __m256d long_mean = window_mean_avx2(sums, comps, k, long_window, long_div);
+                const int above = _mm256_movemask_pd(_mm256_cmp_pd(short_mean, long_mean, _CMP_GT_OQ));
+                const int below = _mm256_movemask_pd(_mm256_cmp_pd(short_mean, long_mean, _CMP_LT_OQ));
+                for (int lane = 0; lane < 4; ++lane) {
+                    out[k - first + lane] = static_cast<int8_t>(((above >> lane) & 1) - ((below >> lane) & 1));
+                }
+            }
+            sma_crossover_kernel_scalar(sums, comps, k, last, short_window, long_window, out + (k - first));
+        }
+
+        __attribute__((target("avx2")))
+        void rolling_mean_kernel_avx2(const double* sums, const double* comps, size_t first, size_t last,
+                                      size_t window, double* out) {
+            const __m256d divisor = _mm256_set1_pd(static_cast<double>(window));
+            size_t k = first;
+            for (; k + 4 <= last; k += 4) {
+                _mm256_storeu_pd(out + (k - first), window_mean_avx2(sums, comps, k, window, divisor));
+            }
+            for (; k < last; ++k) {
+                out[k - first] = window_mean(sums, comps, k, window);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        void widen_prices_kernel_avx2(const float* in, size_t n, double* out) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256 prices = _mm256_loadu_ps(in + i);
+                _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm256_castps256_ps128(prices)));
+                _mm256_storeu_pd(out + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(prices, 1)));
+            }
+            for (; i < n; ++i) {
+                out[i] = static_cast<double>(in[i]);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        void ticks_to_prices_kernel_avx2(const int32_t* in, size_t n, double scale, double* out) {
+            const __m256d divisor = _mm256_set1_pd(scale);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256i ticks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(ticks)), divisor));
+                _mm256_storeu_pd(out + i + 4,
+                                 _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(ticks, 1)), divisor));
+            }
+            for (; i < n; ++i) {
+                out[i] = static_cast<double>(in[i]) / scale;
+            }
+        }
+
+        bool cpu_has_avx2() {
+            static const bool has_avx2 = __builtin_cpu_supports("avx2");
+            return has_avx2;
+        }
+#endif
+
+#ifdef BACKTEST_HAVE_NEON_KERNEL
+        void sma_crossover_kernel_neon(const double* sums, const double* comps, size_t first, size_t last,
+                                       size_t short_window, size_t long_window, int8_t* out) {
+            const float64x2_t short_div = vdupq_n_f64(static_cast<double>(short_window));
+            const float64x2_t long_div = vdupq_n_f64(static_cast<double>(long_window));
+
+            size_t k = first;
+            for (; k + 2 <= last; k += 2) {
+                const float64x2_t short_mean = vdivq_f64(
+                    vaddq_f64(vsubq_f64(vld1q_f64(sums + k), vld1q_f64(sums + k - short_window)),
+                              vsubq_f64(vld1q_f64(comps + k), vld1q_f64(comps + k - short_window))),
+                    short_div);
+                const float64x2_t long_mean = vdivq_f64(
+                    vaddq_f64(vsubq_f64(vld1q_f64(sums + k), vld1q_f64(sums + k - long_window)),
+                              vsubq_f64(vld1q_f64(comps + k), vld1q_f64(comps + k - long_window))),
+                    long_div);
+                const uint64x2_t above = vcgtq_f64(short_mean, long_mean);
+                const uint64x2_t below = vcltq_f64(short_mean, long_mean);
+                out[k - first] = static_cast<int8_t>((vgetq_lane_u64(above, 0) & 1) - (vgetq_lane_u64(below, 0) & 1));
+                out[k - first + 1] = static_cast<int8_t>((vgetq_lane_u64(above, 1) & 1) - (vgetq_lane_u64(below, 1) & 1));
+            }
+            sma_crossover_kernel_scalar(sums, comps, k, last, short_window, long_window, out + (k - first));
+        }
+
+        void rolling_mean_kernel_neon(const double* sums, const double* comps, size_t first, size_t last,
+                                      size_t window, double* out) {
+            const float64x2_t divisor = vdupq_n_f64(static_cast<double>(window));
+            size_t k = first;
+            for (; k + 2 <= last; k += 2) {
+                vst1q_f64(out + (k - first), vdivq_f64(
+                    vaddq_f64(vsubq_f64(vld1q_f64(sums + k), vld1q_f64(sums + k - window)),
+                              vsubq_f64(vld1q_f64(comps + k), vld1q_f64(comps + k - window))),
+                    divisor));
+            }
+            for (; k < last; ++k) {
+                out[k - first] = window_mean(sums, comps, k, window);
+            }
+        }
+
+        void widen_prices_kernel_neon(const float* in, size_t n, double* out) {
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                const float32x4_t prices = vld1q_f32(in + i);
+                vst1q_f64(out + i, vcvt_f64_f32(vget_low_f32(prices)));
+                vst1q_f64(out + i + 2, vcvt_high_f64_f32(prices));
+            }
+            for (; i < n; ++i) {
+                out[i] = static_cast<double>(in[i]);
+            }
+        }
+
+        void ticks_to_prices_kernel_neon(const int32_t* in, size_t n, double scale, double* out) {
+            const float64x2_t divisor = vdupq_n_f64(scale);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                const int32x4_t ticks = vld1q_s32(in + i);
+                vst1q_f64(out + i, vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(ticks))), divisor));
+                vst1q_f64(out + i + 2, vdivq_f64(vcvtq_f64_s64(vmovl_high_s32(ticks)), divisor));
+            }
+            for (; i < n; ++i) {
+                out[i] = static_cast<double>(in[i]) / scale;
+            }
+        }
+#endif
+
+    } // namespace
+
+    void sma_crossover_kernel_scalar(const double* sums, const double* comps, size_t first, size_t last,
+                                     size_t short_window, size_t long_window, int8_t* out) {
+        for (size_t k = first; k < last; ++k) {
+            const double short_mean = window_mean(sums, comps, k, short_window);
+            const double long_mean = window_mean(sums, comps, k, long_window);
+            out[k - first] = static_cast<int8_t>((short_mean > long_mean) - (short_mean < long_mean));
+        }
+    }
+
+    void sma_crossover_kernel(const double* sums, const double* comps, size_t first, size_t last,
+                              size_t short_window, size_t long_window, int8_t* out) {
+#if defined(BACKTEST_HAVE_AVX2_KERNEL)
+        if (cpu_has_avx2()) {
+            sma_crossover_kernel_avx2(sums, comps, first, last, short_window, long_window, out);
+            return;
+        }
+#elif defined(BACKTEST_HAVE_NEON_KERNEL)
+        sma_crossover_kernel_neon(sums, comps, first, last, short_window, long_window, out);
+        return;
+#endif
+        sma_crossover_kernel_scalar(sums, comps, first, last, short_window, long_window, out);
+    }
+
+    void rolling_mean_kernel(const double* sums, const double* comps, size_t first, size_t last,
+                             size_t window, double* out) {
+#if defined(BACKTEST_HAVE_AVX2_KERNEL)
+        if (cpu_has_avx2()) {
+            rolling_mean_kernel_avx2(sums, comps, first, last, window, out);
+            return;
+        }
+#elif defined(BACKTEST_HAVE_NEON_KERNEL)
+        rolling_mean_kernel_neon(sums, comps, first, last, window, out);
+        return;
+#endif
+        for (size_t k = first; k < last; ++k) {
+            out[k - first] = window_mean(sums, comps, k, window);
+        }
+    }
+
+    void widen_prices_kernel(const float* in, size_t n, double* out) {
+#if defined(BACKTEST_HAVE_AVX2_KERNEL)
+        if (cpu_has_avx2()) {
+            widen_prices_kernel_avx2(in, n, out);
+            return;
+        }
+#elif defined(BACKTEST_HAVE_NEON_KERNEL)
+        widen_prices_kernel_neon(in, n, out);
+        return;
+#endif
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<double>(in[i]);
+        }
+    }
+
+    void ticks_to_prices_kernel(const int32_t* in, size_t n, double scale, double* out) {
+#if defined(BACKTEST_HAVE_AVX2_KERNEL)
+        if (cpu_has_avx2()) {
+            ticks_to_prices_kernel_avx2(in, n, scale, out);
+            return;
+        }
+#elif defined(BACKTEST_HAVE_NEON_KERNEL)
+        ticks_to_prices_kernel_neon(in, n, scale, out);
+        return;
+#endif
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<double>(in[i]) / scale;
+        }
+    }
+
+    const char* sma_crossover_kernel_isa() {
+#if defined(BACKTEST_HAVE_AVX2_KERNEL)
+        return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(BACKTEST_HAVE_NEON_KERNEL)
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+} // namespace backtest
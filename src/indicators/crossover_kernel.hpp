@@ -0,0 +1,87 @@
+/**
+ * @file crossover_kernel.hpp
+ * @brief Vectorized moving-average crossover over precomputed prefix sums
+ *
+ * Also holds the kernels that widen compact price columns (see
+ * data/price_codec.hpp) back to doubles a block at a time, so the crossover
+ * and mean kernels can run over bars stored as float32 or int32 ticks.
+ *
+ * Batch counterpart of the per-bar SMA comparison. Given the compensated
+ * prefix states that RollingSum produces for a series (split into separate
+ * sum/comp arrays), the kernel compares a short and a long rolling mean for
+ * many bars at once.
+ *
+ * Every lane performs exactly the operations of RollingSum::mean() in the
+ * same order, and IEEE add/sub/div are correctly rounded in both scalar and
+ * vector units, so results are bit-for-bit identical to the streaming path.
+ */
+
+#ifndef CROSSOVER_KERNEL_HPP
+#define CROSSOVER_KERNEL_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace backtest {
+
+    /**
+     * @brief Compares two rolling means for prefix positions [first, last)
+     * @param sums Prefix sum parts; position k holds the state after k values
+     * @param comps Prefix compensation parts, same layout as sums
+     * @param first First prefix position to evaluate (must be >= max(short_window, long_window))
+     * @param last One past the last position to evaluate
+     * @param short_window Short window length (>= 1)
+     * @param long_window Long window length (>= 1)
+     * @param out Receives, for each position k, out[k - first] = +1 if the short
+     *            mean is above the long mean, -1 if below, 0 otherwise (equal or NaN)
+     *
+     * Dispatches at runtime to AVX2 (x86-64) or NEON (AArch64) when available,
+     * otherwise runs the scalar loop.
+     */
+    void sma_crossover_kernel(const double* sums, const double* comps, size_t first, size_t last,
+                              size_t short_window, size_t long_window, int8_t* out);
+
+    /**
+     * @brief Scalar reference implementation of sma_crossover_kernel()
+     */
+    void sma_crossover_kernel_scalar(const double* sums, const double* comps, size_t first, size_t last,
+                                     size_t short_window, size_t long_window, int8_t* out);
+
+    /**
+     * @brief Materializes one rolling mean for prefix positions [first, last)
+     * @param sums Prefix sum parts; position k holds the state after k values
+     * @param comps Prefix compensation parts, same layout as sums
+     * @param first First prefix position to evaluate (must be >= window)
+     * @param last One past the last position to evaluate
+     * @param window Window length (>= 1)
+     * @param out Receives out[k - first] = mean of the `window` values ending at position k
+     *
+     * Uses the same operations as RollingSum::mean(), so a mean read from the
+     * output equals the mean the streaming path computes for that bar.
+     */
+    void rolling_mean_kernel(const double* sums, const double* comps, size_t first, size_t last,
+                             size_t window, double* out);
+
+    /**
+     * @brief Widens n float32 prices to doubles (exact)
+     *
+     * A 256-bit load carries 8 float32 prices instead of 4 doubles, so the
+     * vector paths read compact columns at twice the prices per load.
+     */
+    void widen_prices_kernel(const float* in, size_t n, double* out);
+
+    /**
+     * @brief Converts n int32 tick counts to prices, out[i] = in[i] / scale
+     *
+     * Same correctly rounded division as the scalar decode, so every lane
+     * yields the same double TickPriceCodec::decode() does.
+     */
+    void ticks_to_prices_kernel(const int32_t* in, size_t n, double scale, double* out);
+
+    /**
+     * @brief Name of the implementation sma_crossover_kernel() dispatches to
+     * @return "avx2", "neon" or "scalar"
+     */
+    const char* sma_crossover_kernel_isa();
+
+} // namespace backtest
+#endif // CROSSOVER_KERNEL_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file indicator_graph.cpp
+ * @brief Implementation of the shared indicator series
+ */
+
+#include "indicator_graph.hpp"
+#include "indicators.hpp"
+#include <stdexcept>
+
+namespace backtest {
+
+IndicatorGraph::IndicatorGraph(const BarColumns& bars) : bars_(bars) {}
+
+Span<const double> IndicatorGraph::column(PriceField field) const {
+    switch (field) {
+        case PriceField::Open: return bars_.open;
+        case PriceField::High: return bars_.high;
+        case PriceField::Low: return bars_.low;
+        case PriceField::Close: return bars_.close;
+        case PriceField::Volume: return bars_.volume;
+    }
+    return bars_.close;
+}
+
+IndicatorGraph::Node& IndicatorGraph::find_or_add(const IndicatorKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<Node>& node = series_[key];
+    if (!node) {
+        node = std::make_unique<Node>();
+    }
+    return *node;
+}
+
+Span<const double> IndicatorGraph::series(const IndicatorKey& key) {
+    if (key.window == 0) {
+        throw std::invalid_argument("IndicatorGraph: window must be at least 1");
+    }
+    IndicatorKey normalized = key;
+    if (normalized.kind == IndicatorKind::Atr) {
+        normalized.field = PriceField::Close;
+    }
+
+    ++requests_;
+    Node& node = find_or_add(normalized);
+    // Other series stay available while this one is computed: the map lock is not held here
+    std::call_once(node.once, [&] {
+        compute(normalized, node.values);
+        ++series_computed_;
+        bytes_ += node.values.size() * sizeof(double);
+        node.computed.store(true, std::memory_order_release);
+    });
+    return Span<const double>(node.values.data(), node.values.size());
+}
+
+bool IndicatorGraph::contains(const IndicatorKey& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    IndicatorKey normalized = key;
+    if (normalized.kind == IndicatorKind::Atr) {
+        normalized.field = PriceField::Close;
+    }
+    const auto it = series_.find(normalized);
+    return it != series_.end() && it->second->computed.load(std::memory_order_acquire);
+}
+
+IndicatorGraphStats IndicatorGraph::stats() const {
+    IndicatorGraphStats stats;
+    stats.requests = requests_.load();
+    stats.series_computed = series_computed_.load();
+    stats.shared_computed = shared_computed_.load();
+    stats.bytes = bytes_.load();
+    return stats;
+}
+
+void IndicatorGraph::record_shared(const std::vector<double>& values) {
+    ++shared_computed_;
+    bytes_ += values.size() * sizeof(double);
+}
+
+const IndicatorGraph::Node& IndicatorGraph::prefix(PriceField field) {
+    Node& node = prefix_[static_cast<size_t>(field)];
+    std::call_once(node.once, [&] {
+        const size_t n = size();
+        node.values.resize(2 * (n + 1));
+        prefix_sum_series(column(field), 0.0, false, node.values.data(), node.values.data() + (n + 1));
+        record_shared(node.values);
+    });
+    return node;
+}
+
+const IndicatorGraph::Node& IndicatorGraph::moments(PriceField field) {
+    Node& node = moments_[static_cast<size_t>(field)];
+    std::call_once(node.once, [&] {
+        const size_t n = size();
+        const Span<const double> values = column(field);
+        const double shift = n > 0 ? values[0] : 0.0;
+        node.values.resize(4 * (n + 1));
+        double* base = node.values.data();
+        prefix_sum_series(values, shift, false, base, base + (n + 1));
+        prefix_sum_series(values, shift, true, base + 2 * (n + 1), base + 3 * (n + 1));
+        record_shared(node.values);
+    });
+    return node;
+}
+
+const IndicatorGraph::Node& IndicatorGraph::true_range() {
+    std::call_once(true_range_.once, [&] {
+        true_range_.values.resize(size());
+        true_range_series(bars_.high, bars_.low, bars_.close, Span<double>(true_range_.values));
+        record_shared(true_range_.values);
+    });
+    return true_range_;
+}
+
+void IndicatorGraph::compute(const IndicatorKey& key, std::vector<double>& out) {
+    const size_t n = size();
+    out.resize(n);
+    const Span<double> series(out);
+    switch (key.kind) {
+        case IndicatorKind::Sma: {
+            const double* sums = prefix(key.field).values.data();
+            rolling_mean_series(sums, sums + (n + 1), n, key.window, series);
+            break;
+        }
+        case IndicatorKind::Ema:
+            ema_batch(column(key.field), key.window, series);
+            break;
+        case IndicatorKind::StdDev: {
+            const double* base = moments(key.field).values.data();
+            stddev_series(base, base + (n + 1), base + 2 * (n + 1), base + 3 * (n + 1), n, key.window, series);
+            break;
+        }
+        case IndicatorKind::Min:
+            rolling_min_batch(column(key.field), key.window, series);
+            break;
+        case IndicatorKind::Max:
+            rolling_max_batch(column(key.field), key.window, series);
+            break;
+        case IndicatorKind::Atr:
+            atr_from_true_range(Span<const double>(true_range().values), key.window, series);
+            break;
+    }
+}
+
+const char* indicator_kind_name(IndicatorKind kind) {
+    switch (kind) {
+        case IndicatorKind::Sma: return "sma";
+        case IndicatorKind::Ema: return "ema";
+        case IndicatorKind::StdDev: return "stddev";
+        case IndicatorKind::Min: return "min";
+        case IndicatorKind::Max: return "max";
+        case IndicatorKind::Atr: return "atr";
+    }
+    return "unknown";
+}
+
+} // namespace backtest
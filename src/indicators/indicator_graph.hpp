@@ -0,0 +1,170 @@
+/**
+ * @file indicator_graph.hpp
+ * @brief Per-dataset registry of indicator series, computed lazily and shared
+ *
+ * Strategies that run over the same bars tend to ask for the same
+ * indicators: a sweep's configurations share windows, and an ATR stop and a
+ * volatility filter both need true ranges. IndicatorGraph owns every series
+ * derived from one BarColumns. A series is computed with the batch kernels
+ * the first time it is asked for and returned from memory afterwards, and
+ * the intermediate results indicators have in common are graph nodes of
+ * their own, built once per dataset:
+ *
+ *   field -> prefix sums          -> SMA(w)
+ *   field -> shifted moment sums  -> StdDev(w)
+ *   high, low, close -> true range -> ATR(w)
+ *   field -> EMA(w), Min(w), Max(w)
+ *
+ * Every series is bit-identical to feeding the bars one by one to the
+ * corresponding streaming indicator (indicators.hpp).
+ */
+
+#ifndef INDICATOR_GRAPH_HPP
+#define INDICATOR_GRAPH_HPP
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "../data/bar_store.hpp"
+#include "../util/span.hpp"
+
+namespace backtest {
+
+/**
+ * @enum IndicatorKind
+ * @brief Indicators an IndicatorGraph can compute
+ */
+enum class IndicatorKind {
+    Sma,
+    Ema,
+    StdDev,
+    Min,
+    Max,
+    Atr  ///< Uses high, low and close; the field is ignored
+};
+
+/**
+ * @enum PriceField
+ * @brief Column of the bars an indicator is computed from
+ */
+enum class PriceField { Open, High, Low, Close, Volume };
+
+/**
+ * @struct IndicatorKey
+ * @brief Identifies one series of a graph
+ */
+struct IndicatorKey {
+    IndicatorKind kind = IndicatorKind::Sma;
+    PriceField field = PriceField::Close;
+    size_t window = 1;
+
+    bool operator<(const IndicatorKey& other) const {
+        return std::tie(kind, field, window) < std::tie(other.kind, other.field, other.window);
+    }
+};
+
+/**
+ * @struct IndicatorGraphStats
+ * @brief Work done by a graph so far
+ */
+struct IndicatorGraphStats {
+    size_t requests = 0;        ///< series() calls
+    size_t series_computed = 0; ///< Indicator series materialized
+    size_t shared_computed = 0; ///< Intermediate nodes (prefix sums, moments, true range) built
+    size_t bytes = 0;           ///< Memory held by computed series and nodes
+};
+
+/**
+ * @class IndicatorGraph
+ * @brief Memoized indicator series over one dataset
+ *
+ * series() may be called from any number of threads: each series is
+ * computed exactly once, by the first caller, while callers asking for
+ * other series proceed in parallel. Returned spans stay valid for the
+ * lifetime of the graph; the bars must outlive it too.
+ */
+class IndicatorGraph {
+public:
+    explicit IndicatorGraph(const BarColumns& bars);
+
+    IndicatorGraph(const IndicatorGraph&) = delete;
+    IndicatorGraph& operator=(const IndicatorGraph&) = delete;
+
+    /**
+     * @brief The series of `key`, computing it (and the nodes it depends on) on first use
+     * @return size() values; entry i covers the bars up to i, NaN before the window is full
+     */
+    Span<const double> series(const IndicatorKey& key);
+
+    Span<const double> sma(size_t window, PriceField field = PriceField::Close) {
+        return series({IndicatorKind::Sma, field, window});
+    }
+    Span<const double> ema(size_t window, PriceField field = PriceField::Close) {
+        return series({IndicatorKind::Ema, field, window});
+    }
+    Span<const double> stddev(size_t window, PriceField field = PriceField::Close) {
+        return series({IndicatorKind::StdDev, field, window});
+    }
+    Span<const double> rolling_min(size_t window, PriceField field = PriceField::Low) {
+        return series({IndicatorKind::Min, field, window});
+    }
+    Span<const double> rolling_max(size_t window, PriceField field = PriceField::High) {
+        return series({IndicatorKind::Max, field, window});
+    }
+    Span<const double> atr(size_t window) { return series({IndicatorKind::Atr, PriceField::Close, window}); }
+
+    /**
+     * @brief Whether the series of `key` has been computed
+     *
+     * False while another thread is still computing it, and after a
+     * computation that threw (the next series() call retries it).
+     */
+    bool contains(const IndicatorKey& key) const;
+
+    size_t size() const { return bars_.size(); }
+    const BarColumns& bars() const { return bars_; }
+    IndicatorGraphStats stats() const;
+
+private:
+    /// A lazily filled array of doubles (one or more series back to back)
+    struct Node {
+        std::once_flag once;
+        std::vector<double> values;
+        std::atomic<bool> computed{false};  ///< Set by series() once values are complete
+    };
+
+    Span<const double> column(PriceField field) const;
+    Node& find_or_add(const IndicatorKey& key);
+
+    /// Prefix sums (sums, then comps; size() + 1 each) of a column
+    const Node& prefix(PriceField field);
+    /// Prefix sums of a column shifted by its first value and of their squares
+    const Node& moments(PriceField field);
+    const Node& true_range();
+
+    void compute(const IndicatorKey& key, std::vector<double>& out);
+    void record_shared(const std::vector<double>& values);
+
+    BarColumns bars_;
+    mutable std::mutex mutex_;                    ///< Guards series_
+    std::map<IndicatorKey, std::unique_ptr<Node>> series_;
+    Node prefix_[5];                              ///< Indexed by PriceField
+    Node moments_[5];
+    Node true_range_;
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> series_computed_{0};
+    std::atomic<size_t> shared_computed_{0};
+    std::atomic<size_t> bytes_{0};
+};
+
+/**
+ * @brief Lower-case name of an indicator kind ("sma", "ema", ...)
+ */
+const char* indicator_kind_name(IndicatorKind kind);
+
+} // namespace backtest
+
+#endif // INDICATOR_GRAPH_HPP
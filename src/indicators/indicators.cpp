@@ -0,0 +1,177 @@
+/**
+ * @file indicators.cpp
+ * @brief Batch kernels of the indicator library
+ */
+
+#include "indicators.hpp"
+#include "crossover_kernel.hpp"
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+    /**
+     * @brief van Herk/Gil-Werman rolling extreme: three picks per value whatever the window
+     *
+     * Splits the series into blocks of `window` values and records, for every
+     * position, the extreme from the start of its block (forward) and to the
+     * end of its block (backward). A window ending at i spans at most two
+     * blocks, so its extreme is pick(backward[i - window + 1], forward[i]).
+     */
+    template <typename Policy>
+    void rolling_extreme_batch(Span<const double> values, size_t window, Span<double> out) {
+        const size_t n = values.size();
+        window = std::max<size_t>(window, 1);
+        std::fill(out.begin(), out.begin() + std::min(n, window - 1), indicator_nan());
+        if (n < window) {
+            return;
+        }
+
+        std::vector<double> forward(n);
+        std::vector<double> backward(n);
+        for (size_t start = 0; start < n; start += window) {
+            const size_t end = std::min(start + window, n);
+            forward[start] = values[start];
+            for (size_t i = start + 1; i < end; ++i) {
+                forward[i] = Policy::pick(forward[i - 1], values[i]);
+            }
+            backward[end - 1] = values[end - 1];
+            for (size_t i = end - 1; i > start; --i) {
+                backward[i - 1] = Policy::pick(backward[i], values[i - 1]);
+            }
+        }
+        for (size_t i = window - 1; i < n; ++i) {
+            out[i] = Policy::pick(backward[i + 1 - window], forward[i]);
+        }
+    }
+
+} // namespace
+
+void prefix_sum_series(Span<const double> values, double shift, bool square, double* sums, double* comps) {
+    // Same recurrence as RollingSum::push(), recorded for every position
+    PrefixSum running;
+    sums[0] = running.sum;
+    comps[0] = running.comp;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const double d = values[i] - shift;
+        prefix_add(running, square ? d * d : d);
+        if ((i + 1) % kPrefixRenormalizePeriod == 0) {
+            prefix_renormalize(running);
+        }
+        sums[i + 1] = running.sum;
+        comps[i + 1] = running.comp;
+    }
+}
+
+void rolling_mean_series(const double* sums, const double* comps, size_t n, size_t window, Span<double> out) {
+    window = std::max<size_t>(window, 1);
+    std::fill(out.begin(), out.begin() + std::min(n, window - 1), indicator_nan());
+    if (window <= n) {
+        // Entry i is prefix position i + 1
+        rolling_mean_kernel(sums, comps, window, n + 1, window, out.data() + (window - 1));
+    }
+}
+
+void stddev_series(const double* sums, const double* comps, const double* square_sums, const double* square_comps,
+                   size_t n, size_t window, Span<double> out) {
+    std::vector<double> mean_squares(n);
+    rolling_mean_series(sums, comps, n, window, out);
+    rolling_mean_series(square_sums, square_comps, n, window, Span<double>(mean_squares.data(), n));
+    for (size_t i = std::max<size_t>(window, 1) - 1; i < n; ++i) {
+        out[i] = std::sqrt(variance_from_moments(out[i], mean_squares[i]));
+    }
+}
+
+void true_range_series(Span<const double> high, Span<const double> low, Span<const double> close, Span<double> out) {
+    const size_t n = close.size();
+    if (n == 0) {
+        return;
+    }
+    out[0] = high[0] - low[0];
+    for (size_t i = 1; i < n; ++i) {
+        out[i] = std::max(high[i] - low[i], std::max(std::fabs(high[i] - close[i - 1]),
+                                                     std::fabs(low[i] - close[i - 1])));
+    }
+}
+
+void atr_from_true_range(Span<const double> true_ranges, size_t window, Span<double> out) {
+    const size_t n = true_ranges.size();
+    window = std::max<size_t>(window, 1);
+    std::fill(out.begin(), out.begin() + std::min(n, window - 1), indicator_nan());
+    if (n < window) {
+        return;
+    }
+    double seed = 0.0;
+    for (size_t i = 0; i < window; ++i) {
+        seed += true_ranges[i];
+    }
+    const double w = static_cast<double>(window);
+    const double w1 = static_cast<double>(window - 1);
+    double atr = seed / w;
+    out[window - 1] = atr;
+    for (size_t i = window; i < n; ++i) {
+        atr = (atr * w1 + true_ranges[i]) / w;
+        out[i] = atr;
+    }
+}
+
+void sma_batch(Span<const double> values, size_t window, Span<double> out) {
+    const size_t n = values.size();
+    std::vector<double> sums(n + 1);
+    std::vector<double> comps(n + 1);
+    prefix_sum_series(values, 0.0, false, sums.data(), comps.data());
+    rolling_mean_series(sums.data(), comps.data(), n, window, out);
+}
+
+void ema_batch(Span<const double> values, size_t window, Span<double> out) {
+    const size_t n = values.size();
+    window = std::max<size_t>(window, 1);
+    std::fill(out.begin(), out.begin() + std::min(n, window - 1), indicator_nan());
+    if (n < window) {
+        return;
+    }
+    double seed = 0.0;
+    for (size_t i = 0; i < window; ++i) {
+        seed += values[i];
+    }
+    const double alpha = 2.0 / (static_cast<double>(window) + 1.0);
+    double ema = seed / static_cast<double>(window);
+    out[window - 1] = ema;
+    for (size_t i = window; i < n; ++i) {
+        ema += alpha * (values[i] - ema);
+        out[i] = ema;
+    }
+}
+
+void stddev_batch(Span<const double> values, size_t window, Span<double> out) {
+    const size_t n = values.size();
+    if (n == 0) {
+        return;
+    }
+    std::vector<double> prefix(4 * (n + 1));
+    double* sums = prefix.data();
+    double* comps = sums + (n + 1);
+    double* square_sums = comps + (n + 1);
+    double* square_comps = square_sums + (n + 1);
+    prefix_sum_series(values, values[0], false, sums, comps);
+    prefix_sum_series(values, values[0], true, square_sums, square_comps);
+    stddev_series(sums, comps, square_sums, square_comps, n, window, out);
+}
+
+void rolling_max_batch(Span<const double> values, size_t window, Span<double> out) {
+    rolling_extreme_batch<MaxPolicy>(values, window, out);
+}
+
+void rolling_min_batch(Span<const double> values, size_t window, Span<double> out) {
+    rolling_extreme_batch<MinPolicy>(values, window, out);
+}
+
+void atr_batch(Span<const double> high, Span<const double> low, Span<const double> close, size_t window,
+               Span<double> out) {
+    std::vector<double> true_ranges(close.size());
+    true_range_series(high, low, close, Span<double>(true_ranges.data(), true_ranges.size()));
+    atr_from_true_range(Span<const double>(true_ranges.data(), true_ranges.size()), window, out);
+}
+
+} // namespace backtest
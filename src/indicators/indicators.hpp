@@ -0,0 +1,337 @@
+/**
+ * @file indicators.hpp
+ * @brief Technical indicators with O(1) streaming updates and batch kernels
+ *
+ * Every indicator comes in two forms that produce bit-identical values:
+ * - a streaming class whose update() consumes one bar in O(1) (amortized for
+ *   the rolling extremes), for per-bar strategies and live feeds;
+ * - a batch function that fills a whole output series from columns, for
+ *   precomputation and shared series (see IndicatorGraph).
+ * The batch kernels perform the same floating-point operations in the same
+ * order as the streaming path; the independent parts of each computation
+ * (window differences, true ranges, block scans) run as branch-free loops
+ * over contiguous columns, and the window means go through the SIMD
+ * rolling_mean_kernel(). Entries before an indicator's window is full are NaN.
+ *
+ * - SMA:    mean of the last w values (compensated prefix sums, as RollingSum).
+ * - EMA:    seeded with the SMA of the first w values, then
+ *           e += alpha * (x - e) with alpha = 2 / (w + 1).
+ * - StdDev: population standard deviation of the last w values, from
+ *           compensated sums of (x - x0) and (x - x0)^2 with x0 the first value.
+ * - Min/Max: extreme of the last w values; streaming keeps a monotonic deque,
+ *           batch uses the van Herk/Gil-Werman block scan. Inputs must not be NaN.
+ * - ATR:    Wilder's average true range; the first value is the mean of the
+ *           first w true ranges (the first bar's true range is high - low).
+ */
+
+#ifndef INDICATORS_HPP
+#define INDICATORS_HPP
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include "rolling_sum.hpp"
+#include "../data/market_data.hpp"
+#include "../util/span.hpp"
+
+namespace backtest {
+
+/// Value of an indicator whose window is not full yet
+inline double indicator_nan() { return std::numeric_limits<double>::quiet_NaN(); }
+
+/**
+ * @brief Population variance from the window means of x and x^2 (clamped at 0)
+ */
+inline double variance_from_moments(double mean, double mean_square) {
+    const double variance = mean_square - mean * mean;
+    return variance > 0.0 ? variance : 0.0;
+}
+
+/**
+ * @class SmaIndicator
+ * @brief Simple moving average over the last `window` values
+ */
+class SmaIndicator {
+public:
+    explicit SmaIndicator(size_t window, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : window_(std::max<size_t>(window, 1)), sum_(window_, resource) {}
+
+    double update(double x) {
+        sum_.push(x);
+        return value();
+    }
+
+    bool ready() const { return sum_.ready(window_); }
+    double value() const { return ready() ? sum_.mean(window_) : indicator_nan(); }
+    size_t window() const { return window_; }
+    void clear() { sum_.clear(); }
+
+private:
+    size_t window_;
+    RollingSum sum_;
+};
+
+/**
+ * @class EmaIndicator
+ * @brief Exponential moving average with alpha = 2 / (window + 1), seeded with an SMA
+ */
+class EmaIndicator {
+public:
+    explicit EmaIndicator(size_t window)
+        : window_(std::max<size_t>(window, 1)), alpha_(2.0 / (static_cast<double>(window_) + 1.0)) {}
+
+    double update(double x) {
+        if (count_ < window_) {
+            seed_ += x;
+            if (++count_ == window_) {
+                ema_ = seed_ / static_cast<double>(window_);
+            }
+        } else {
+            ema_ += alpha_ * (x - ema_);
+        }
+        return value();
+    }
+
+    bool ready() const { return count_ >= window_; }
+    double value() const { return ready() ? ema_ : indicator_nan(); }
+    size_t window() const { return window_; }
+    double alpha() const { return alpha_; }
+
+    void clear() {
+        count_ = 0;
+        seed_ = 0.0;
+        ema_ = 0.0;
+    }
+
+private:
+    size_t window_;
+    double alpha_;
+    size_t count_ = 0;
+    double seed_ = 0.0;  ///< Sum of the first window values
+    double ema_ = 0.0;
+};
+
+/**
+ * @class StdDevIndicator
+ * @brief Population standard deviation of the last `window` values
+ *
+ * The values are shifted by the first one seen before summing, so the
+ * squares stay small for prices far from zero and the subtraction of the
+ * squared mean does not cancel catastrophically.
+ */
+class StdDevIndicator {
+public:
+    explicit StdDevIndicator(size_t window, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : window_(std::max<size_t>(window, 1)), sum_(window_, resource), sum_squares_(window_, resource) {}
+
+    double update(double x) {
+        if (sum_.count() == 0) {
+            shift_ = x;
+        }
+        const double d = x - shift_;
+        sum_.push(d);
+        sum_squares_.push(d * d);
+        return value();
+    }
+
+    bool ready() const { return sum_.ready(window_); }
+
+    double value() const {
+        if (!ready()) {
+            return indicator_nan();
+        }
+        return std::sqrt(variance_from_moments(sum_.mean(window_), sum_squares_.mean(window_)));
+    }
+
+    size_t window() const { return window_; }
+
+    void clear() {
+        sum_.clear();
+        sum_squares_.clear();
+        shift_ = 0.0;
+    }
+
+private:
+    size_t window_;
+    RollingSum sum_;          ///< Of x - shift_
+    RollingSum sum_squares_;  ///< Of (x - shift_)^2
+    double shift_ = 0.0;      ///< First value seen
+};
+
+/**
+ * @brief Picks the larger value (RollingExtremum policy)
+ */
+struct MaxPolicy {
+    static bool dominates(double a, double b) { return a >= b; }
+    static double pick(double a, double b) { return a < b ? b : a; }
+};
+
+/**
+ * @brief Picks the smaller value (RollingExtremum policy)
+ */
+struct MinPolicy {
+    static bool dominates(double a, double b) { return a <= b; }
+    static double pick(double a, double b) { return b < a ? b : a; }
+};
+
+/**
+ * @class RollingExtremum
+ * @brief Rolling max (MaxPolicy) or min (MinPolicy) via a monotonic deque
+ *
+ * The deque holds the positions of values that can still become the
+ * extreme, in decreasing (max) or increasing (min) order; each value is
+ * pushed and popped at most once, so update() is amortized O(1). The deque
+ * never holds more than window + 1 entries and lives in a ring allocated once.
+ */
+template <typename Policy>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(size_t window, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : window_(std::max<size_t>(window, 1)), slots_(round_up_pow2(window_ + 1), resource),
+          mask_(slots_.size() - 1) {}
+
+    double update(double x) {
+        // Drop values the new one dominates, then the one that left the window
+        while (tail_ != head_ && Policy::dominates(x, slots_[(tail_ - 1) & mask_].value)) {
+            --tail_;
+        }
+        slots_[tail_++ & mask_] = Entry{count_, x};
+        ++count_;
+        if (slots_[head_ & mask_].index + window_ < count_) {
+            ++head_;
+        }
+        return value();
+    }
+
+    bool ready() const { return count_ >= window_; }
+    double value() const { return ready() ? slots_[head_ & mask_].value : indicator_nan(); }
+    size_t window() const { return window_; }
+
+    void clear() {
+        head_ = 0;
+        tail_ = 0;
+        count_ = 0;
+    }
+
+private:
+    struct Entry {
+        size_t index;  ///< Position of the value in the series
+        double value;
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    size_t window_;
+    std::pmr::vector<Entry> slots_;
+    size_t mask_;
+    size_t head_ = 0;   ///< Oldest live entry (the extreme)
+    size_t tail_ = 0;   ///< One past the newest entry
+    size_t count_ = 0;  ///< Values seen
+};
+
+using RollingMaxIndicator = RollingExtremum<MaxPolicy>;
+using RollingMinIndicator = RollingExtremum<MinPolicy>;
+
+/**
+ * @brief True range of a bar given the previous close (NaN for the first bar: high - low is used)
+ */
+inline double true_range(double high, double low, double previous_close) {
+    if (std::isnan(previous_close)) {
+        return high - low;
+    }
+    return std::max(high - low, std::max(std::fabs(high - previous_close), std::fabs(low - previous_close)));
+}
+
+/**
+ * @class AtrIndicator
+ * @brief Wilder's average true range over `window` bars
+ */
+class AtrIndicator {
+public:
+    explicit AtrIndicator(size_t window) : window_(std::max<size_t>(window, 1)) {}
+
+    double update(const Bar& bar) { return update(bar.high, bar.low, bar.close); }
+
+    double update(double high, double low, double close) {
+        const double tr = true_range(high, low, previous_close_);
+        previous_close_ = close;
+        if (count_ < window_) {
+            seed_ += tr;
+            if (++count_ == window_) {
+                atr_ = seed_ / static_cast<double>(window_);
+            }
+        } else {
+            atr_ = (atr_ * static_cast<double>(window_ - 1) + tr) / static_cast<double>(window_);
+        }
+        return value();
+    }
+
+    bool ready() const { return count_ >= window_; }
+    double value() const { return ready() ? atr_ : indicator_nan(); }
+    size_t window() const { return window_; }
+
+    void clear() {
+        previous_close_ = indicator_nan();
+        count_ = 0;
+        seed_ = 0.0;
+        atr_ = 0.0;
+    }
+
+private:
+    size_t window_;
+    double previous_close_ = indicator_nan();
+    size_t count_ = 0;
+    double seed_ = 0.0;  ///< Sum of the first window true ranges
+    double atr_ = 0.0;
+};
+
+/**
+ * @brief Compensated prefix sums of (values[i] - shift), squared if `square`
+ * @param sums Receives values.size() + 1 sum parts; position k is the state after k values
+ * @param comps Receives the compensation parts, same layout
+ *
+ * Follows RollingSum::push() exactly, including its renormalization schedule.
+ */
+void prefix_sum_series(Span<const double> values, double shift, bool square, double* sums, double* comps);
+
+/**
+ * @brief Rolling means of the series whose prefix sums are given
+ * @param n Number of values (the prefix arrays hold n + 1 entries)
+ * @param out n entries; NaN before the window is full
+ */
+void rolling_mean_series(const double* sums, const double* comps, size_t n, size_t window, Span<double> out);
+
+/**
+ * @brief Population standard deviations from prefix sums of shifted values and their squares
+ */
+void stddev_series(const double* sums, const double* comps, const double* square_sums, const double* square_comps,
+                   size_t n, size_t window, Span<double> out);
+
+/**
+ * @brief True range of every bar (the first bar's is high - low)
+ */
+void true_range_series(Span<const double> high, Span<const double> low, Span<const double> close, Span<double> out);
+
+/**
+ * @brief Wilder smoothing of precomputed true ranges
+ */
+void atr_from_true_range(Span<const double> true_ranges, size_t window, Span<double> out);
+
+// Batch kernels: out must hold values.size() (or close.size()) entries
+void sma_batch(Span<const double> values, size_t window, Span<double> out);
+void ema_batch(Span<const double> values, size_t window, Span<double> out);
+void stddev_batch(Span<const double> values, size_t window, Span<double> out);
+void rolling_max_batch(Span<const double> values, size_t window, Span<double> out);
+void rolling_min_batch(Span<const double> values, size_t window, Span<double> out);
+void atr_batch(Span<const double> high, Span<const double> low, Span<const double> close, size_t window,
+               Span<double> out);
+
+} // namespace backtest
+
+#endif // INDICATORS_HPP
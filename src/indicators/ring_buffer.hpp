@@ -0,0 +1,158 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief Fixed-capacity circular buffer
+ *
+ * Storage primitive for rolling-window indicators: pushing a new element
+ * overwrites the oldest one once the buffer is full, and no allocation
+ * happens after construction. Storage comes from a std::pmr resource, so a
+ * run's indicators can live in a per-run arena (see RunArena).
+ */
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class RingBuffer
+ * @brief Circular buffer holding the most recent `capacity` elements
+ *
+ * Elements are addressed by age: back(0) is the newest element, back(1) the
+ * one before it, and so on. The physical storage is rounded up to a power of
+ * two so indexing is a mask instead of a modulo.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief Creates an empty buffer that retains up to `capacity` elements
+     * @param resource Memory resource for the storage
+     */
+    explicit RingBuffer(size_t capacity,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), mask_(round_up_pow2(capacity) - 1),
+          data_(mask_ + 1, resource), head_(0), size_(0) {}
+
+    /**
+     * @brief Appends an element, evicting the oldest one if the buffer is full
+     */
+    void push(const T& value) {
+        data_[head_] = value;
+        head_ = (head_ + 1) & mask_;
+        if (size_ < capacity_) {
+            ++size_;
+        }
+    }
+
+    /**
+     * @brief Returns the element pushed `age` pushes ago (0 = newest)
+     * @pre age < size()
+     */
+    const T& back(size_t age = 0) const {
+        return data_[(head_ - 1 - age) & mask_];
+    }
+
+    /**
+     * @brief Returns the i-th element counting from the oldest (0 = oldest)
+     * @pre i < size()
+     */
+    const T& operator[](size_t i) const {
+        return back(size_ - 1 - i);
+    }
+
+    /**
+     * @brief Removes all elements (storage is kept)
+     */
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == capacity_; }
+    std::pmr::memory_resource* resource() const { return data_.get_allocator().resource(); }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    size_t capacity_;           ///< Logical capacity requested by the caller
+    size_t mask_;               ///< Physical size - 1 (physical size is a power of two)
+    std::pmr::vector<T> data_;  ///< Physical storage
+    size_t head_;               ///< Slot the next push writes to
+    size_t size_;               ///< Number of valid elements
+};
+
+/**
+ * @class StaticRingBuffer
+ * @brief RingBuffer with its capacity fixed at compile time
+ *
+ * Same interface and semantics as RingBuffer, but the storage is an inline
+ * std::array and the index mask is a constant, so an owner with constexpr
+ * window lengths gets fully constant index arithmetic and no allocation.
+ */
+template <typename T, size_t Capacity>
+class StaticRingBuffer {
+    static_assert(Capacity > 0, "StaticRingBuffer needs a positive capacity");
+
+public:
+    void push(const T& value) {
+        data_[head_] = value;
+        head_ = (head_ + 1) & kMask;
+        if (size_ < Capacity) {
+            ++size_;
+        }
+    }
+
+    /**
+     * @brief Returns the element pushed `age` pushes ago (0 = newest)
+     * @pre age < size()
+     */
+    const T& back(size_t age = 0) const {
+        return data_[(head_ - 1 - age) & kMask];
+    }
+
+    /**
+     * @brief Returns the i-th element counting from the oldest (0 = oldest)
+     * @pre i < size()
+     */
+    const T& operator[](size_t i) const {
+        return back(size_ - 1 - i);
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    static constexpr size_t capacity() { return Capacity; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == Capacity; }
+
+private:
+    static constexpr size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static constexpr size_t kMask = round_up_pow2(Capacity) - 1;
+
+    std::array<T, kMask + 1> data_{};  ///< Physical storage
+    size_t head_ = 0;                  ///< Slot the next push writes to
+    size_t size_ = 0;                  ///< Number of valid elements
+};
+
+} // namespace backtest
+
+#endif // RING_BUFFER_HPP
@@ -0,0 +1,73 @@
+/**
+ * @file rolling_mean_cache.cpp
+ * @brief Implementation of the shared rolling-mean series
+ */
+
+#include "rolling_mean_cache.hpp"
+#include "crossover_kernel.hpp"
+#include "rolling_sum.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace backtest {
+
+RollingMeanCache::RollingMeanCache(Span<const double> values) : RollingMeanCache() {
+    extend(values);
+}
+
+void RollingMeanCache::extend(Span<const double> values) {
+    // Same recurrence as RollingSum::push(), recorded for every position
+    const size_t base = size();
+    PrefixSum running{sums_.back(), comps_.back()};
+    sums_.resize(base + values.size() + 1);
+    comps_.resize(base + values.size() + 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        prefix_add(running, values[i]);
+        if ((base + i + 1) % kPrefixRenormalizePeriod == 0) {
+            prefix_renormalize(running);
+        }
+        sums_[base + i + 1] = running.sum;
+        comps_[base + i + 1] = running.comp;
+    }
+}
+
+std::vector<size_t> RollingMeanCache::request(const std::vector<size_t>& windows) {
+    std::vector<size_t> added;
+    for (size_t window : windows) {
+        if (window == 0) {
+            throw std::invalid_argument("RollingMeanCache: window must be at least 1");
+        }
+        if (series_.emplace(window, std::vector<double>()).second) {
+            added.push_back(window);
+        }
+    }
+    std::sort(added.begin(), added.end());
+    return added;
+}
+
+void RollingMeanCache::compute(size_t window) {
+    const auto it = series_.find(window);
+    if (it == series_.end()) {
+        throw std::out_of_range("RollingMeanCache: window not registered");
+    }
+
+    const size_t n = size();
+    std::vector<double>& means = it->second;
+    means.assign(n, std::numeric_limits<double>::quiet_NaN());
+    if (window <= n) {
+        // Entry i is prefix position i + 1
+        rolling_mean_kernel(sums_.data(), comps_.data(), window, n + 1, window,
+                            means.data() + (window - 1));
+    }
+}
+
+Span<const double> RollingMeanCache::means(size_t window) const {
+    const auto it = series_.find(window);
+    if (it == series_.end()) {
+        throw std::out_of_range("RollingMeanCache: window not registered");
+    }
+    return Span<const double>(it->second.data(), it->second.size());
+}
+
+} // namespace backtest
@@ -0,0 +1,102 @@
+/**
+ * @file rolling_mean_cache.hpp
+ * @brief Rolling-mean series shared by every strategy that runs over one dataset
+ *
+ * A parameter sweep runs many SMA configurations over the same closes, and
+ * most of them share their short or long window with another configuration.
+ * RollingMeanCache builds the compensated prefix sums of the series once and
+ * materializes each distinct window's mean series once, so a grid of N short
+ * by M long windows costs N + M indicator passes instead of N x M.
+ *
+ * The prefix states are produced by the same additions and renormalization
+ * schedule as RollingSum, and the means by the same expression as
+ * RollingSum::mean(), so every cached value is bit-identical to what
+ * SMAStrategy computes for the same bar when it starts at the first bar.
+ */
+
+#ifndef ROLLING_MEAN_CACHE_HPP
+#define ROLLING_MEAN_CACHE_HPP
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "../util/span.hpp"
+
+namespace backtest {
+
+/**
+ * @class RollingMeanCache
+ * @brief Memoized rolling means of one series, one full-length series per window
+ *
+ * Memory is one double per bar for each registered window, plus two for the
+ * prefix sums. Windows are registered first (single-threaded), after which
+ * compute() may fill different windows concurrently; reads of computed
+ * series are safe from any thread.
+ */
+class RollingMeanCache {
+public:
+    /**
+     * @brief Builds the prefix sums of values (one pass)
+     * @param values Series to average, oldest first; copied into prefix form
+     */
+    explicit RollingMeanCache(Span<const double> values);
+
+    /**
+     * @brief Creates a cache over an empty series, to be filled with extend()
+     */
+    RollingMeanCache() : sums_(1, 0.0), comps_(1, 0.0) {}
+
+    /**
+     * @brief Appends values to the series, e.g. one decoded block at a time
+     * @pre No window has been registered yet
+     *
+     * The prefix states are the same as if all values had been passed to
+     * the constructor at once.
+     */
+    void extend(Span<const double> values);
+
+    /**
+     * @brief Registers windows, ignoring duplicates and already known windows
+     * @return Newly registered windows, in ascending order, still to be compute()d
+     * @pre Every window is >= 1; not called concurrently with compute()
+     */
+    std::vector<size_t> request(const std::vector<size_t>& windows);
+
+    /**
+     * @brief Fills the series of a registered window
+     *
+     * Distinct windows may be computed concurrently from different threads.
+     */
+    void compute(size_t window);
+
+    /**
+     * @brief Rolling means of a computed window
+     * @return Span of size() values; entry i is the mean of the `window` values
+     *         ending at entry i, or NaN for the first window - 1 entries
+     * @throws std::out_of_range if the window was never registered
+     */
+    Span<const double> means(size_t window) const;
+
+    /**
+     * @brief Checks whether a window has been registered
+     */
+    bool contains(size_t window) const { return series_.count(window) != 0; }
+
+    /**
+     * @brief Number of values in the underlying series
+     */
+    size_t size() const { return sums_.empty() ? 0 : sums_.size() - 1; }
+
+    /**
+     * @brief Number of distinct registered windows (indicator passes performed)
+     */
+    size_t windows() const { return series_.size(); }
+
+private:
+    std::vector<double> sums_;   ///< Prefix sum parts; position k is the state after k values
+    std::vector<double> comps_;  ///< Prefix compensation parts, same layout as sums_
+    std::map<size_t, std::vector<double>> series_;  ///< Node-based so entries never move
+};
+
+} // namespace backtest
+
+#endif // ROLLING_MEAN_CACHE_HPP
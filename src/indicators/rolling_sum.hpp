@@ -0,0 +1,279 @@
+/**
+ * @file rolling_sum.hpp
+ * @brief O(1) rolling sums and means over any window up to a fixed maximum
+ *
+ * Instead of re-summing a window on every bar, RollingSum keeps a running
+ * prefix sum of all values seen and a ring of its recent states. The sum of
+ * the last w values is then the difference of two prefix states, so one ring
+ * answers every window length up to its capacity at constant cost.
+ *
+ * A plain running total loses precision as it grows (its rounding error is
+ * relative to its own, ever-increasing magnitude). The prefix is therefore
+ * carried as a compensated (Neumaier) pair {sum, comp} whose compensation
+ * term captures the rounding error of every addition, and the pair is
+ * periodically renormalized. Window differences are taken on both parts, so
+ * their error stays relative to the window sum, not the length of the run.
+ */
+
+#ifndef ROLLING_SUM_HPP
+#define ROLLING_SUM_HPP
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "ring_buffer.hpp"
+#include "../util/snapshot.hpp"
+
+namespace backtest {
+
+/**
+ * @struct PrefixSum
+ * @brief Compensated running total: the exact total is approximately sum + comp
+ */
+struct PrefixSum {
+    double sum = 0.0;   ///< Rounded running total
+    double comp = 0.0;  ///< Accumulated rounding error of sum
+};
+
+/// Number of additions between renormalizations of a PrefixSum
+constexpr size_t kPrefixRenormalizePeriod = 4096;
+
+/**
+ * @brief Adds x to a compensated prefix (Neumaier's variant of Kahan summation)
+ */
+inline void prefix_add(PrefixSum& p, double x) {
+    const double t = p.sum + x;
+    if (std::fabs(p.sum) >= std::fabs(x)) {
+        p.comp += (p.sum - t) + x;
+    } else {
+        p.comp += (x - t) + p.sum;
+    }
+    p.sum = t;
+}
+
+/**
+ * @brief Folds the compensation back into the sum without changing sum + comp
+ *
+ * Keeps |comp| below one ulp of sum so the compensation itself does not drift.
+ */
+inline void prefix_renormalize(PrefixSum& p) {
+    const double t = p.sum + p.comp;
+    p.comp = p.comp - (t - p.sum);
+    p.sum = t;
+}
+
+/**
+ * @brief Sum of the values added between two prefix states
+ * @param newer Prefix after the last value of the window
+ * @param older Prefix just before the first value of the window
+ */
+inline double prefix_window_sum(const PrefixSum& newer, const PrefixSum& older) {
+    return (newer.sum - older.sum) + (newer.comp - older.comp);
+}
+
+/**
+ * @class RollingSum
+ * @brief Constant-time sum/mean of the most recent w values, for any w <= max_window
+ *
+ * Several indicators over the same series (e.g. a short and a long moving
+ * average) can share one RollingSum sized for the largest window.
+ */
+class RollingSum {
+public:
+    /**
+     * @brief Creates a rolling sum supporting windows up to max_window values
+     * @param resource Memory resource for the ring of prefix states
+     */
+    explicit RollingSum(size_t max_window,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : prefixes_(max_window + 1, resource), count_(0) {
+        prefixes_.push(running_);  // Prefix before the first value
+    }
+
+    /**
+     * @brief Adds the newest value of the series
+     */
+    void push(double x) {
+        prefix_add(running_, x);
+        ++count_;
+        if (count_ % kPrefixRenormalizePeriod == 0) {
+            prefix_renormalize(running_);
+        }
+        prefixes_.push(running_);
+    }
+
+    /**
+     * @brief Checks whether at least `window` values have been pushed
+     */
+    bool ready(size_t window) const { return count_ >= window; }
+
+    /**
+     * @brief Sum of the most recent `window` values
+     * @pre window <= max_window() and ready(window)
+     */
+    double sum(size_t window) const {
+        return prefix_window_sum(prefixes_.back(0), prefixes_.back(window));
+    }
+
+    /**
+     * @brief Mean of the most recent `window` values (0.0 for an empty window)
+     * @pre window <= max_window() and ready(window)
+     */
+    double mean(size_t window) const {
+        return window == 0 ? 0.0 : sum(window) / static_cast<double>(window);
+    }
+
+    /**
+     * @brief Forgets all values
+     */
+    void clear() {
+        running_ = PrefixSum{};
+        count_ = 0;
+        prefixes_.clear();
+        prefixes_.push(running_);
+    }
+
+    size_t count() const { return count_; }
+    size_t max_window() const { return prefixes_.capacity() - 1; }
+
+    /**
+     * @brief Current running prefix (after the newest value)
+     */
+    const PrefixSum& prefix() const { return running_; }
+
+    /**
+     * @brief Stored prefix state `age` positions before the newest (0 = prefix())
+     * @pre age < history()
+     *
+     * Lets batch kernels continue from the exact state of the streaming path.
+     */
+    const PrefixSum& prefix_back(size_t age) const { return prefixes_.back(age); }
+
+    /**
+     * @brief Number of stored prefix states (at most max_window() + 1)
+     */
+    size_t history() const { return prefixes_.size(); }
+
+    /**
+     * @brief Appends the window capacity, value count and stored prefix states
+     */
+    void save_state(SnapshotWriter& out) const {
+        out.put(static_cast<uint64_t>(max_window()));
+        out.put(static_cast<uint64_t>(count_));
+        out.put(static_cast<uint64_t>(prefixes_.size()));
+        for (size_t i = 0; i < prefixes_.size(); ++i) {
+            out.put(prefixes_[i]);
+        }
+    }
+
+    /**
+     * @brief Restores a state written by save_state()
+     * @return false, leaving this sum unchanged, if the snapshot is truncated,
+     *         inconsistent or was taken with a different max_window()
+     *
+     * Continuing from a restored state performs exactly the operations of
+     * the uninterrupted run, so later sums are bit-identical.
+     */
+    bool load_state(SnapshotReader& in) {
+        uint64_t max_window_saved = 0;
+        uint64_t count = 0;
+        uint64_t history = 0;
+        if (!in.get(max_window_saved) || !in.get(count) || !in.get(history)) {
+            return false;
+        }
+        if (max_window_saved != max_window() || history == 0 ||
+            history != std::min<uint64_t>(count + 1, prefixes_.capacity())) {
+            in.fail();
+            return false;
+        }
+        RingBuffer<PrefixSum> prefixes(prefixes_.capacity(), prefixes_.resource());
+        PrefixSum p;
+        for (uint64_t i = 0; i < history; ++i) {
+            if (!in.get(p)) {
+                return false;
+            }
+            prefixes.push(p);
+        }
+        prefixes_ = std::move(prefixes);
+        running_ = p;
+        count_ = static_cast<size_t>(count);
+        return true;
+    }
+
+private:
+    RingBuffer<PrefixSum> prefixes_;  ///< Prefix states of the last max_window + 1 positions
+    PrefixSum running_;               ///< Prefix after the newest value
+    size_t count_;                    ///< Values pushed so far
+};
+
+/**
+ * @class StaticRollingSum
+ * @brief RollingSum with the maximum window fixed at compile time
+ *
+ * Performs exactly the same floating-point operations as RollingSum, so both
+ * produce bit-identical sums, but keeps its prefix ring inline. sum<W>() and
+ * mean<W>() take the window as a template argument for fully constant
+ * indexing.
+ */
+template <size_t MaxWindow>
+class StaticRollingSum {
+public:
+    StaticRollingSum() : count_(0) {
+        prefixes_.push(running_);  // Prefix before the first value
+    }
+
+    void push(double x) {
+        prefix_add(running_, x);
+        ++count_;
+        if (count_ % kPrefixRenormalizePeriod == 0) {
+            prefix_renormalize(running_);
+        }
+        prefixes_.push(running_);
+    }
+
+    bool ready(size_t window) const { return count_ >= window; }
+
+    /**
+     * @brief Sum of the most recent `window` values
+     * @pre window <= MaxWindow and ready(window)
+     */
+    double sum(size_t window) const {
+        return prefix_window_sum(prefixes_.back(0), prefixes_.back(window));
+    }
+
+    double mean(size_t window) const {
+        return window == 0 ? 0.0 : sum(window) / static_cast<double>(window);
+    }
+
+    template <size_t Window>
+    double sum() const {
+        static_assert(Window <= MaxWindow, "window exceeds the rolling sum's capacity");
+        return prefix_window_sum(prefixes_.back(0), prefixes_.back(Window));
+    }
+
+    template <size_t Window>
+    double mean() const {
+        return Window == 0 ? 0.0 : sum<Window>() / static_cast<double>(Window);
+    }
+
+    void clear() {
+        running_ = PrefixSum{};
+        count_ = 0;
+        prefixes_.clear();
+        prefixes_.push(running_);
+    }
+
+    size_t count() const { return count_; }
+    static constexpr size_t max_window() { return MaxWindow; }
+    const PrefixSum& prefix() const { return running_; }
+
+private:
+    StaticRingBuffer<PrefixSum, MaxWindow + 1> prefixes_;  ///< Prefix states of the last MaxWindow + 1 positions
+    PrefixSum running_;                                    ///< Prefix after the newest value
+    size_t count_;                                         ///< Values pushed so far
+};
+
+} // namespace backtest
+
+#endif // ROLLING_SUM_HPP
@@ -0,0 +1,94 @@
+/**
+ * @file load_files_main.cpp
+ * @brief Loads a directory or list of data files in parallel and reports the throughput
+ *
+ * Usage:
+ *   loadfiles (DIR | LIST) [--threads=0] [--stream] [--cache] [--per-file]
+ *             [--validate[=auto|weekdays|sessions|continuous]]
+ *
+ * DIR loads every *.csv in the directory, the symbol being the file name;
+ * LIST is a file with one "SYMBOL PATH" or "PATH" per line, and a single
+ * .csv path loads just that file. The files are loaded with
+ * load_files_parallel() (memory-mapped parsing unless --stream) and the
+ * aggregate MB/s and rows/s are printed, with one line per file under
+ * --per-file. Run it after dropping the page cache to measure a cold
+ * start, or again with --cache to time sidecar reloads.
+ */
+
+#include "data/parallel_loader.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /// Value of "--name=value", or nullptr if arg is a different option
+    const char* option_value(const char* arg, const char* name) {
+        const size_t length = std::strlen(name);
+        if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') {
+            return nullptr;
+        }
+        return arg + length + 1;
+    }
+
+    int usage() {
+        std::cerr << "Usage: loadfiles (DIR | LIST) [--threads=N] [--stream] [--cache] [--per-file]\n"
+                  << "                 [--validate[=auto|weekdays|sessions|continuous]]" << std::endl;
+        return 1;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        return usage();
+    }
+    backtest::ParallelLoadConfig config;
+    bool per_file = false;
+    for (int i = 2; i < argc; ++i) {
+        if (const char* value = option_value(argv[i], "--threads")) {
+            config.threads = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--stream") == 0) {
+            config.mode = backtest::LoadMode::Stream;
+        } else if (std::strcmp(argv[i], "--cache") == 0) {
+            config.cache = backtest::CachePolicy::ReadWrite;
+        } else if (std::strcmp(argv[i], "--per-file") == 0) {
+            per_file = true;
+        } else if (std::strcmp(argv[i], "--validate") == 0) {
+            config.validate = true;
+        } else if (const char* value = option_value(argv[i], "--validate")) {
+            config.validate = true;
+            if (!backtest::parse_trading_calendar(value, config.validation.calendar)) {
+                std::cerr << "Unknown trading calendar: " << value << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return usage();
+        }
+    }
+
+    std::vector<backtest::DataFile> files;
+    if (!backtest::list_data_files(argv[1], files)) {
+        return 1;
+    }
+    if (files.empty()) {
+        std::cerr << "No data files in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<backtest::DataHandler> data;
+    backtest::ParallelLoadStats stats;
+    const bool ok = backtest::load_files_parallel(files, data, config, &stats);
+    backtest::print_load_stats(std::cout, stats, per_file);
+    if (config.validate) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (stats.files[i].ok && !data[i].last_quality_report().clean()) {
+                backtest::print_quality_report(std::cout, files[i].path, data[i].last_quality_report());
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
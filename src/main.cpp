@@ -1,34 +1,297 @@
+/**
+ * @file main.cpp
+ * @brief Runs the sample SMA strategy through the backtest engine
+ *
+ * Usage:
+ *   backtest [--quiet] [--format=text|csv|binary] [--background]
+ *            [--signals=PATH] [--fills=PATH] [--equity=PATH]
+ *            [--data=CSV] [--checkpoint=PATH] [--pipeline[=backoff|spin]]
+ *            [--precision-check[=float32|ticks]] [--validate[=auto|weekdays|sessions|continuous]]
+ *
+ * Per-bar signals go to standard output as text unless --signals names a
+ * file, or are suppressed by --quiet; --fills and --equity add a trade log
+ * and the equity curve. All records are written through buffered writers,
+ * on a background thread with --background. The summary always goes to
+ * standard output.
+ *
+ * With --checkpoint the state after the last bar is saved to PATH. If PATH
+ * already exists the run first restores it and processes only the bars added
+ * to the data file since; fills, equity and the summary then cover those
+ * bars, while positions, cash and P&L carry over.
+ *
+ * --pipeline runs reading, signal generation and accounting/output on three
+ * threads connected by lock-free queues, with the same results, and adds
+ * queue depths and per-bar latency to the summary.
+ *
+ * --precision-check replays the whole file once more over a compact copy of
+ * the bars and reports how far the P&L diverges from the double columns, to
+ * validate a layout before configuring BACKTEST_PRICE_STORAGE with it. The
+ * layout defaults to the configured one (float32 in double builds); =float32
+ * or =ticks (cent ticks) picks one explicitly. The run itself uses double
+ * columns.
+ *
+ * --validate checks, repairs and gap-fills the bars while the file is parsed
+ * (see data/bar_validator.hpp) on the given trading calendar and prints the
+ * file's quality report before the run. The default, auto, fills intraday
+ * gaps within a session only and leaves gaps in daily bars unfilled.
+ */
+
 #include "data/data_handler.hpp"
+#include "engine/backtest_engine.hpp"
+#include "engine/checkpoint.hpp"
+#include "engine/pipeline.hpp"
+#include "engine/precision_check.hpp"
+#include "output/record_writer.hpp"
 #include "strategy/sma_strategy.hpp"
+#include "util/profiler.hpp"
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+    struct OutputArgs {
+        backtest::OutputFormat format = backtest::OutputFormat::Text;
+        bool quiet = false;
+        bool background = false;
+        std::string signals = "-";
+        std::string fills;
+        std::string equity;
+        std::string data = "../data/sample_data.csv";
+        std::string checkpoint;
+        bool pipeline = false;
+        bool precision_check = false;
+        bool precision_ticks = std::is_same<backtest::PriceCodec, backtest::TickPriceCodec>::value;
+        bool validate = false;
+        backtest::TradingCalendar calendar = backtest::TradingCalendar::Auto;
+        backtest::WaitPolicy wait = backtest::WaitPolicy::Backoff;
+    };
+
+    bool starts_with(const std::string& arg, const char* prefix, std::string& value) {
+        const std::string p(prefix);
+        if (arg.compare(0, p.size(), p) != 0) {
+            return false;
+        }
+        value = arg.substr(p.size());
+        return true;
+    }
+
+    bool parse_args(int argc, char** argv, OutputArgs& args) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            std::string value;
+            if (arg == "--quiet") {
+                args.quiet = true;
+            } else if (arg == "--background") {
+                args.background = true;
+            } else if (starts_with(arg, "--format=", value)) {
+                if (!backtest::parse_output_format(value, args.format)) {
+                    std::cerr << "Unknown output format: " << value << std::endl;
+                    return false;
+                }
+            } else if (starts_with(arg, "--signals=", value)) {
+                args.signals = value;
+            } else if (starts_with(arg, "--fills=", value)) {
+                args.fills = value;
+            } else if (starts_with(arg, "--equity=", value)) {
+                args.equity = value;
+            } else if (starts_with(arg, "--data=", value)) {
+                args.data = value;
+            } else if (starts_with(arg, "--checkpoint=", value)) {
+                args.checkpoint = value;
+            } else if (arg == "--precision-check") {
+                args.precision_check = true;
+            } else if (starts_with(arg, "--precision-check=", value)) {
+                args.precision_check = true;
+                if (value == "ticks" || value == "float32") {
+                    args.precision_ticks = value == "ticks";
+                } else {
+                    std::cerr << "Unknown price layout: " << value << " (expected float32 or ticks)" << std::endl;
+                    return false;
+                }
+            } else if (arg == "--validate") {
+                args.validate = true;
+            } else if (starts_with(arg, "--validate=", value)) {
+                args.validate = true;
+                if (!backtest::parse_trading_calendar(value, args.calendar)) {
+                    std::cerr << "Unknown trading calendar: " << value << std::endl;
+                    return false;
+                }
+            } else if (arg == "--pipeline") {
+                args.pipeline = true;
+            } else if (starts_with(arg, "--pipeline=", value)) {
+                args.pipeline = true;
+                if (!backtest::parse_wait_policy(value, args.wait)) {
+                    std::cerr << "Unknown wait policy: " << value << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return false;
+            }
+        }
+        if (args.pipeline && !args.checkpoint.empty()) {
+            std::cerr << "--checkpoint cannot be combined with --pipeline" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Opens a writer for path, or leaves writer empty if path is empty
+     * @return false if the file could not be opened
+     */
+    bool open_records(const OutputArgs& args, backtest::RecordKind kind, const std::string& path,
+                      std::unique_ptr<backtest::RecordWriter>& writer) {
+        if (path.empty()) {
+            return true;
+        }
+        writer = std::make_unique<backtest::RecordWriter>(
+            kind, args.format, backtest::BufferedWriter::kDefaultChunkBytes, args.background);
+        return writer->open(path);
+    }
+
+    /**
+     * @brief Prints the divergence of the sample strategy over a Codec copy of bars
+     * @return false if a price cannot be stored in the layout
+     */
+    template <typename Codec>
+    bool precision_check(const backtest::BarColumns& bars, const backtest::ExecutionModel& execution) {
+        backtest::BasicCompactBarStore<Codec> compact;
+        if (!compact.assign(bars)) {
+            return false;
+        }
+        backtest::SMAStrategy reference(3, 5);
+        backtest::SMAStrategy candidate(3, 5);
+        std::cout << "----------------------------------------" << std::endl;
+        backtest::print_precision_report(
+            std::cout, backtest::check_storage_precision(bars, compact, reference, candidate, execution));
+        return true;
+    }
+
+    bool close_records(std::unique_ptr<backtest::RecordWriter>& writer) {
+        if (writer && !writer->close()) {
+            std::cerr << "Error writing output" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    OutputArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
 
-int main() {
     backtest::DataHandler data;
     backtest::SMAStrategy strategy(3, 5);  // 3-day short, 5-day long MA
-    
-    if (!data.load_csv("../data/sample_data.csv", "SPY")) {
+    if (args.validate) {
+        backtest::ValidationConfig validation;
+        validation.calendar = args.calendar;
+        data.set_validation(validation);
+    }
+
+    if (!data.load_csv(args.data, "SPY", backtest::LoadMode::MemoryMapped)) {
         std::cout << "Failed to load data" << std::endl;
         return 1;
     }
-    
+    if (args.validate) {
+        backtest::print_quality_report(std::cout, args.data, data.last_quality_report());
+    }
+
     std::cout << "Running strategy: " << strategy.get_name() << std::endl;
     std::cout << "Loaded " << data.size() << " bars" << std::endl;
     std::cout << "----------------------------------------" << std::endl;
-    
-    while (data.has_next()) {
-        backtest::Bar bar = data.get_next_bar();
-        strategy.on_new_bar(bar);
-        backtest::Signal signal = strategy.generate_signal();
-        
-        std::string signal_str;
-        if (signal.type == backtest::SignalType::BUY) signal_str = "BUY ";
-        else if (signal.type == backtest::SignalType::SELL) signal_str = "SELL";
-        else signal_str = "HOLD";
-        
-        std::cout << bar.timestamp << " | Close: " << bar.close 
-                  << " | Signal: " << signal_str << std::endl;
-    }
-    
-    return 0;
+
+    // $1 per fill and 2 bps of slippage against every order
+    backtest::CostModelConfig costs;
+    costs.commission_per_order = 1.0;
+    costs.slippage_bps = 2.0;
+    backtest::SimulatedExecution execution(costs);
+    backtest::BacktestEngine engine(strategy, execution);
+    std::unique_ptr<backtest::Pipeline> pipeline;
+    if (args.pipeline) {
+        backtest::PipelineConfig config;
+        config.wait = args.wait;
+        pipeline = std::make_unique<backtest::Pipeline>(strategy, execution, config);
+    }
+
+    const bool resuming = !args.checkpoint.empty() && std::ifstream(args.checkpoint).good();
+    if (resuming) {
+        if (!backtest::load_checkpoint(args.checkpoint, engine, data)) {
+            return 1;
+        }
+        std::cout << "Resuming after bar " << data.position() << " from " << args.checkpoint << std::endl;
+    }
+
+    // Records are formatted into the writers' buffers, so no bar flushes or allocates
+    std::unique_ptr<backtest::RecordWriter> signals, fills, equity;
+    if (!open_records(args, backtest::RecordKind::Signals, args.quiet ? std::string() : args.signals, signals) ||
+        !open_records(args, backtest::RecordKind::Fills, args.fills, fills) ||
+        !open_records(args, backtest::RecordKind::Equity, args.equity, equity)) {
+        return 1;
+    }
+    auto install_listeners = [&](auto& runner) {
+        if (signals) {
+            runner.set_bar_listener([&](const backtest::Bar& bar, const backtest::Signal& signal) {
+                BT_PROFILE_SCOPE(Output);
+                signals->write_signal(bar, signal);
+            });
+        }
+        if (fills) {
+            runner.set_fill_listener([&](const backtest::FillEvent& fill) { fills->write_fill(fill); });
+        }
+    };
+    if (pipeline) {
+        install_listeners(*pipeline);
+        pipeline->run(data);
+    } else {
+        install_listeners(engine);
+        resuming ? engine.resume(data) : engine.run(data);
+    }
+    const backtest::EngineStats& stats = pipeline ? pipeline->engine_stats() : engine.stats();
+    const backtest::Portfolio& portfolio = pipeline ? pipeline->portfolio() : engine.portfolio();
+    const backtest::EquityCurve& curve = pipeline ? pipeline->equity_curve() : engine.equity_curve();
+    const backtest::PerformanceMetrics metrics = pipeline ? pipeline->metrics() : engine.metrics();
+    if (equity) {
+        equity->write_equity(curve);
+    }
+    bool written = close_records(signals);
+    written = close_records(fills) && written;
+    written = close_records(equity) && written;
+    if (!args.checkpoint.empty()) {
+        written = backtest::save_checkpoint(args.checkpoint, engine, data) && written;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout << "Fills: " << stats.fills << " | Commission: " << stats.commission
+              << " | Slippage: " << stats.slippage << std::endl;
+    std::cout << "Final value: " << portfolio.total_value()
+              << " | Realized P&L: " << portfolio.realized_pnl()
+              << " | Max drawdown: " << metrics.max_drawdown * 100.0 << "%" << std::endl;
+    backtest::print_performance(std::cout, metrics);
+    std::cout << "Processed " << stats.bars << " bars at " << stats.bars_per_second()
+              << " bars/s" << std::endl;
+    if (pipeline) {
+        backtest::print_pipeline_stats(std::cout, pipeline->stats());
+    }
+    if (args.precision_check) {
+        const bool checked = args.precision_ticks
+            ? precision_check<backtest::TickPriceCodec>(data.columns(), execution)
+            : precision_check<backtest::Float32PriceCodec>(data.columns(), execution);
+        if (!checked) {
+            return 1;
+        }
+    }
+
+    if (backtest::kInstrumentationEnabled) {
+        std::cout << "----------------------------------------" << std::endl;
+        backtest::print_profile_report(std::cout);
+    }
+
+    return written ? 0 : 1;
 }
-    
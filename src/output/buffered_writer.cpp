@@ -0,0 +1,176 @@
+/**
+ * @file buffered_writer.cpp
+ * @brief Chunk hand-off and the background writer thread
+ */
+
+#include "buffered_writer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace backtest {
+
+BufferedWriter::BufferedWriter(size_t chunk_bytes, bool background)
+    : chunk_bytes_(chunk_bytes == 0 ? kDefaultChunkBytes : chunk_bytes)
+    , background_(background)
+    , full_(kBackgroundChunks)
+    , empty_(kBackgroundChunks) {
+    const size_t count = background_ ? kBackgroundChunks : 1;
+    for (size_t i = 0; i < count; ++i) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->data.reset(new char[chunk_bytes_]);
+        chunks_.push_back(std::move(chunk));
+    }
+    current_ = chunks_[0].get();
+    for (size_t i = 1; i < count; ++i) {
+        empty_.try_push(chunks_[i].get());
+    }
+}
+
+BufferedWriter::~BufferedWriter() {
+    close();
+}
+
+bool BufferedWriter::open(const std::string& path) {
+    if (path == "-") {
+        return open_stdout();
+    }
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        std::cerr << "Error opening output file: " << path << std::endl;
+        return false;
+    }
+    // Writes are already chunked; a second copy through stdio's buffer is wasted work
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    owns_file_ = true;
+    start();
+    return true;
+}
+
+bool BufferedWriter::open_stdout() {
+    close();
+    file_ = stdout;
+    owns_file_ = false;
+    start();
+    return true;
+}
+
+void BufferedWriter::start() {
+    bytes_written_ = 0;
+    current_->size = 0;
+    failed_ = false;
+    stop_ = false;
+    if (background_) {
+        writer_ = std::thread([this]() { writer_loop(); });
+    }
+}
+
+void BufferedWriter::write(const char* data, size_t size) {
+    bytes_written_ += size;
+    while (size > 0) {
+        if (current_->size == chunk_bytes_) {
+            submit_current();
+        }
+        const size_t n = std::min(size, chunk_bytes_ - current_->size);
+        std::memcpy(current_->data.get() + current_->size, data, n);
+        current_->size += n;
+        data += n;
+        size -= n;
+    }
+}
+
+void BufferedWriter::submit_current() {
+    if (current_->size == 0) {
+        return;
+    }
+    if (file_ == nullptr) {
+        current_->size = 0;
+        return;
+    }
+    if (!background_) {
+        write_chunk(*current_);
+        current_->size = 0;
+        return;
+    }
+
+    // There are as many queue slots as chunks, so the push cannot fail
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    full_.try_push(current_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    work_.notify_one();
+
+    Chunk* next = nullptr;
+    while (!empty_.try_pop(next)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return !empty_.empty(); });
+    }
+    current_ = next;
+    current_->size = 0;
+}
+
+void BufferedWriter::write_chunk(const Chunk& chunk) {
+    if (std::fwrite(chunk.data.get(), 1, chunk.size, file_) != chunk.size) {
+        failed_ = true;
+    }
+}
+
+void BufferedWriter::writer_loop() {
+    for (;;) {
+        Chunk* chunk = nullptr;
+        if (full_.try_pop(chunk)) {
+            write_chunk(*chunk);
+            chunk->size = 0;
+            empty_.try_push(chunk);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            done_.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_ && full_.empty()) {
+            return;
+        }
+        work_.wait(lock, [this]() { return stop_ || !full_.empty(); });
+    }
+}
+
+void BufferedWriter::flush() {
+    if (file_ == nullptr) {
+        return;
+    }
+    submit_current();
+    if (background_) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return pending_.load(std::memory_order_relaxed) == 0; });
+    }
+    if (std::fflush(file_) != 0) {
+        failed_ = true;
+    }
+}
+
+bool BufferedWriter::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    flush();
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_.notify_all();
+        writer_.join();
+    }
+    if (owns_file_ && std::fclose(file_) != 0) {
+        failed_ = true;
+    }
+    file_ = nullptr;
+    owns_file_ = false;
+    return !failed_;
+}
+
+} // namespace backtest
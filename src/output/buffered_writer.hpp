@@ -0,0 +1,152 @@
+/**
+ * @file buffered_writer.hpp
+ * @brief Chunked output buffer with an optional background writer thread
+ */
+
+#ifndef BUFFERED_WRITER_HPP
+#define BUFFERED_WRITER_HPP
+#include "../util/spsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class BufferedWriter
+ * @brief Collects formatted output in large chunks and writes each chunk with one call
+ *
+ * Callers format records straight into the current chunk (reserve() and
+ * commit()), so a record costs a few stores instead of a stream insertion and
+ * a flush. A full chunk is written to the file synchronously, or, in
+ * background mode, handed to a writer thread through an SPSC queue while the
+ * caller continues in a spare chunk; the caller then only waits if the disk
+ * or pipe is slower than the run for several chunks in a row.
+ *
+ * Output reaches the file in order but only on chunk boundaries, flush() and
+ * close(). Flush before writing to the same stream by other means (e.g.
+ * std::cout when the writer targets stdout). Output written while no file is
+ * open is discarded.
+ */
+class BufferedWriter {
+public:
+    static constexpr size_t kDefaultChunkBytes = 64 * 1024;
+
+    /**
+     * @param chunk_bytes Size of each buffer chunk
+     * @param background Write full chunks on a dedicated thread
+     */
+    explicit BufferedWriter(size_t chunk_bytes = kDefaultChunkBytes, bool background = false);
+
+    /**
+     * @brief Closes the writer, writing any buffered output
+     */
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+     * @brief Creates or truncates a file for writing
+     * @param path File path, or "-" for standard output
+     * @return true if the file is open, false otherwise
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Writes to standard output (which is not closed by close())
+     */
+    bool open_stdout();
+
+    bool is_open() const { return file_ != nullptr; }
+
+    /**
+     * @brief Returns space for at least size bytes in the current chunk
+     * @param size Bytes the caller will write (at most chunk_bytes())
+     *
+     * Follow with commit() of the bytes actually written.
+     */
+    char* reserve(size_t size) {
+        if (current_->size + size > chunk_bytes_) {
+            submit_current();
+        }
+        return current_->data.get() + current_->size;
+    }
+
+    void commit(size_t size) {
+        current_->size += size;
+        bytes_written_ += size;
+    }
+
+    /**
+     * @brief Appends bytes of any length
+     */
+    void write(const char* data, size_t size);
+    void write(std::string_view text) { write(text.data(), text.size()); }
+
+    /**
+     * @brief Writes all buffered output to the file and flushes it
+     *
+     * In background mode this waits until the writer thread has drained.
+     */
+    void flush();
+
+    /**
+     * @brief Flushes, stops the writer thread and closes the file
+     * @return true if every write succeeded since open()
+     */
+    bool close();
+
+    /**
+     * @brief Bytes accepted since open()
+     */
+    uint64_t bytes_written() const { return bytes_written_; }
+
+    size_t chunk_bytes() const { return chunk_bytes_; }
+    bool background() const { return background_; }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    static constexpr size_t kBackgroundChunks = 4;  ///< Chunks in flight in background mode
+
+    void start();
+    void submit_current();
+    void write_chunk(const Chunk& chunk);
+    void writer_loop();
+
+    size_t chunk_bytes_;
+    bool background_;
+    std::FILE* file_ = nullptr;
+    bool owns_file_ = false;
+    uint64_t bytes_written_ = 0;
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;  ///< Every chunk; owned here, passed by pointer
+    Chunk* current_ = nullptr;                    ///< Chunk being filled by the caller
+
+    SpscQueue<Chunk*> full_;   ///< Caller -> writer thread
+    SpscQueue<Chunk*> empty_;  ///< Writer thread -> caller
+    std::thread writer_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<size_t> pending_{0};  ///< Chunks submitted but not yet written
+    std::mutex mutex_;                ///< Guards sleeping only; the queues are lock-free
+    std::condition_variable work_;    ///< Signalled when a chunk is submitted or on stop
+    std::condition_variable done_;    ///< Signalled when a chunk has been written
+};
+
+} // namespace backtest
+
+#endif // BUFFERED_WRITER_HPP
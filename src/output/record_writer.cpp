@@ -0,0 +1,215 @@
+/**
+ * @file record_writer.cpp
+ * @brief Record formatting for the text, CSV and binary output formats
+ */
+
+#include "record_writer.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace backtest {
+
+namespace {
+
+    char* append(char* p, std::string_view text) {
+        std::memcpy(p, text.data(), text.size());
+        return p + text.size();
+    }
+
+    /// Same digits as std::ostream's default formatting (%g, 6 significant digits)
+    char* append_short(char* p, double value) {
+        return std::to_chars(p, p + 32, value, std::chars_format::general, 6).ptr;
+    }
+
+    /// Shortest representation that reads back as the same double, without exponent where short
+    char* append_exact(char* p, double value) {
+        const double magnitude = std::fabs(value);
+        const bool plain = value == 0.0 || (magnitude >= 1e-4 && magnitude < 1e15);
+        return std::to_chars(p, p + 32, value, plain ? std::chars_format::fixed : std::chars_format::general).ptr;
+    }
+
+    char* append_int(char* p, long long value) {
+        return std::to_chars(p, p + 24, value).ptr;
+    }
+
+    const char* signal_label(SignalType type, bool padded) {
+        switch (type) {
+            case SignalType::BUY: return padded ? "BUY " : "BUY";
+            case SignalType::SELL: return "SELL";
+            case SignalType::HOLD: break;
+        }
+        return "HOLD";
+    }
+
+    uint32_t record_size(RecordKind kind) {
+        switch (kind) {
+            case RecordKind::Signals: return sizeof(SignalRecord);
+            case RecordKind::Fills: return sizeof(FillRecord);
+            case RecordKind::Equity: break;
+        }
+        return sizeof(EquityRecord);
+    }
+
+    const char* csv_header(RecordKind kind) {
+        switch (kind) {
+            case RecordKind::Signals: return "timestamp,symbol,close,signal,strength\n";
+            case RecordKind::Fills: return "timestamp,symbol,quantity,price,commission,slippage\n";
+            case RecordKind::Equity: break;
+        }
+        return "timestamp,equity\n";
+    }
+
+} // namespace
+
+bool parse_output_format(const std::string& name, OutputFormat& out) {
+    if (name == "text") {
+        out = OutputFormat::Text;
+    } else if (name == "csv") {
+        out = OutputFormat::Csv;
+    } else if (name == "binary") {
+        out = OutputFormat::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RecordWriter::RecordWriter(RecordKind kind, OutputFormat format, size_t chunk_bytes, bool background)
+    : kind_(kind)
+    , format_(format)
+    , out_(chunk_bytes < 2 * kMaxRecordBytes ? 2 * kMaxRecordBytes : chunk_bytes, background) {}
+
+bool RecordWriter::open(const std::string& path) {
+    if (!out_.open(path)) {
+        return false;
+    }
+    records_ = 0;
+    if (format_ == OutputFormat::Csv) {
+        out_.write(csv_header(kind_));
+    } else if (format_ == OutputFormat::Binary) {
+        RecordFileHeader header{};
+        header.magic = kRecordFileMagic;
+        header.version = kRecordFileVersion;
+        header.kind = static_cast<uint32_t>(kind_);
+        header.record_size = record_size(kind_);
+        header.byte_order = 0x01020304;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    return true;
+}
+
+const std::string& RecordWriter::name_of(SymbolId id) {
+    if (id != cached_id_) {
+        cached_name_ = &symbol_name(id);
+        cached_id_ = id;
+    }
+    return *cached_name_;
+}
+
+void RecordWriter::write_signal(const Bar& bar, const Signal& signal) {
+    if (kind_ != RecordKind::Signals) {
+        return;
+    }
+    if (format_ == OutputFormat::Binary) {
+        write_binary(SignalRecord{bar.timestamp, bar.symbol_id, static_cast<int32_t>(signal.type),
+                                  bar.close, signal.strength});
+        return;
+    }
+
+    const std::string& symbol = name_of(bar.symbol_id);
+    char* const start = out_.reserve(kMaxRecordBytes + symbol.size());
+    char* p = start + format_timestamp(bar.timestamp, start);
+    if (format_ == OutputFormat::Text) {
+        p = append(p, " | Close: ");
+        p = append_short(p, bar.close);
+        p = append(p, " | Signal: ");
+        p = append(p, signal_label(signal.type, true));
+    } else {
+        *p++ = ',';
+        p = append(p, symbol);
+        *p++ = ',';
+        p = append_exact(p, bar.close);
+        *p++ = ',';
+        p = append(p, signal_label(signal.type, false));
+        *p++ = ',';
+        p = append_exact(p, signal.strength);
+    }
+    *p++ = '\n';
+    out_.commit(static_cast<size_t>(p - start));
+    ++records_;
+}
+
+void RecordWriter::write_fill(const FillEvent& fill) {
+    if (kind_ != RecordKind::Fills) {
+        return;
+    }
+    if (format_ == OutputFormat::Binary) {
+        write_binary(FillRecord{fill.timestamp, fill.symbol_id, fill.quantity, fill.price, fill.commission,
+                                fill.slippage});
+        return;
+    }
+
+    const std::string& symbol = name_of(fill.symbol_id);
+    char* const start = out_.reserve(kMaxRecordBytes + symbol.size());
+    char* p = start + format_timestamp(fill.timestamp, start);
+    if (format_ == OutputFormat::Text) {
+        p = append(p, " | ");
+        p = append(p, fill.quantity > 0 ? "BUY  " : "SELL ");
+        p = append_int(p, fill.quantity > 0 ? fill.quantity : -static_cast<long long>(fill.quantity));
+        p = append(p, " ");
+        p = append(p, symbol);
+        p = append(p, " @ ");
+        p = append_short(p, fill.price);
+        p = append(p, " | Commission: ");
+        p = append_short(p, fill.commission);
+        p = append(p, " | Slippage: ");
+        p = append_short(p, fill.slippage);
+    } else {
+        *p++ = ',';
+        p = append(p, symbol);
+        *p++ = ',';
+        p = append_int(p, fill.quantity);
+        *p++ = ',';
+        p = append_exact(p, fill.price);
+        *p++ = ',';
+        p = append_exact(p, fill.commission);
+        *p++ = ',';
+        p = append_exact(p, fill.slippage);
+    }
+    *p++ = '\n';
+    out_.commit(static_cast<size_t>(p - start));
+    ++records_;
+}
+
+void RecordWriter::write_equity(Timestamp timestamp, double value) {
+    if (kind_ != RecordKind::Equity) {
+        return;
+    }
+    if (format_ == OutputFormat::Binary) {
+        write_binary(EquityRecord{timestamp, value});
+        return;
+    }
+
+    char* const start = out_.reserve(kMaxRecordBytes);
+    char* p = start + format_timestamp(timestamp, start);
+    if (format_ == OutputFormat::Text) {
+        p = append(p, " | Equity: ");
+        p = append_short(p, value);
+    } else {
+        *p++ = ',';
+        p = append_exact(p, value);
+    }
+    *p++ = '\n';
+    out_.commit(static_cast<size_t>(p - start));
+    ++records_;
+}
+
+void RecordWriter::write_equity(const EquityCurve& curve) {
+    const Span<const Timestamp> timestamps = curve.timestamps();
+    const Span<const double> values = curve.values();
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        write_equity(timestamps[i], values[i]);
+    }
+}
+
+} // namespace backtest
@@ -0,0 +1,185 @@
+/**
+ * @file record_writer.hpp
+ * @brief Text, CSV and binary writers for signals, fills and equity curves
+ *
+ * Each RecordWriter produces one file of one record kind. Text is the
+ * human-readable console format of the backtest driver, CSV has a header row
+ * and round-trip precision, and Binary is a RecordFileHeader followed by
+ * fixed-size structs, for tools that load results without parsing.
+ *
+ * Binary layout (native byte order):
+ *
+ *   RecordFileHeader
+ *   record_count x SignalRecord | FillRecord | EquityRecord (per header.kind)
+ *
+ * Symbols are written as SymbolId values of the producing run.
+ */
+
+#ifndef RECORD_WRITER_HPP
+#define RECORD_WRITER_HPP
+#include "buffered_writer.hpp"
+#include "../data/market_data.hpp"
+#include "../engine/equity_curve.hpp"
+#include "../engine/event.hpp"
+#include "../strategy/strategy_base.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace backtest {
+
+/**
+ * @enum OutputFormat
+ * @brief Encoding of a RecordWriter's file
+ */
+enum class OutputFormat {
+    Text,   ///< Console lines ("<time> | Close: <close> | Signal: BUY ")
+    Csv,    ///< Header row, then one comma-separated row per record
+    Binary  ///< RecordFileHeader, then packed records
+};
+
+/**
+ * @enum RecordKind
+ * @brief What a RecordWriter's file contains
+ */
+enum class RecordKind : uint32_t {
+    Signals = 1,  ///< One record per bar: close and the strategy's signal
+    Fills = 2,    ///< One record per fill
+    Equity = 3    ///< One record per bar: portfolio value
+};
+
+/**
+ * @brief Parses "text", "csv" or "binary"
+ * @return true if name is a known format
+ */
+bool parse_output_format(const std::string& name, OutputFormat& out);
+
+/// File signature of a binary record file (the bytes "BTRECORD" read as a little-endian integer)
+constexpr uint64_t kRecordFileMagic = 0x44524f4345525442ULL;
+
+/// Binary format version; bumped whenever a record layout changes
+constexpr uint32_t kRecordFileVersion = 1;
+
+/**
+ * @struct RecordFileHeader
+ * @brief Fixed-size header at offset 0 of a binary record file
+ */
+struct RecordFileHeader {
+    uint64_t magic;        ///< kRecordFileMagic
+    uint32_t version;      ///< kRecordFileVersion
+    uint32_t kind;         ///< RecordKind
+    uint32_t record_size;  ///< sizeof the record struct of kind
+    uint32_t byte_order;   ///< 0x01020304 as written by the producing machine
+};
+
+/**
+ * @struct SignalRecord
+ * @brief Binary form of one bar's signal
+ */
+struct SignalRecord {
+    int64_t timestamp;   ///< Bar time, ns since epoch
+    uint32_t symbol_id;  ///< SymbolId of the bar
+    int32_t signal;      ///< SignalType as an integer
+    double close;        ///< Closing price of the bar
+    double strength;     ///< Signal strength
+};
+
+/**
+ * @struct FillRecord
+ * @brief Binary form of one fill
+ */
+struct FillRecord {
+    int64_t timestamp;   ///< Fill time, ns since epoch
+    uint32_t symbol_id;  ///< SymbolId of the instrument
+    int32_t quantity;    ///< Signed shares: positive bought, negative sold
+    double price;        ///< Execution price per share
+    double commission;   ///< Commission charged
+    double slippage;     ///< Cost of slippage against the reference price
+};
+
+/**
+ * @struct EquityRecord
+ * @brief Binary form of one equity curve sample
+ */
+struct EquityRecord {
+    int64_t timestamp;  ///< Bar time, ns since epoch
+    double value;       ///< Portfolio total value
+};
+
+/**
+ * @class RecordWriter
+ * @brief Formats records of one kind into a BufferedWriter
+ *
+ * Records are formatted in place in the writer's chunk with std::to_chars
+ * and the allocation-free format_timestamp(), so writing a record never
+ * allocates or flushes. Writing a record of another kind than the writer's
+ * is a no-op.
+ */
+class RecordWriter {
+public:
+    /**
+     * @param kind Records this writer accepts
+     * @param format Encoding of the file
+     * @param chunk_bytes Buffer chunk size (see BufferedWriter)
+     * @param background Write chunks on a background thread
+     */
+    RecordWriter(RecordKind kind, OutputFormat format,
+                 size_t chunk_bytes = BufferedWriter::kDefaultChunkBytes, bool background = false);
+
+    /**
+     * @brief Creates or truncates path ("-" for standard output) and writes the header
+     * @return true if the file is open, false otherwise
+     */
+    bool open(const std::string& path);
+
+    void write_signal(const Bar& bar, const Signal& signal);
+    void write_fill(const FillEvent& fill);
+    void write_equity(Timestamp timestamp, double value);
+
+    /**
+     * @brief Writes every sample of a recorded equity curve
+     */
+    void write_equity(const EquityCurve& curve);
+
+    /**
+     * @brief Writes buffered records to the file
+     */
+    void flush() { out_.flush(); }
+
+    /**
+     * @brief Flushes and closes the file
+     * @return true if every write succeeded
+     */
+    bool close() { return out_.close(); }
+
+    RecordKind kind() const { return kind_; }
+    OutputFormat format() const { return format_; }
+    size_t records() const { return records_; }
+    uint64_t bytes_written() const { return out_.bytes_written(); }
+
+private:
+    /// Upper bound of one formatted text or CSV record, excluding the symbol name
+    static constexpr size_t kMaxRecordBytes = 256;
+
+    const std::string& name_of(SymbolId id);
+
+    template <typename Record>
+    void write_binary(const Record& record) {
+        char* p = out_.reserve(sizeof(Record));
+        std::memcpy(p, &record, sizeof(Record));
+        out_.commit(sizeof(Record));
+        ++records_;
+    }
+
+    RecordKind kind_;
+    OutputFormat format_;
+    BufferedWriter out_;
+    size_t records_ = 0;
+    SymbolId cached_id_ = kInvalidSymbol;    ///< Last symbol looked up by name_of()
+    const std::string* cached_name_ = nullptr;
+};
+
+} // namespace backtest
+
+#endif // RECORD_WRITER_HPP
@@ -1,112 +1,234 @@
 #include "portfolio.hpp"
+#include "../util/profiler.hpp"
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
 
 namespace backtest {
 
-Portfolio::Portfolio(double initial_capital)
+Portfolio::Portfolio(double initial_capital, std::pmr::memory_resource* resource)
     : initial_capital_(initial_capital)
     , cash_(initial_capital)
-    , realized_pnl_(0.0) {
+    , realized_pnl_(0.0)
+    , positions_(resource) {
 
 }
 
-void Portfolio::open_position(const std::string& symbol, int quantity, double price, double commission) {
-    // TODO: Implement this function
-    // Follow the steps in the header file comments
-    
-    // Step 1: Calculate cost
+void Portfolio::open_position(SymbolId symbol, int quantity, double price, double commission) {
+    BT_PROFILE_SCOPE(Portfolio);
+    // Cost of the fill plus commission leaves cash
     double cost = std::abs(quantity * price) + commission;
-    
-    // Step 2: Deduct from cash
     cash_ -= cost;
-    
-    
-    // Step 3-5: Handle position creation/update
-    if (has_position(symbol)) {
-        // Step 4: Position exists - adjust quantity
-        positions_.at(symbol).adjust_quantity(quantity, price);
+
+    // One lookup: adjust the existing position or add a new one
+    if (Position* pos = positions_.find(symbol)) {
+        const Contribution before = contribution(*pos);
+        pos->adjust_quantity(quantity, price);
+        apply_delta(before, contribution(*pos));
+        if (pos->is_flat()) {
+            positions_.erase(symbol);  // e.g. a buy that exactly covers a short
+        }
     } else {
-        // Step 5: New position - create and add to map
-        positions_.emplace(symbol, Position(symbol, quantity, price));
+        const Position& added = positions_.insert(Position(symbol, quantity, price));
+        apply_delta(Contribution{0.0, 0.0, 0.0}, contribution(added));
     }
+    after_mutation();
 }
 
-void Portfolio::close_position(const std::string& symbol, int quantity, double price, double commission) {
-    // TODO: Implement this function
-    // Follow the steps in the header file comments
-    
-    // Step 1: Check if position exists
-    if (has_position(symbol) == false) {
+void Portfolio::open_position(const std::string& symbol, int quantity, double price, double commission) {
+    open_position(intern_symbol(symbol), quantity, price, commission);
+}
+
+void Portfolio::close_position(SymbolId symbol, int quantity, double price, double commission) {
+    BT_PROFILE_SCOPE(Portfolio);
+    Position* pos = positions_.find(symbol);
+    if (pos == nullptr) {
         return;  // Nothing to close
     }
-    
-    // Step 2: Get position reference
-    Position& pos = positions_.at(symbol);
-    double pnl = (price - pos.entry_price()) * quantity;    // Step 3: Calculate realized P&L
-    
-    // Step 4: Update realized_pnl_
+
+    // Realized P&L against the average entry price
+    double pnl = (price - pos->entry_price()) * quantity;
     realized_pnl_ += pnl;
-    
-    // Step 5: Calculate proceeds
+
+    // Proceeds net of commission
     double proceeds = std::abs(quantity * price) - commission;
-    
-    // Step 6: Add to cash
     cash_ += proceeds;
-    
-    
-    // Step 7: Adjust position
-    pos.adjust_quantity(-quantity, price);
-    
-    // Step 8: Remove if flat
-    if (pos.is_flat()) {
+
+    // Reduce, and drop the slot once flat
+    const Contribution before = contribution(*pos);
+    pos->adjust_quantity(-quantity, price);
+    apply_delta(before, contribution(*pos));
+    if (pos->is_flat()) {
         positions_.erase(symbol);
     }
+    after_mutation();
+}
+
+void Portfolio::close_position(const std::string& symbol, int quantity, double price, double commission) {
+    const SymbolId id = SymbolTable::global().find(symbol);
+    if (id != kInvalidSymbol) {
+        close_position(id, quantity, price, commission);
+    }
 }
 
 void Portfolio::update_prices(const Bar& bar) {
-    // TODO: Implement this function
-    // Check if position exists, then update its price
-    if (has_position(bar.symbol)){
-        positions_.at(bar.symbol).update_price(bar.close);
+    update_price(bar.symbol_id, bar.close);
+}
+
+void Portfolio::update_prices(Span<const PriceUpdate> updates) {
+    BT_PROFILE_SCOPE(Portfolio);
+    double gross = 0.0;
+    double net = 0.0;
+    double unrealized = 0.0;
+    bool marked = false;
+    for (const PriceUpdate& update : updates) {
+        Position* pos = positions_.find(update.symbol_id);
+        if (pos == nullptr) {
+            continue;
+        }
+        // Entry price and quantity are unchanged, so value and P&L move by the same amount
+        const double quantity = pos->quantity();
+        const double old_value = quantity * pos->current_price();
+        pos->update_price(update.price);
+        const double new_value = quantity * pos->current_price();  // As stored (PositionPrice)
+        gross += std::abs(new_value) - std::abs(old_value);
+        net += new_value - old_value;
+        unrealized += new_value - old_value;
+        marked = true;
+    }
+    if (marked) {
+        apply_delta(Contribution{0.0, 0.0, 0.0}, Contribution{gross, net, unrealized});
+        after_mutation();
+    }
+}
+
+void Portfolio::update_price(SymbolId symbol, double price) {
+    BT_PROFILE_SCOPE(Portfolio);
+    if (Position* pos = positions_.find(symbol)) {
+        const Contribution before = contribution(*pos);
+        pos->update_price(price);
+        apply_delta(before, contribution(*pos));
+        after_mutation();
     }
+}
 
+void Portfolio::update_price(const std::string& symbol, double price) {
+    const SymbolId id = SymbolTable::global().find(symbol);
+    if (id != kInvalidSymbol) {
+        update_price(id, price);
+    }
 }
 
 bool Portfolio::has_position(const std::string& symbol) const {
-    // TODO: Implement this function
-    // Use positions_.find(symbol) != positions_.end()
-    return positions_.find(symbol) != positions_.end();
+    const SymbolId id = SymbolTable::global().find(symbol);
+    return id != kInvalidSymbol && positions_.contains(id);
 }
 
 const Position* Portfolio::get_position(const std::string& symbol) const {
-    auto it = positions_.find(symbol);
-    return (it != positions_.end()) ? &it->second : nullptr;
+    const SymbolId id = SymbolTable::global().find(symbol);
+    return id != kInvalidSymbol ? positions_.find(id) : nullptr;
 }
 
-double Portfolio::total_value() const {
-    // TODO: Implement this function
-    // Sum cash plus all position market values
-    auto it = positions_.begin();
-    double total = cash_;
-    for (; it != positions_.end(); ++it){
-        total += it->second.market_value();
+Portfolio::Contribution Portfolio::contribution(const Position& pos) {
+    const double value = pos.market_value();
+    return Contribution{std::abs(value), value, pos.unrealized_pnl()};
+}
+
+void Portfolio::apply_delta(const Contribution& before, const Contribution& after) {
+    prefix_add(gross_, after.gross - before.gross);
+    prefix_add(net_, after.net - before.net);
+    prefix_add(unrealized_, after.unrealized - before.unrealized);
+}
+
+void Portfolio::after_mutation() {
+    ++mutations_;
+    if (positions_.empty()) {
+        gross_ = PrefixSum{};
+        net_ = PrefixSum{};
+        unrealized_ = PrefixSum{};
+    } else if (mutations_ % kPrefixRenormalizePeriod == 0) {
+        prefix_renormalize(gross_);
+        prefix_renormalize(net_);
+        prefix_renormalize(unrealized_);
     }
-    return total;
+#ifndef NDEBUG
+    // Full recomputation is O(positions); sample it so debug runs stay usable
+    constexpr size_t kCheckPeriod = 64;
+    if (mutations_ % kCheckPeriod == 0) {
+        assert(check_aggregates(1e-6) && "Portfolio running totals drifted from recomputation");
     }
+#endif
+}
 
-double Portfolio::total_pnl() const {
-    // Total P&L = realized + unrealized
-    return realized_pnl_ + unrealized_pnl();
+bool Portfolio::check_aggregates(double tolerance) const {
+    double gross = 0.0;
+    double net = 0.0;
+    double unrealized = 0.0;
+    for (const Position& pos : positions_) {
+        const Contribution c = contribution(pos);
+        gross += c.gross;
+        net += c.net;
+        unrealized += c.unrealized;
+    }
+    const double limit = tolerance * std::max(gross, 1.0);
+    return std::abs(gross - gross_market_value()) <= limit &&
+           std::abs(net - net_exposure()) <= limit &&
+           std::abs(unrealized - unrealized_pnl()) <= limit;
+}
+
+void Portfolio::save_state(SnapshotWriter& out) const {
+    out.put(initial_capital_);
+    out.put(cash_);
+    out.put(realized_pnl_);
+    out.put(static_cast<uint64_t>(positions_.size()));
+    for (const Position& pos : positions_) {
+        out.put_string(symbol_name(pos.symbol_id()));
+        out.put(static_cast<int32_t>(pos.quantity()));
+        out.put(pos.entry_price());
+        out.put(pos.current_price());
+    }
+    out.put(gross_);
+    out.put(net_);
+    out.put(unrealized_);
+    out.put(static_cast<uint64_t>(mutations_));
 }
 
-double Portfolio::unrealized_pnl() const {
-    // TODO: Implement this function
-    // Sum unrealized P&L from all positions
-    double pnl = 0.0;
-    for (const auto& [symbol, pos] : positions_) {
-        pnl += pos.unrealized_pnl();
+bool Portfolio::load_state(SnapshotReader& in) {
+    Portfolio restored(0.0, positions_.resource());
+    uint64_t count = 0;
+    if (!in.get(restored.initial_capital_) || !in.get(restored.cash_) ||
+        !in.get(restored.realized_pnl_) || !in.get(count)) {
+        return false;
+    }
+
+    std::string name;
+    for (uint64_t i = 0; i < count; ++i) {
+        int32_t quantity = 0;
+        double entry_price = 0.0;
+        double current_price = 0.0;
+        if (!in.get_string(name) || !in.get(quantity) || !in.get(entry_price) || !in.get(current_price)) {
+            return false;
+        }
+        const SymbolId symbol = intern_symbol(name);
+        if (quantity == 0 || restored.positions_.contains(symbol)) {
+            in.fail();
+            return false;
+        }
+        Position& pos = restored.positions_.insert(Position(symbol, quantity, entry_price));
+        pos.update_price(current_price);
+    }
+
+    uint64_t mutations = 0;
+    if (!in.get(restored.gross_) || !in.get(restored.net_) || !in.get(restored.unrealized_) ||
+        !in.get(mutations)) {
+        return false;
     }
-    return pnl;
+    restored.mutations_ = static_cast<size_t>(mutations);
+    *this = std::move(restored);
+    return true;
 }
 
 } // namespace backtest
\ No newline at end of file
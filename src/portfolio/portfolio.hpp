@@ -2,12 +2,24 @@
 #define PORTFOLIO_HPP
 
 #include "position.hpp"
+#include "position_book.hpp"
 #include "../data/market_data.hpp"
-#include <map>
+#include "../indicators/rolling_sum.hpp"
+#include "../util/snapshot.hpp"
+#include "../util/span.hpp"
+#include <memory_resource>
 #include <string>
 
 namespace backtest {
 
+/**
+ * @brief Latest price of one symbol, as passed to Portfolio::update_prices()
+ */
+struct PriceUpdate {
+    SymbolId symbol_id;  ///< Interned ticker symbol
+    double price;        ///< Latest market price
+};
+
 /**
  * @brief Manages portfolio of positions and cash balance
  * 
@@ -18,128 +30,192 @@ namespace backtest {
  * - Unrealized P&L (from open positions)
  * 
  * Total Portfolio Value = Cash + Sum of all position market values
+ *
+ * Positions are kept in a PositionBook indexed by interned SymbolId. The
+ * SymbolId overloads do a single O(1) lookup per call; the std::string
+ * overloads resolve the name through the symbol table first and are meant
+ * for setup code rather than per-bar loops.
+ *
+ * Gross market value, net exposure and unrealized P&L are maintained as
+ * running totals: every fill or mark applies the change of the affected
+ * position's contribution, so the valuation queries are O(1) however many
+ * positions are open. The totals use compensated summation and are reset
+ * exactly whenever the book becomes empty. Debug builds (without NDEBUG)
+ * periodically assert that they match a full recomputation.
  */
 class Portfolio {
 public:
     /**
      * @brief Construct portfolio with initial capital
      * @param initial_capital Starting cash amount
+     * @param resource Memory resource for the position book
      */
-    explicit Portfolio(double initial_capital);
+    explicit Portfolio(double initial_capital,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     
     /**
      * @brief Open or add to a position
-     * @param symbol Ticker symbol
+     * @param symbol Interned ticker symbol
      * @param quantity Number of shares (positive = buy, negative = short)
      * @param price Execution price
      * @param commission Transaction cost (default 0)
      * 
-     * TODO: Implement this function
-     * Steps:
-     * 1. Calculate total cost: abs(quantity * price) + commission
-     * 2. Deduct from cash: cash_ -= cost
-     * 3. Check if position already exists (use has_position())
-     * 4. If exists: call positions_.at(symbol).adjust_quantity(quantity, price)
-     * 5. If new: create new Position and add to positions_ map
-     *    Use: positions_.emplace(symbol, Position(symbol, quantity, price))
+     * Deducts abs(quantity * price) + commission from cash, then either
+     * adjusts the existing position (averaging the entry price when adding)
+     * or creates a new one.
      */
+    void open_position(SymbolId symbol, int quantity, double price, double commission = 0.0);
     void open_position(const std::string& symbol, int quantity, double price, double commission = 0.0);
     
     /**
      * @brief Close or reduce a position
-     * @param symbol Ticker symbol
+     * @param symbol Interned ticker symbol
      * @param quantity Number of shares to close
      * @param price Execution price
      * @param commission Transaction cost (default 0)
      * 
-     * TODO: Implement this function
-     * Steps:
-     * 1. Check if position exists (if not, return early)
-     * 2. Get reference to position: Position& pos = positions_.at(symbol)
-     * 3. Calculate realized P&L: (price - pos.entry_price()) * quantity
-     * 4. Add to realized_pnl_: realized_pnl_ += pnl
-     * 5. Calculate proceeds: abs(quantity * price) - commission
-     * 6. Add to cash: cash_ += proceeds
-     * 7. Adjust position: pos.adjust_quantity(-quantity, price)
-     * 8. If position is now flat (pos.is_flat()), remove from map:
-     *    positions_.erase(symbol)
+     * Does nothing if the symbol is not held. Otherwise books
+     * (price - entry_price) * quantity as realized P&L, credits
+     * abs(quantity * price) - commission to cash, reduces the position and
+     * removes it once flat.
      */
+    void close_position(SymbolId symbol, int quantity, double price, double commission = 0.0);
     void close_position(const std::string& symbol, int quantity, double price, double commission = 0.0);
     
     /**
      * @brief Update position prices with new market data
      * @param bar Market data bar
-     * 
-     * TODO: Implement this function
-     * Steps:
-     * 1. Check if we have a position in this symbol (use has_position())
-     * 2. If yes, update its price: positions_.at(bar.symbol).update_price(bar.close)
+     *
+     * Marks the position in bar.symbol_id at bar.close, if held.
      */
     void update_prices(const Bar& bar);
+
+    /**
+     * @brief Marks a cross-section of symbols in one pass
+     * @param updates (symbol, price) pairs, e.g. every bar of one timestamp
+     *
+     * Symbols that are not held are skipped. Aggregate deltas are summed
+     * locally and applied to the running totals once for the whole batch,
+     * instead of once per symbol as with update_price(). If a symbol appears
+     * more than once, its last price wins.
+     */
+    void update_prices(Span<const PriceUpdate> updates);
+
+    /**
+     * @brief Update the price of one symbol's position, if held
+     * @param symbol Ticker symbol
+     * @param price Latest market price
+     */
+    void update_price(SymbolId symbol, double price);
+    void update_price(const std::string& symbol, double price);
     
     /**
      * @brief Check if portfolio has a position in symbol
      * @param symbol Ticker to check
      * @return true if position exists
-     * 
-     * TODO: Implement this function
-     * Hint: Use positions_.find(symbol) != positions_.end()
      */
+    bool has_position(SymbolId symbol) const { return positions_.contains(symbol); }
     bool has_position(const std::string& symbol) const;
     
     /**
      * @brief Get pointer to position (or nullptr if doesn't exist)
      * @param symbol Ticker symbol
-     * @return Pointer to Position or nullptr
+     * @return Pointer to Position or nullptr; invalidated when positions are opened or closed
      */
+    const Position* get_position(SymbolId symbol) const { return positions_.find(symbol); }
     const Position* get_position(const std::string& symbol) const;
     
     // Simple getters (already implemented)
     double cash() const { return cash_; }
     double realized_pnl() const { return realized_pnl_; }
-    const std::map<std::string, Position>& positions() const { return positions_; }
+    const PositionBook& positions() const { return positions_; }
     
     /**
      * @brief Calculate total portfolio value
-     * @return Cash + sum of all position market values
-     * 
-     * TODO: Implement this function
-     * Steps:
-     * 1. Start with value = cash_
-     * 2. Loop through all positions (use range-based for loop)
-     *    for (const auto& [symbol, pos] : positions_) { ... }
-     * 3. Add each position's market value: value += pos.market_value()
-     * 4. Return total value
-     */
-    double total_value() const;
+     * @return Cash + sum of all position market values, in O(1)
+     */
+    double total_value() const { return cash_ + net_exposure(); }
     
     /**
      * @brief Calculate total P&L (realized + unrealized)
      * @return Total profit/loss
-     * 
-     * TODO: Implement this function
-     * Formula: realized_pnl_ + unrealized_pnl()
      */
-    double total_pnl() const;
+    double total_pnl() const { return realized_pnl_ + unrealized_pnl(); }
     
     /**
-     * @brief Calculate unrealized P&L across all positions
-     * @return Sum of unrealized P&L from all open positions
-     * 
-     * TODO: Implement this function
-     * Steps:
-     * 1. Initialize pnl = 0.0
-     * 2. Loop through positions
-     * 3. Add each position's unrealized P&L: pnl += pos.unrealized_pnl()
-     * 4. Return total
+     * @brief Unrealized P&L across all positions, in O(1)
+     * @return Sum of (current_price - entry_price) * quantity over open positions
      */
-    double unrealized_pnl() const;
+    double unrealized_pnl() const { return total(unrealized_); }
+
+    /**
+     * @brief Sum of absolute position market values (longs + |shorts|), in O(1)
+     */
+    double gross_market_value() const { return total(gross_); }
+
+    /**
+     * @brief Sum of signed position market values (longs - |shorts|), in O(1)
+     */
+    double net_exposure() const { return total(net_); }
+
+    /**
+     * @brief Compares the running totals with a full recomputation over all positions
+     * @param tolerance Allowed difference relative to the gross market value (at least 1.0)
+     * @return true if every total is within tolerance
+     */
+    bool check_aggregates(double tolerance = 1e-9) const;
+
+    /**
+     * @brief Appends capital, cash, realized P&L, the positions and the running totals
+     *
+     * Positions are saved by symbol name, since SymbolIds are only
+     * meaningful within one process.
+     */
+    void save_state(SnapshotWriter& out) const;
+
+    /**
+     * @brief Replaces the whole state with one written by save_state()
+     * @return false, leaving the portfolio unchanged, if the snapshot is truncated or invalid
+     *
+     * The running totals are restored as saved rather than recomputed, so a
+     * restored portfolio values every later bar exactly like the original.
+     * Symbols are interned in the global table.
+     */
+    bool load_state(SnapshotReader& in);
 
 private:
     double initial_capital_;    // Starting cash
     double cash_;               // Current cash available
     double realized_pnl_;       // Locked-in profits/losses
-    std::map<std::string, Position> positions_;  // All open positions
+    PositionBook positions_;    // All open positions, indexed by SymbolId
+
+    // Running totals over positions_ (compensated sums)
+    PrefixSum gross_;           // Sum of |market value|
+    PrefixSum net_;             // Sum of market value
+    PrefixSum unrealized_;      // Sum of unrealized P&L
+    size_t mutations_ = 0;      // Fills and marks applied (drives the debug cross-check)
+
+    /**
+     * @brief Contribution of one position to the running totals
+     */
+    struct Contribution {
+        double gross;
+        double net;
+        double unrealized;
+    };
+
+    static Contribution contribution(const Position& pos);
+    static double total(const PrefixSum& p) { return p.sum + p.comp; }
+
+    /**
+     * @brief Replaces a position's old contribution with its new one
+     */
+    void apply_delta(const Contribution& before, const Contribution& after);
+
+    /**
+     * @brief Resets the totals if the book is empty and runs the debug cross-check
+     */
+    void after_mutation();
 };
 
 } // namespace backtest
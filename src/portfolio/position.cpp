@@ -17,20 +17,26 @@ namespace backtest {
 
 /**
  * @brief Initializes a new position with given parameters
- * @param symbol Ticker symbol
+ * @param symbol_id Interned ticker symbol
  * @param quantity Initial number of shares
  * @param entry_price Initial entry price
  * 
  * Sets the current price equal to entry price initially.
  */
-Position::Position(const std::string& symbol, int quantity, double entry_price)
-    : symbol_(symbol)
+Position::Position(SymbolId symbol_id, int quantity, double entry_price)
+    : symbol_id_(symbol_id)
     , quantity_(quantity)
-    , entry_price_(entry_price)
-    , current_price_(entry_price) {
+    , entry_price_(static_cast<PositionPrice>(entry_price))
+    , current_price_(static_cast<PositionPrice>(entry_price)) {
     // All member variables initialized in initializer list
 }
 
+/**
+ * @brief Convenience constructor that interns the ticker symbol
+ */
+Position::Position(const std::string& symbol, int quantity, double entry_price)
+    : Position(intern_symbol(symbol), quantity, entry_price) {}
+
 
 // ============================================================================
 // PRICE UPDATE
@@ -48,7 +54,7 @@ Position::Position(const std::string& symbol, int quantity, double entry_price)
  */
 void Position::update_price(double current_price) {
     // TODO: Update current_price_ with the new price
-    current_price_ = current_price;
+    current_price_ = static_cast<PositionPrice>(current_price);
 }
 
 
@@ -104,9 +110,9 @@ void Position::adjust_quantity(int quantity_change, double price) {
     
     // TODO: Step 2 - If adding to position, recalculate average entry price
     if (adding) {
-        double total_cost = (quantity_ * entry_price_) + (quantity_change * price);
+        double total_cost = (quantity_ * entry_price()) + (quantity_change * price);
         quantity_ += quantity_change;
-        entry_price_ = total_cost / quantity_;
+        entry_price_ = static_cast<PositionPrice>(total_cost / quantity_);
     }
     
     // TODO: Step 3 - If reducing position, just update quantity
@@ -116,11 +122,11 @@ void Position::adjust_quantity(int quantity_change, double price) {
     
     // TODO: Step 4 - Handle complete close (quantity becomes 0)
     if (quantity_ == 0) {
-        entry_price_ = 0.0;
+        entry_price_ = 0;
     }
     
     // TODO: Step 5 - Always update current price
-    current_price_ = price;
+    current_price_ = static_cast<PositionPrice>(price);
 }
 
 
@@ -144,7 +150,7 @@ void Position::adjust_quantity(int quantity_change, double price) {
  */
 double Position::market_value() const {
     // TODO: Calculate and return market value
-    return quantity_ * current_price_;
+    return quantity_ * current_price();
 }
 
 
@@ -176,7 +182,7 @@ double Position::unrealized_pnl() const {
     // TODO: Step 2 - Calculate unrealized P&L
 
    
-    return (current_price_ - entry_price_) * quantity_;
+    return (current_price() - entry_price()) * quantity_;
 }
 
 
@@ -198,7 +204,7 @@ double Position::unrealized_pnl() const {
  */
 double Position::cost_basis() const {
     // TODO: Calculate absolute cost basis
-    return std::abs(quantity_ * entry_price_);
+    return std::abs(quantity_ * entry_price());
 }
 
 } // namespace backtest
@@ -2,6 +2,8 @@
 #define POSITION_HPP
 
 #include <string>
+#include "../data/price_codec.hpp"
+#include "../data/symbol_table.hpp"
 
 namespace backtest {
 
@@ -9,10 +11,15 @@ namespace backtest {
  * @brief Represents a trading position in a single security
  * 
  * Tracks quantity, entry price, current price, and calculates P&L.
- * Supports both long and short positions.
+ * Supports both long and short positions. The security is identified by
+ * its interned SymbolId, so a Position is a small trivially copyable record.
+ * Prices are stored as PositionPrice (float in BACKTEST_PRICE_STORAGE=float
+ * builds, making a Position 16 bytes instead of 24) and all P&L arithmetic
+ * is done in double.
  */
 class Position {
 public:
+    Position(SymbolId symbol_id, int quantity, double entry_price);
     Position(const std::string& symbol, int quantity, double entry_price);
     
     // Update current market price
@@ -22,10 +29,11 @@ public:
     void adjust_quantity(int quantity_change, double price);
     
     // Getters
-    std::string symbol() const { return symbol_; }
+    SymbolId symbol_id() const { return symbol_id_; }
+    const std::string& symbol() const { return symbol_name(symbol_id_); }  // Takes the symbol table lock
     int quantity() const { return quantity_; }
-    double entry_price() const { return entry_price_; }
-    double current_price() const { return current_price_; }
+    double entry_price() const { return static_cast<double>(entry_price_); }
+    double current_price() const { return static_cast<double>(current_price_); }
     
     // P&L calculations
     double market_value() const;          // Current value
@@ -36,10 +44,10 @@ public:
     bool is_flat() const { return quantity_ == 0; }
 
 private:
-    std::string symbol_;
+    SymbolId symbol_id_;
     int quantity_;           // Positive = long, negative = short
-    double entry_price_;     // Average entry price
-    double current_price_;   // Latest market price
+    PositionPrice entry_price_;     // Average entry price
+    PositionPrice current_price_;   // Latest market price
 };
 
 } // namespace backtest
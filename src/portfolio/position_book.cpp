@@ -0,0 +1,42 @@
+/**
+ * @file position_book.cpp
+ * @brief Implementation of the symbol-id indexed position storage
+ */
+
+#include "position_book.hpp"
+
+namespace backtest {
+
+Position& PositionBook::insert(const Position& position) {
+    const SymbolId symbol = position.symbol_id();
+    if (symbol >= slots_.size()) {
+        slots_.resize(static_cast<size_t>(symbol) + 1, kNoSlot);
+    }
+    slots_[symbol] = static_cast<uint32_t>(positions_.size());
+    positions_.push_back(position);
+    return positions_.back();
+}
+
+void PositionBook::erase(SymbolId symbol) {
+    const uint32_t slot = slot_of(symbol);
+    if (slot == kNoSlot) {
+        return;
+    }
+    // Keep storage packed: the last position takes over the freed slot
+    const uint32_t last = static_cast<uint32_t>(positions_.size() - 1);
+    if (slot != last) {
+        positions_[slot] = positions_[last];
+        slots_[positions_[slot].symbol_id()] = slot;
+    }
+    positions_.pop_back();
+    slots_[symbol] = kNoSlot;
+}
+
+void PositionBook::clear() {
+    for (const Position& position : positions_) {
+        slots_[position.symbol_id()] = kNoSlot;
+    }
+    positions_.clear();
+}
+
+} // namespace backtest
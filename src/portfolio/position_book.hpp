@@ -0,0 +1,95 @@
+/**
+ * @file position_book.hpp
+ * @brief Dense, symbol-id indexed storage for open positions
+ *
+ * Replaces a string-keyed tree of positions: open positions live in one
+ * contiguous array and a flat table maps each interned SymbolId to its slot,
+ * so lookups are one indexed load and valuation loops stream through memory.
+ */
+
+#ifndef POSITION_BOOK_HPP
+#define POSITION_BOOK_HPP
+
+#include "position.hpp"
+#include "../data/symbol_table.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @brief Open positions keyed by SymbolId with O(1) find, insert and erase
+ *
+ * Symbol ids are dense (see SymbolTable), so the id -> slot table is a plain
+ * array that grows to the largest id seen. Positions are kept packed: erase()
+ * moves the last position into the freed slot, so iteration order is not
+ * stable across erasures. Pointers returned by find()/insert() are
+ * invalidated by any later insert() or erase(). Both arrays are allocated
+ * from the memory resource given at construction.
+ */
+class PositionBook {
+public:
+    using const_iterator = std::pmr::vector<Position>::const_iterator;
+    using iterator = std::pmr::vector<Position>::iterator;
+
+    explicit PositionBook(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : positions_(resource), slots_(resource) {}
+
+    /**
+     * @brief Position held in symbol, or nullptr
+     */
+    Position* find(SymbolId symbol) {
+        const uint32_t slot = slot_of(symbol);
+        return slot == kNoSlot ? nullptr : &positions_[slot];
+    }
+
+    const Position* find(SymbolId symbol) const {
+        const uint32_t slot = slot_of(symbol);
+        return slot == kNoSlot ? nullptr : &positions_[slot];
+    }
+
+    bool contains(SymbolId symbol) const { return slot_of(symbol) != kNoSlot; }
+
+    /**
+     * @brief Adds a position for a symbol that is not held yet
+     * @pre !contains(position.symbol_id())
+     * @return Reference to the stored position
+     */
+    Position& insert(const Position& position);
+
+    /**
+     * @brief Removes the position held in symbol, if any
+     */
+    void erase(SymbolId symbol);
+
+    /**
+     * @brief Removes every position
+     */
+    void clear();
+
+    size_t size() const { return positions_.size(); }
+    bool empty() const { return positions_.empty(); }
+    std::pmr::memory_resource* resource() const { return positions_.get_allocator().resource(); }
+
+    // Iteration over the packed positions
+    iterator begin() { return positions_.begin(); }
+    iterator end() { return positions_.end(); }
+    const_iterator begin() const { return positions_.begin(); }
+    const_iterator end() const { return positions_.end(); }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    uint32_t slot_of(SymbolId symbol) const {
+        return symbol < slots_.size() ? slots_[symbol] : kNoSlot;
+    }
+
+    std::pmr::vector<Position> positions_;  ///< Open positions, packed
+    std::pmr::vector<uint32_t> slots_;      ///< SymbolId -> index in positions_, or kNoSlot
+};
+
+} // namespace backtest
+
+#endif // POSITION_BOOK_HPP
@@ -10,7 +10,11 @@
  */
 
 #include "sma_strategy.hpp"
-#include <numeric>  // For std::accumulate
+#include "../indicators/crossover_kernel.hpp"
+#include "../util/profiler.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
 
 namespace backtest {
 
@@ -18,32 +22,32 @@ namespace backtest {
  * @brief Constructs an SMA strategy with specified window sizes
  * @param short_win Size of the short-term moving average window (default: 10)
  * @param long_win Size of the long-term moving average window (default: 50)
+ * @param resource Memory resource for the rolling sums and batch scratch buffers
  * 
  * Initializes the strategy with a descriptive name and sets the initial signal to HOLD.
  */
-SMAStrategy::SMAStrategy(size_t short_win, size_t long_win)
+SMAStrategy::SMAStrategy(size_t short_win, size_t long_win, std::pmr::memory_resource* resource)
     : Strategy("SMA_" + std::to_string(short_win) + "_" + std::to_string(long_win)),
       short_window_(short_win),
       long_window_(long_win),
-      current_signal_(SignalType::HOLD, "", 1.0) {
+      prices_(std::max(short_win, long_win), resource),
+      current_signal_(SignalType::HOLD, 0, 1.0),
+      sum_scratch_(resource),
+      comp_scratch_(resource),
+      code_scratch_(resource) {
 }
 
 
 /**
- * @brief Calculates the Simple Moving Average for a given price window
- * @param prices Deque of historical prices
- * @return Average of all prices, or 0.0 if empty
+ * @brief Calculates the Simple Moving Average over the most recent prices
+ * @param window Number of prices to average
+ * @return Average of the last min(window, prices seen) prices, or 0.0 if none
  * 
- * Uses std::accumulate to sum all prices and divides by count.
- * Returns 0.0 for empty input to prevent division by zero.
+ * Reads the window sum from the shared RollingSum in O(1).
+ * Returns 0.0 for an empty window to prevent division by zero.
  */
-double SMAStrategy::calculate_sma(const std::deque<double>& prices) {
-    if (prices.empty()) {
-        return 0.0;  // Prevent division by zero
-    }
-    
-    double sum = std::accumulate(prices.begin(), prices.end(), 0.0);
-    return sum / prices.size();
+double SMAStrategy::calculate_sma(size_t window) const {
+    return prices_.mean(std::min(window, prices_.count()));
 }
 
 
@@ -52,40 +56,29 @@ double SMAStrategy::calculate_sma(const std::deque<double>& prices) {
  * @param bar Market data containing OHLC prices and timestamp
  * 
  * Algorithm:
- * 1. Add new closing price to both price windows
- * 2. Maintain sliding windows by removing oldest prices when full
- * 3. Wait until enough data is collected (long_window_ bars)
- * 4. Calculate both short and long SMAs
- * 5. Generate signal based on SMA crossover:
+ * 1. Add new closing price to the shared rolling sum
+ * 2. Wait until enough data is collected (long_window_ bars)
+ * 3. Calculate both short and long SMAs in O(1)
+ * 4. Generate signal based on SMA crossover:
  *    - Short > Long: BUY (uptrend)
  *    - Short < Long: SELL (downtrend)
  *    - Equal: HOLD (no clear trend)
  */
 void SMAStrategy::on_new_bar(const Bar& bar) {
+    BT_PROFILE_SCOPE(Indicators);
+
+    // Add new price; the ring evicts the oldest one once it is full
+    prices_.push(bar.close);
     
-    // Add new price to both windows
-    short_prices_.push_back(bar.close);
-    long_prices_.push_back(bar.close);
-    
-    // Maintain sliding window: remove oldest price when window is full
-    if (short_prices_.size() > short_window_) {
-        short_prices_.pop_front();
-    }
-    
-    if (long_prices_.size() > long_window_) {
-        long_prices_.pop_front();
-    }
-    
-    // Wait until we have enough data for the longer window
-    // (If long window is full, short window must also be full)
-    if (long_prices_.size() < long_window_) {
+    // Wait until we have enough data for the long window
+    if (!prices_.ready(long_window_)) {
         current_signal_ = Signal(SignalType::HOLD, bar.timestamp, 0.0);
         return;
     }
     
     // Calculate both moving averages
-    double short_sma = calculate_sma(short_prices_);
-    double long_sma = calculate_sma(long_prices_);
+    double short_sma = calculate_sma(short_window_);
+    double long_sma = calculate_sma(long_window_);
     
     // Generate signal based on SMA crossover
     if (short_sma > long_sma) {
@@ -103,6 +96,154 @@ void SMAStrategy::on_new_bar(const Bar& bar) {
 }
 
 
+/**
+ * @brief Mean of `window` values ending at scratch prefix position k
+ *
+ * Mirrors calculate_sma(): identical operations on identical prefix states.
+ */
+double SMAStrategy::scratch_sma(size_t k, size_t window) const {
+    if (window == 0) {
+        return 0.0;
+    }
+    const double sum = (sum_scratch_[k] - sum_scratch_[k - window]) +
+                       (comp_scratch_[k] - comp_scratch_[k - window]);
+    return sum / static_cast<double>(window);
+}
+
+
+/**
+ * @brief Processes a block of bars in two passes
+ * @param bars Bars to process, oldest first
+ * @param signals One output signal per bar
+ * 
+ * Algorithm:
+ * 1. Copy the stored prefix states into the scratch arrays, then push every
+ *    close into the shared rolling sum and record the resulting prefix
+ *    (a serial O(1) step per bar, identical to on_new_bar())
+ * 2. Bars in the warm-up period are evaluated one by one as on_new_bar() does
+ * 3. All remaining bars have both windows full and go through the SIMD
+ *    crossover kernel, which compares the two means for several bars at once
+ */
+void SMAStrategy::on_bars(const BarColumns& bars, Span<Signal> signals) {
+    BT_PROFILE_SCOPE(Indicators);
+    const size_t n = bars.size();
+    if (n == 0) {
+        return;
+    }
+
+    // Scratch position k holds the prefix after value number (count_before - history + 1 + k)
+    const size_t history = prices_.history();
+    const size_t count_before = prices_.count();
+    sum_scratch_.resize(history + n);
+    comp_scratch_.resize(history + n);
+    for (size_t i = 0; i < history; ++i) {
+        const PrefixSum& p = prices_.prefix_back(history - 1 - i);
+        sum_scratch_[i] = p.sum;
+        comp_scratch_[i] = p.comp;
+    }
+
+    // Pass 1: advance the rolling sum exactly like the streaming path
+    for (size_t j = 0; j < n; ++j) {
+        prices_.push(bars.close[j]);
+        sum_scratch_[history + j] = prices_.prefix().sum;
+        comp_scratch_[history + j] = prices_.prefix().comp;
+    }
+
+    // Bars before `vector_begin` are still warming up (or have a degenerate
+    // window) and follow the per-bar rules; the rest have both windows full
+    const size_t max_window = std::max(short_window_, long_window_);
+    size_t vector_begin = (count_before + 1 >= max_window) ? 0 : max_window - count_before - 1;
+    if (short_window_ == 0 || long_window_ == 0) {
+        vector_begin = n;
+    }
+    vector_begin = std::min(vector_begin, n);
+
+    // Pass 2a: warm-up bars
+    for (size_t j = 0; j < vector_begin; ++j) {
+        const size_t count = count_before + j + 1;
+        const Timestamp ts = bars.timestamps[j];
+        if (count < long_window_) {
+            signals[j] = Signal(SignalType::HOLD, ts, 0.0);
+            continue;
+        }
+        const double short_sma = scratch_sma(history + j, std::min(short_window_, count));
+        const double long_sma = scratch_sma(history + j, std::min(long_window_, count));
+        if (short_sma > long_sma) {
+            signals[j] = Signal(SignalType::BUY, ts, 1.0);
+        } else if (short_sma < long_sma) {
+            signals[j] = Signal(SignalType::SELL, ts, 1.0);
+        } else {
+            signals[j] = Signal(SignalType::HOLD, ts, 0.5);
+        }
+    }
+
+    // Pass 2b: vectorized crossover for bars with full windows
+    if (vector_begin < n) {
+        code_scratch_.resize(n - vector_begin);
+        sma_crossover_kernel(sum_scratch_.data(), comp_scratch_.data(),
+                             history + vector_begin, history + n,
+                             short_window_, long_window_, code_scratch_.data());
+        for (size_t j = vector_begin; j < n; ++j) {
+            const Timestamp ts = bars.timestamps[j];
+            switch (code_scratch_[j - vector_begin]) {
+                case 1:  signals[j] = Signal(SignalType::BUY, ts, 1.0); break;
+                case -1: signals[j] = Signal(SignalType::SELL, ts, 1.0); break;
+                default: signals[j] = Signal(SignalType::HOLD, ts, 0.5); break;
+            }
+        }
+    }
+
+    current_signal_ = signals[n - 1];
+}
+
+
+/**
+ * @brief Saves everything later bars depend on
+ *
+ * The name encodes both windows and identifies the strategy on load. The
+ * batch scratch buffers are rebuilt on every on_bars() call and are not saved.
+ */
+bool SMAStrategy::save_state(SnapshotWriter& out) const {
+    out.put_string(name_);
+    prices_.save_state(out);
+    out.put(static_cast<uint8_t>(current_signal_.type));
+    out.put(current_signal_.timestamp);
+    out.put(current_signal_.strength);
+    return true;
+}
+
+
+/**
+ * @brief Restores the rolling sum and signal, all or nothing
+ */
+bool SMAStrategy::load_state(SnapshotReader& in) {
+    std::string name;
+    if (!in.get_string(name)) {
+        return false;
+    }
+    if (name != name_) {
+        in.fail();
+        return false;
+    }
+
+    RollingSum prices(prices_.max_window(), sum_scratch_.get_allocator().resource());
+    uint8_t type = 0;
+    Signal signal;
+    if (!prices.load_state(in) || !in.get(type) || !in.get(signal.timestamp) || !in.get(signal.strength)) {
+        return false;
+    }
+    if (type > static_cast<uint8_t>(SignalType::HOLD)) {
+        in.fail();
+        return false;
+    }
+    signal.type = static_cast<SignalType>(type);
+
+    prices_ = std::move(prices);
+    current_signal_ = signal;
+    return true;
+}
+
+
 /**
  * @brief Returns the most recent trading signal
  * @return Current Signal object containing type, timestamp, and strength
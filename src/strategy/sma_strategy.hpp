@@ -10,7 +10,10 @@
 #define SMA_STRATEGY_HPP
 
 #include "strategy_base.hpp"
-#include <deque>
+#include "../indicators/rolling_sum.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
 
 namespace backtest {
 
@@ -26,29 +29,48 @@ namespace backtest {
  * - BUY: When short SMA crosses above long SMA (golden cross)
  * - SELL: When short SMA crosses below long SMA (death cross)
  * - HOLD: When SMAs are equal or insufficient data available
+ *
+ * Both averages are read from one RollingSum sized for the larger window,
+ * so each bar costs O(1) regardless of the window lengths. on_bars()
+ * evaluates whole blocks with a SIMD crossover kernel and produces exactly
+ * the signals of the per-bar path.
+ *
+ * All buffers come from the memory resource given at construction, so a
+ * sweep can place each run's strategy in a per-run arena.
  */
 class SMAStrategy : public Strategy {
 private:
     size_t short_window_;                ///< Short-term MA window size (e.g., 10 days)
     size_t long_window_;                 ///< Long-term MA window size (e.g., 50 days)
-    std::deque<double> short_prices_;    ///< Sliding window of prices for short MA
-    std::deque<double> long_prices_;     ///< Sliding window of prices for long MA
+    RollingSum prices_;                  ///< Rolling sums of closing prices shared by both MAs
     Signal current_signal_;              ///< Most recent trading signal
+
+    // Batch scratch space, reused across on_bars() calls
+    std::pmr::vector<double> sum_scratch_;   ///< Prefix sum parts (history followed by the block)
+    std::pmr::vector<double> comp_scratch_;  ///< Prefix compensation parts, same layout
+    std::pmr::vector<int8_t> code_scratch_;  ///< Kernel output: +1 above, -1 below, 0 equal
     
     /**
-     * @brief Calculates the Simple Moving Average for a price window
-     * @param prices Deque containing historical prices
-     * @return Average of all prices in the deque
+     * @brief Calculates the Simple Moving Average over the most recent prices
+     * @param window Number of prices to average (capped at the prices seen so far)
+     * @return Average of the last `window` closing prices
+     */
+    double calculate_sma(size_t window) const;
+
+    /**
+     * @brief Same as calculate_sma() but reading prefix position k of the batch scratch arrays
      */
-    double calculate_sma(const std::deque<double>& prices);
+    double scratch_sma(size_t k, size_t window) const;
     
 public:
     /**
      * @brief Constructs an SMA strategy with specified window sizes
      * @param short_win Size of short-term moving average window (default: 10)
      * @param long_win Size of long-term moving average window (default: 50)
+     * @param resource Memory resource for the rolling sums and batch scratch buffers
      */
-    SMAStrategy(size_t short_win = 10, size_t long_win = 50);
+    SMAStrategy(size_t short_win = 10, size_t long_win = 50,
+                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     
     /**
      * @brief Processes new market data and updates signals
@@ -64,6 +86,30 @@ public:
      * @return Most recent Signal object
      */
     Signal generate_signal() const override;
+
+    /**
+     * @brief Processes a block of bars with the vectorized crossover kernel
+     * @param bars Bars to process, oldest first (only closes and timestamps are read)
+     * @param signals Receives one signal per bar; must hold at least bars.size() elements
+     *
+     * Updates the rolling sums with the same scalar recurrence as on_new_bar(),
+     * then compares the two means for all bars of the block in SIMD lanes.
+     * Signals are bit-for-bit identical to calling on_new_bar() per bar.
+     * Each call copies up to max(short, long) + 1 prefix states, so prefer
+     * large blocks.
+     */
+    void on_bars(const BarColumns& bars, Span<Signal> signals) override;
+
+    /**
+     * @brief Saves the strategy name, the rolling sum's prefix ring and the current signal
+     */
+    bool save_state(SnapshotWriter& out) const override;
+
+    /**
+     * @brief Restores a state saved by an SMAStrategy with the same windows
+     * @return false, leaving the strategy unchanged, if the windows differ or the snapshot is invalid
+     */
+    bool load_state(SnapshotReader& in) override;
 };
 
 } // namespace backtest
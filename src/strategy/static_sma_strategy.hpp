@@ -0,0 +1,76 @@
+/**
+ * @file static_sma_strategy.hpp
+ * @brief SMA crossover strategy with window lengths fixed at compile time
+ */
+
+#ifndef STATIC_SMA_STRATEGY_HPP
+#define STATIC_SMA_STRATEGY_HPP
+
+#include "static_strategy.hpp"
+#include "../indicators/rolling_sum.hpp"
+#include <string>
+
+namespace backtest {
+
+/**
+ * @class StaticSMAStrategy
+ * @brief SMAStrategy(ShortWindow, LongWindow) as a header-only, statically dispatched strategy
+ *
+ * Applies the same rules with the same floating-point operations as
+ * SMAStrategy, so the two produce identical signals bar for bar. Because the
+ * windows are constants, the prefix ring lives inline with a constant mask,
+ * both means are reads at constant offsets, and the whole per-bar step can be
+ * inlined into a loop templated on the strategy type (see
+ * BasicBacktestEngine). Wrap it in StrategyAdapter to use it as a Strategy.
+ */
+template <size_t ShortWindow, size_t LongWindow>
+class StaticSMAStrategy : public StaticStrategy<StaticSMAStrategy<ShortWindow, LongWindow>> {
+public:
+    static constexpr size_t kShortWindow = ShortWindow;
+    static constexpr size_t kLongWindow = LongWindow;
+    static constexpr size_t kMaxWindow = ShortWindow > LongWindow ? ShortWindow : LongWindow;
+
+    StaticSMAStrategy() : current_signal_(SignalType::HOLD, 0, 1.0) {}
+
+    /**
+     * @brief Same update and signal rules as SMAStrategy::on_new_bar()
+     */
+    void on_new_bar(const Bar& bar) {
+        prices_.push(bar.close);
+
+        if (!prices_.ready(LongWindow)) {
+            current_signal_ = Signal(SignalType::HOLD, bar.timestamp, 0.0);
+            return;
+        }
+
+        // Once the long window is full, a short window longer than it is capped
+        // at the bars seen so far, exactly as SMAStrategy does
+        const double short_sma = ShortWindow <= LongWindow ? prices_.template mean<ShortWindow>()
+                                                           : prices_.mean(capped(ShortWindow));
+        const double long_sma = prices_.template mean<LongWindow>();
+
+        if (short_sma > long_sma) {
+            current_signal_ = Signal(SignalType::BUY, bar.timestamp, 1.0);
+        } else if (short_sma < long_sma) {
+            current_signal_ = Signal(SignalType::SELL, bar.timestamp, 1.0);
+        } else {
+            current_signal_ = Signal(SignalType::HOLD, bar.timestamp, 0.5);
+        }
+    }
+
+    Signal generate_signal() const { return current_signal_; }
+
+    std::string get_name() const {
+        return "SMA_" + std::to_string(ShortWindow) + "_" + std::to_string(LongWindow);
+    }
+
+private:
+    size_t capped(size_t window) const { return window < prices_.count() ? window : prices_.count(); }
+
+    StaticRollingSum<kMaxWindow> prices_;  ///< Rolling sums of closing prices shared by both MAs
+    Signal current_signal_;                ///< Most recent trading signal
+};
+
+} // namespace backtest
+
+#endif // STATIC_SMA_STRATEGY_HPP
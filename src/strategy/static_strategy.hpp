@@ -0,0 +1,84 @@
+/**
+ * @file static_strategy.hpp
+ * @brief Statically dispatched strategy interface (CRTP) and its bridge to Strategy
+ *
+ * Strategy calls on_new_bar() and generate_signal() through the vtable, so
+ * the per-bar work of a strategy can never be inlined into the engine loop.
+ * A class deriving from StaticStrategy<Derived> provides the same two
+ * functions as plain (non-virtual) members; code templated on the strategy
+ * type, such as BasicBacktestEngine<Derived>, then calls them directly.
+ * StrategyAdapter wraps any static strategy as a Strategy for code that only
+ * deals in Strategy* (plugins, mixed collections).
+ */
+
+#ifndef STATIC_STRATEGY_HPP
+#define STATIC_STRATEGY_HPP
+
+#include "strategy_base.hpp"
+#include <string>
+#include <utility>
+
+namespace backtest {
+
+/**
+ * @class StaticStrategy
+ * @brief CRTP base of statically dispatched strategies
+ *
+ * Derived must provide:
+ * - void on_new_bar(const Bar& bar)
+ * - Signal generate_signal() const
+ * - std::string get_name() const
+ * and may shadow on_bars() with a batch kernel that yields the same signals.
+ */
+template <typename Derived>
+class StaticStrategy {
+public:
+    /**
+     * @brief Per-bar fallback for the batch API, inlined into the caller
+     */
+    void on_bars(const BarColumns& bars, Span<Signal> signals) {
+        Derived& self = derived();
+        for (size_t i = 0; i < bars.size(); ++i) {
+            self.on_new_bar(bars.bar(i));
+            signals[i] = self.generate_signal();
+        }
+    }
+
+protected:
+    StaticStrategy() = default;
+    ~StaticStrategy() = default;
+
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+};
+
+/**
+ * @class StrategyAdapter
+ * @brief Exposes a statically dispatched strategy through the virtual Strategy interface
+ *
+ * The wrapped strategy is owned by the adapter; the virtual calls forward to
+ * it, so signals are identical on both paths.
+ */
+template <typename S>
+class StrategyAdapter final : public Strategy {
+public:
+    template <typename... Args>
+    explicit StrategyAdapter(Args&&... args)
+        : Strategy(std::string()), strategy_(std::forward<Args>(args)...) {
+        name_ = strategy_.get_name();
+    }
+
+    void on_new_bar(const Bar& bar) override { strategy_.on_new_bar(bar); }
+    Signal generate_signal() const override { return strategy_.generate_signal(); }
+    void on_bars(const BarColumns& bars, Span<Signal> signals) override { strategy_.on_bars(bars, signals); }
+
+    S& strategy() { return strategy_; }
+    const S& strategy() const { return strategy_; }
+
+private:
+    S strategy_;
+};
+
+} // namespace backtest
+
+#endif // STATIC_STRATEGY_HPP
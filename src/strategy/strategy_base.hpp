@@ -8,7 +8,10 @@
 
 #ifndef STRATEGY_BASE_HPP
 #define STRATEGY_BASE_HPP
+#include "../data/bar_store.hpp"
 #include "../data/market_data.hpp"
+#include "../util/snapshot.hpp"
+#include "../util/span.hpp"
 #include <string>
 
 namespace backtest {
@@ -28,20 +31,27 @@ namespace backtest {
      * @brief Represents a trading signal with type, timing, and confidence
      * 
      * Encapsulates all information about a trading decision made by a strategy.
+     * Like Bar it is trivially copyable, so producing a signal on every bar
+     * (including HOLD bars) costs no allocation.
      */
     struct Signal {
         SignalType type;        ///< Type of signal (BUY, SELL, or HOLD)
-        std::string timestamp;  ///< When the signal was generated
+        Timestamp timestamp;    ///< Time of the bar that produced the signal (ns since epoch)
         double strength;        ///< Signal confidence/strength (0.0 to 1.0)
 
         /**
          * @brief Constructs a trading signal
          * @param t Signal type
-         * @param ts Timestamp of signal generation
+         * @param ts Timestamp of the bar that produced the signal
          * @param str Signal strength/confidence (0.0 = no confidence, 1.0 = full confidence)
          */
-        Signal(SignalType t, const std::string& ts, double str)
+        Signal(SignalType t, Timestamp ts, double str)
             : type(t), timestamp(ts), strength(str) {}
+
+        /**
+         * @brief Default constructor - HOLD with no confidence
+         */
+        Signal() : type(SignalType::HOLD), timestamp(0), strength(0.0) {}
     };
 
     /**
@@ -85,6 +95,50 @@ namespace backtest {
          * Should be called after on_new_bar() to get the latest decision.
          */
         virtual Signal generate_signal() const = 0;
+
+        /**
+         * @brief Processes a block of consecutive bars in one call (optional batch API)
+         * @param bars Column views of the bars to process, oldest first
+         * @param signals Receives the signal produced after each bar; must hold
+         *                at least bars.size() elements
+         *
+         * Equivalent to calling on_new_bar() and generate_signal() for every bar
+         * in order, and leaves the strategy in the same state, so batch and
+         * per-bar calls can be mixed. The default does exactly that; strategies
+         * override it with vectorized kernels that must produce identical signals.
+         * Drivers use it whenever no per-bar feedback (e.g. Portfolio fills) is
+         * needed between bars.
+         */
+        virtual void on_bars(const BarColumns& bars, Span<Signal> signals) {
+            for (size_t i = 0; i < bars.size(); ++i) {
+                on_new_bar(bars.bar(i));
+                signals[i] = generate_signal();
+            }
+        }
+        
+        /**
+         * @brief Appends the strategy's internal state to a snapshot (optional)
+         * @return false if the strategy does not support checkpoints (the default)
+         *
+         * Together with load_state() this lets a run stop after any bar and
+         * continue later, e.g. when new bars have been appended to a file.
+         */
+        virtual bool save_state(SnapshotWriter& out) const {
+            (void)out;
+            return false;
+        }
+
+        /**
+         * @brief Restores a state written by save_state() of the same kind of strategy
+         * @return false if the snapshot does not fit this strategy or checkpoints are unsupported
+         *
+         * A strategy restored from the snapshot taken after bar n must produce
+         * the same signals for bars n+1, n+2, ... as the uninterrupted run.
+         */
+        virtual bool load_state(SnapshotReader& in) {
+            (void)in;
+            return false;
+        }
         
         /**
          * @brief Returns the strategy name
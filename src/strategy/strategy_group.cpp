@@ -0,0 +1,70 @@
+/**
+ * @file strategy_group.cpp
+ * @brief Block-wise and per-bar fan-out of one data pass to many strategies
+ */
+
+#include "strategy_group.hpp"
+#include "../data/bar_cursor.hpp"
+#include "../util/thread_pool.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace backtest {
+
+StrategyGroup::StrategyGroup(size_t block_size, size_t threads, std::pmr::memory_resource* resource)
+    : block_size_(std::max<size_t>(block_size, 1)),
+      threads_(threads == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : threads),
+      resource_(resource) {
+}
+
+size_t StrategyGroup::add(Strategy& strategy) {
+    strategies_.push_back(&strategy);
+    return strategies_.size() - 1;
+}
+
+void StrategyGroup::run_strided(const BarColumns& bars, size_t first, size_t stride,
+                                const BlockListener& listener, std::pmr::memory_resource* resource) const {
+    std::pmr::vector<Signal> signals(std::min(block_size_, bars.size()), resource);
+    BarCursor cursor(bars);
+    while (cursor.has_next()) {
+        const BarColumns block = cursor.next_block(block_size_);
+        const Span<Signal> out(signals.data(), block.size());
+        for (size_t i = first; i < strategies_.size(); i += stride) {
+            strategies_[i]->on_bars(block, out);
+            if (listener) {
+                listener(i, block, Span<const Signal>(signals.data(), block.size()));
+            }
+        }
+    }
+}
+
+void StrategyGroup::run(const BarColumns& bars, const BlockListener& listener) {
+    if (strategies_.empty() || bars.empty()) {
+        return;
+    }
+    const size_t threads = std::min(threads_, strategies_.size());
+    if (threads <= 1) {
+        run_strided(bars, 0, 1, listener, resource_);
+        return;
+    }
+    // resource_ may be an unsynchronized arena, so workers take their one buffer from the heap
+    ThreadPool pool(threads);
+    pool.parallel_for(threads, [&](size_t t) {
+        run_strided(bars, t, threads, listener, std::pmr::new_delete_resource());
+    });
+}
+
+void StrategyGroup::run(DataHandler& data, const BarListener& listener) {
+    while (data.has_next()) {
+        const Bar bar = data.get_next_bar();
+        for (size_t i = 0; i < strategies_.size(); ++i) {
+            Strategy& strategy = *strategies_[i];
+            strategy.on_new_bar(bar);
+            if (listener) {
+                listener(i, bar, strategy.generate_signal());
+            }
+        }
+    }
+}
+
+} // namespace backtest
@@ -0,0 +1,102 @@
+/**
+ * @file strategy_group.hpp
+ * @brief Many strategies fed from one pass over the data
+ *
+ * Running N strategies over the same symbol one after another reads every
+ * bar column N times; once the history outgrows the caches, each pass pays
+ * for it again in memory bandwidth. StrategyGroup walks the data once
+ * instead and hands each block of bars (or each bar, for streaming data) to
+ * every strategy while the block is still in cache.
+ */
+
+#ifndef STRATEGY_GROUP_HPP
+#define STRATEGY_GROUP_HPP
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+#include "strategy_base.hpp"
+#include "../data/bar_store.hpp"
+#include "../data/data_handler.hpp"
+
+namespace backtest {
+
+/// Bars per block when none is given: closes and timestamps of a block fit in L2
+constexpr size_t kDefaultGroupBlockSize = 4096;
+
+/**
+ * @class StrategyGroup
+ * @brief Fans one pass over the bars out to a set of borrowed strategies
+ *
+ * Every strategy sees every bar in order, so each ends in the same state and
+ * produces the same signals as its own separate pass. In block mode the
+ * strategies process each block with Strategy::on_bars(), one after another,
+ * before the group moves on to the next block.
+ *
+ * With threads > 1, strategy i is handled by thread i % threads (a strided
+ * split, so strategies added in order of cost spread evenly). Each thread
+ * walks all blocks in order for its own strategies; the threads are not kept
+ * in step, so each streams the history on its own. Listeners are then called
+ * concurrently for different strategies, but for any one strategy always in
+ * bar order from one thread at a time.
+ */
+class StrategyGroup {
+public:
+    /// Called after strategy `index` has processed `block`, with one signal per bar
+    using BlockListener = std::function<void(size_t index, const BarColumns& block, Span<const Signal> signals)>;
+    /// Called after strategy `index` has processed `bar`, with the signal it produced
+    using BarListener = std::function<void(size_t index, const Bar& bar, const Signal& signal)>;
+
+    /**
+     * @param block_size Bars handed to on_bars() per call (at least 1)
+     * @param threads Threads for run(const BarColumns&) (0 = hardware concurrency, 1 = the caller only)
+     * @param resource Allocates the signal buffer of a single-threaded run. With
+     *        more than one thread each worker allocates its own buffer from the
+     *        global heap instead, so resource never sees concurrent calls and
+     *        need not be thread safe (a RunArena resource is fine)
+     */
+    explicit StrategyGroup(size_t block_size = kDefaultGroupBlockSize, size_t threads = 1,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Adds a strategy; it must outlive the group's runs
+     * @return Index of the strategy in listener calls
+     */
+    size_t add(Strategy& strategy);
+
+    size_t size() const { return strategies_.size(); }
+    Strategy& strategy(size_t index) const { return *strategies_[index]; }
+
+    /**
+     * @brief Feeds all bars to every strategy, one block at a time
+     * @param listener Receives each strategy's signals per block; may be empty
+     */
+    void run(const BarColumns& bars, const BlockListener& listener);
+
+    /**
+     * @brief Feeds the remaining bars of data (loaded or streaming) to every strategy, bar by bar
+     * @param listener Receives each strategy's signal per bar; may be empty
+     *
+     * Each bar is read once, on the calling thread, and passed to the
+     * strategies in index order. Loaded data is processed in blocks via
+     * run(data.columns()) instead when the per-bar interleaving is not needed.
+     */
+    void run(DataHandler& data, const BarListener& listener);
+
+private:
+    /**
+     * @brief Runs the strategies first, first + stride, ... over all blocks with one signal buffer
+     * @param resource Allocates the signal buffer; used by this call's thread only
+     */
+    void run_strided(const BarColumns& bars, size_t first, size_t stride, const BlockListener& listener,
+                     std::pmr::memory_resource* resource) const;
+
+    std::vector<Strategy*> strategies_;
+    size_t block_size_;
+    size_t threads_;
+    std::pmr::memory_resource* resource_;
+};
+
+} // namespace backtest
+
+#endif // STRATEGY_GROUP_HPP
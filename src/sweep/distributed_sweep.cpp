@@ -0,0 +1,663 @@
+/**
+ * @file distributed_sweep.cpp
+ * @brief Implementation of the distributed sweep coordinator, worker and protocol
+ */
+
+#include "distributed_sweep.hpp"
+#include "../util/snapshot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace backtest {
+
+namespace {
+
+    /// Reads back as 0x01020304 only on a peer with the same byte order
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+
+    /// Larger frames are treated as a corrupt stream
+    constexpr uint32_t kMaxFrameBytes = 64u << 20;
+
+    bool send_message(const TcpSocket& socket, SweepMessage type, const SnapshotWriter& payload) {
+        const std::vector<char>& bytes = payload.bytes();
+        const FrameHeader header{static_cast<uint32_t>(type), static_cast<uint32_t>(bytes.size())};
+        // One buffer, one send: header and payload leave in the same segment
+        std::vector<char> frame(sizeof(header) + bytes.size());
+        std::memcpy(frame.data(), &header, sizeof(header));
+        if (!bytes.empty()) {
+            std::memcpy(frame.data() + sizeof(header), bytes.data(), bytes.size());
+        }
+        return socket.send_all(frame.data(), frame.size());
+    }
+
+    bool read_bool(SnapshotReader& in, bool& value) {
+        uint8_t byte = 0;
+        if (!in.get(byte)) {
+            return false;
+        }
+        value = byte != 0;
+        return true;
+    }
+
+    bool read_size(SnapshotReader& in, size_t& value) {
+        uint64_t wide = 0;
+        if (!in.get(wide)) {
+            return false;
+        }
+        value = static_cast<size_t>(wide);
+        return true;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+bool load_symbol_list(const std::string& path, std::vector<SweepSymbol>& symbols) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open symbol list " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        SweepSymbol entry;
+        if (!(fields >> entry.symbol) || entry.symbol[0] == '#') {
+            continue;
+        }
+        if (!(fields >> entry.path)) {
+            std::cerr << "Error: " << path << ":" << line_number << ": missing path for " << entry.symbol
+                      << std::endl;
+            return false;
+        }
+        symbols.push_back(entry);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// StreamingTopK
+// ---------------------------------------------------------------------------
+
+bool StreamingTopK::better(const DistributedResult& a, const DistributedResult& b) const {
+    if (ranks_before(a.result, b.result, ranking_)) return true;
+    if (ranks_before(b.result, a.result, ranking_)) return false;
+    return a.symbol < b.symbol;
+}
+
+void StreamingTopK::push(const DistributedResult& result) {
+    auto comp = [this](const DistributedResult& a, const DistributedResult& b) { return better(a, b); };
+    if (heap_.size() < k_) {
+        heap_.push_back(result);
+        std::push_heap(heap_.begin(), heap_.end(), comp);
+    } else if (k_ > 0 && better(result, heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), comp);
+        heap_.back() = result;
+        std::push_heap(heap_.begin(), heap_.end(), comp);
+    }
+}
+
+std::vector<DistributedResult> StreamingTopK::sorted() const {
+    std::vector<DistributedResult> results = heap_;
+    std::sort(results.begin(), results.end(),
+              [this](const DistributedResult& a, const DistributedResult& b) { return better(a, b); });
+    return results;
+}
+
+// ---------------------------------------------------------------------------
+// SweepCoordinator
+// ---------------------------------------------------------------------------
+
+SweepCoordinator::SweepCoordinator(std::vector<SweepSymbol> symbols, std::vector<SmaParams> grid,
+                                   const DistributedSweepConfig& config)
+    : symbols_(std::move(symbols)), grid_(std::move(grid)), config_(config),
+      top_(config.top_k, config.sweep.rank_by) {
+    if (config_.params_per_unit == 0) {
+        config_.params_per_unit = 1;
+    }
+    if (config_.units_per_worker == 0) {
+        config_.units_per_worker = 1;
+    }
+    if (config_.max_attempts == 0) {
+        config_.max_attempts = 1;
+    }
+    // Symbol-major order: consecutive units of a worker tend to reuse its mapped symbol
+    for (size_t s = 0; s < symbols_.size(); ++s) {
+        for (size_t begin = 0; begin < grid_.size(); begin += config_.params_per_unit) {
+            Unit unit;
+            unit.symbol = static_cast<uint32_t>(s);
+            unit.begin = begin;
+            unit.end = std::min(grid_.size(), begin + config_.params_per_unit);
+            pending_.push_back(units_.size());
+            units_.push_back(unit);
+        }
+    }
+    stats_.units = units_.size();
+}
+
+bool SweepCoordinator::listen(uint16_t port) {
+    if (!listener_.listen(port)) {
+        std::cerr << "Error: Could not listen on port " << port << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<DistributedResult> SweepCoordinator::run(std::ostream* progress) {
+    start_ = Clock::now();
+    Clock::time_point last_report = start_;
+    std::vector<const TcpSocket*> sockets;
+    std::vector<char> ready;
+    std::vector<char> chunk(64 * 1024);
+
+    while (stats_.completed + stats_.failed < units_.size()) {
+        sockets.clear();
+        sockets.push_back(&listener_);
+        for (const auto& connection : connections_) {
+            sockets.push_back(&connection->socket);
+        }
+        if (poll_readable(sockets, 100, ready) < 0) {
+            std::cerr << "Error: poll failed, stopping the sweep" << std::endl;
+            break;
+        }
+
+        // Connections accepted now are polled from the next iteration on
+        const size_t polled = connections_.size();
+        if (ready[0]) {
+            TcpSocket socket = listener_.accept();
+            if (socket.is_open()) {
+                auto connection = std::make_unique<Connection>();
+                connection->socket = std::move(socket);
+                connections_.push_back(std::move(connection));
+            }
+        }
+
+        for (size_t i = 0; i < polled; ++i) {
+            Connection& connection = *connections_[i];
+            if (!ready[i + 1]) {
+                continue;
+            }
+            const long received = connection.socket.recv_some(chunk.data(), chunk.size());
+            if (received <= 0) {
+                drop(connection);
+                continue;
+            }
+            connection.input.insert(connection.input.end(), chunk.data(), chunk.data() + received);
+
+            size_t offset = 0;
+            while (connection.socket.is_open() && connection.input.size() - offset >= sizeof(FrameHeader)) {
+                FrameHeader header;
+                std::memcpy(&header, connection.input.data() + offset, sizeof(header));
+                if (header.size > kMaxFrameBytes) {
+                    std::cerr << "Error: Oversized message from a worker, disconnecting it" << std::endl;
+                    drop(connection);
+                    break;
+                }
+                if (connection.input.size() - offset - sizeof(header) < header.size) {
+                    break;
+                }
+                const char* payload = connection.input.data() + offset + sizeof(header);
+                if (!handle(connection, static_cast<SweepMessage>(header.type), payload, header.size)) {
+                    drop(connection);
+                    break;
+                }
+                offset += sizeof(header) + header.size;
+            }
+            connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+        }
+
+        for (const auto& connection : connections_) {
+            if (connection->joined && connection->socket.is_open() && !fill(*connection)) {
+                drop(*connection);
+            }
+        }
+        connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
+                                          [](const std::unique_ptr<Connection>& c) { return !c->socket.is_open(); }),
+                           connections_.end());
+
+        if (progress != nullptr && config_.progress_interval > 0.0 &&
+            seconds_since(last_report) >= config_.progress_interval) {
+            report(*progress);
+            last_report = Clock::now();
+        }
+    }
+
+    const SnapshotWriter empty;
+    for (const auto& connection : connections_) {
+        if (connection->joined) {
+            send_message(connection->socket, SweepMessage::Shutdown, empty);
+        }
+    }
+    connections_.clear();
+    stats_.seconds = seconds_since(start_);
+    if (progress != nullptr && config_.progress_interval > 0.0) {
+        report(*progress);
+    }
+    return top_.sorted();
+}
+
+bool SweepCoordinator::handle(Connection& connection, SweepMessage type, const char* payload, size_t size) {
+    SnapshotReader in(payload, size);
+    switch (type) {
+        case SweepMessage::Hello: {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t byte_order = 0;
+            uint32_t result_size = 0;
+            if (!in.get(magic) || !in.get(version) || !in.get(byte_order) || !in.get(result_size) ||
+                !in.get(connection.threads) || magic != kSweepProtocolMagic) {
+                std::cerr << "Error: Connection is not a sweep worker" << std::endl;
+                return false;
+            }
+            if (version != kSweepProtocolVersion || byte_order != kByteOrderMark ||
+                result_size != sizeof(SweepResult)) {
+                std::cerr << "Error: Refusing worker with protocol version " << version
+                          << " or a different data layout" << std::endl;
+                return false;
+            }
+            if (connection.joined || !send_job(connection)) {
+                return false;
+            }
+            connection.joined = true;
+            ++stats_.workers;
+            return true;
+        }
+        case SweepMessage::Result:
+            return connection.joined && handle_result(connection, payload, size);
+        default:
+            std::cerr << "Error: Unexpected message " << static_cast<uint32_t>(type) << " from a worker" << std::endl;
+            return false;
+    }
+}
+
+bool SweepCoordinator::handle_result(Connection& connection, const char* payload, size_t size) {
+    SnapshotReader in(payload, size);
+    uint64_t id = 0;
+    bool ok = false;
+    double seconds = 0.0;
+    uint64_t bars = 0;
+    if (!in.get(id) || !read_bool(in, ok) || !in.get(seconds) || !in.get(bars)) {
+        return false;
+    }
+    auto slot = std::find(connection.in_flight.begin(), connection.in_flight.end(), id);
+    if (slot == connection.in_flight.end()) {
+        std::cerr << "Error: Worker answered unit " << id << " it was not assigned" << std::endl;
+        return false;
+    }
+    connection.in_flight.erase(slot);
+    Unit& unit = units_[id];
+    --unit.active;
+
+    if (unit.state == UnitState::Done || unit.state == UnitState::Failed) {
+        ++stats_.duplicate_results;  // Another copy finished first
+        return true;
+    }
+
+    if (!ok) {
+        std::string error;
+        in.get_string(error);
+        const SweepSymbol& symbol = symbols_[unit.symbol];
+        std::cerr << "Warning: Unit " << id << " (" << symbol.symbol << ") failed on a worker: " << error
+                  << std::endl;
+        if (unit.active == 0) {
+            if (unit.attempts < config_.max_attempts) {
+                unit.state = UnitState::Pending;
+                pending_.push_front(id);
+                ++stats_.requeued;
+            } else {
+                finish_unit(id, false);
+            }
+        }
+        return true;
+    }
+
+    uint32_t count = 0;
+    if (!in.get(count)) {
+        return false;
+    }
+    DistributedResult result;
+    result.symbol = symbols_[unit.symbol].symbol;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!in.get(result.result)) {
+            return false;
+        }
+        top_.push(result);
+    }
+    stats_.runs += unit.end - unit.begin;
+    stats_.bars += bars;
+    unit_seconds_ += seconds;
+    finish_unit(id, true);
+    return true;
+}
+
+bool SweepCoordinator::send_job(const Connection& connection) const {
+    const SweepConfig& sweep = config_.sweep;
+    SnapshotWriter out;
+    out.put(sweep.initial_capital);
+    out.put(sweep.commission);
+    out.put(static_cast<uint64_t>(sweep.block_size));
+    out.put(static_cast<uint8_t>(sweep.share_indicators));
+    out.put(static_cast<uint8_t>(sweep.run_arena));
+    out.put(static_cast<uint64_t>(sweep.warmup_bars));
+    out.put(static_cast<uint8_t>(sweep.rank_by));
+    out.put(sweep.periods_per_year);
+    out.put(static_cast<uint64_t>(config_.top_k));
+    out.put(static_cast<uint64_t>(grid_.size()));
+    for (const SmaParams& params : grid_) {
+        out.put(static_cast<uint64_t>(params.short_window));
+        out.put(static_cast<uint64_t>(params.long_window));
+    }
+    out.put(static_cast<uint32_t>(symbols_.size()));
+    for (const SweepSymbol& symbol : symbols_) {
+        out.put_string(symbol.symbol);
+        out.put_string(symbol.path);
+    }
+    return send_message(connection.socket, SweepMessage::Job, out);
+}
+
+int64_t SweepCoordinator::next_unit(const Connection& connection, bool& speculative) {
+    speculative = false;
+    while (!pending_.empty()) {
+        const uint64_t id = pending_.front();
+        pending_.pop_front();
+        if (units_[id].state == UnitState::Pending) {
+            return static_cast<int64_t>(id);
+        }
+    }
+
+    // Queue drained: start a second copy of the unit running longest past the expected time
+    if (stats_.completed == 0) {
+        return -1;
+    }
+    const double mean = unit_seconds_ / static_cast<double>(stats_.completed);
+    const double threshold = std::max(config_.straggler_min_seconds, config_.straggler_factor * mean);
+    const Clock::time_point now = Clock::now();
+    int64_t oldest = -1;
+    for (size_t id = 0; id < units_.size(); ++id) {
+        const Unit& unit = units_[id];
+        if (unit.state != UnitState::Running || unit.active >= 2 || unit.attempts >= config_.max_attempts ||
+            std::chrono::duration<double>(now - unit.started).count() < threshold) {
+            continue;
+        }
+        if (std::find(connection.in_flight.begin(), connection.in_flight.end(), id) != connection.in_flight.end()) {
+            continue;
+        }
+        if (oldest < 0 || unit.started < units_[oldest].started) {
+            oldest = static_cast<int64_t>(id);
+        }
+    }
+    speculative = oldest >= 0;
+    return oldest;
+}
+
+bool SweepCoordinator::fill(Connection& connection) {
+    while (connection.in_flight.size() < config_.units_per_worker) {
+        bool speculative = false;
+        const int64_t next = next_unit(connection, speculative);
+        if (next < 0) {
+            return true;
+        }
+        const uint64_t id = static_cast<uint64_t>(next);
+        Unit& unit = units_[id];
+        unit.state = UnitState::Running;
+        unit.started = Clock::now();
+        ++unit.attempts;
+        ++unit.active;
+        if (speculative) {
+            ++stats_.speculative;
+        }
+        connection.in_flight.push_back(id);
+
+        SnapshotWriter out;
+        out.put(id);
+        out.put(unit.symbol);
+        out.put(unit.begin);
+        out.put(unit.end);
+        if (!send_message(connection.socket, SweepMessage::Assign, out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SweepCoordinator::drop(Connection& connection) {
+    if (!connection.socket.is_open()) {
+        return;
+    }
+    for (uint64_t id : connection.in_flight) {
+        Unit& unit = units_[id];
+        --unit.active;
+        if (unit.state != UnitState::Running || unit.active != 0) {
+            continue;
+        }
+        if (unit.attempts < config_.max_attempts) {
+            unit.state = UnitState::Pending;
+            pending_.push_front(id);
+            ++stats_.requeued;
+        } else {
+            std::cerr << "Warning: Giving up on unit " << id << " after " << unit.attempts << " attempts"
+                      << std::endl;
+            finish_unit(id, false);
+        }
+    }
+    connection.in_flight.clear();
+    if (connection.joined) {
+        ++stats_.lost_workers;
+    }
+    connection.socket.close();
+}
+
+void SweepCoordinator::finish_unit(uint64_t id, bool ok) {
+    units_[id].state = ok ? UnitState::Done : UnitState::Failed;
+    if (ok) {
+        ++stats_.completed;
+    } else {
+        ++stats_.failed;
+    }
+}
+
+void SweepCoordinator::report(std::ostream& os) const {
+    const size_t done = stats_.completed + stats_.failed;
+    const double elapsed = seconds_since(start_);
+    size_t workers = 0;
+    for (const auto& connection : connections_) {
+        workers += connection->joined && connection->socket.is_open() ? 1 : 0;
+    }
+    char line[160];
+    std::snprintf(line, sizeof(line), "[dsweep] %zu/%zu units (%.1f%%) | %zu workers | %.3g bars/s | ",
+                  done, units_.size(), units_.empty() ? 100.0 : 100.0 * done / units_.size(), workers,
+                  elapsed > 0.0 ? stats_.bars / elapsed : 0.0);
+    os << line;
+    if (done == 0) {
+        os << "ETA -";
+    } else {
+        os << "ETA " << elapsed * static_cast<double>(units_.size() - done) / static_cast<double>(done) << " s";
+    }
+    os << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+// SweepWorker
+// ---------------------------------------------------------------------------
+
+SweepWorker::SweepWorker(size_t threads, size_t cached_symbols)
+    : threads_(threads), cached_symbols_(std::max<size_t>(cached_symbols, 1)) {}
+
+const DataHandler* SweepWorker::load(uint32_t symbol, std::string& error) {
+    auto found = loaded_.find(symbol);
+    if (found != loaded_.end()) {
+        load_order_.erase(std::find(load_order_.begin(), load_order_.end(), symbol));
+        load_order_.push_back(symbol);
+        return found->second.get();
+    }
+    if (symbol >= symbols_.size()) {
+        error = "unknown symbol index";
+        return nullptr;
+    }
+    const SweepSymbol& entry = symbols_[symbol];
+    auto data = std::make_unique<DataHandler>();
+    if (!data->load_csv(entry.path, entry.symbol, LoadMode::MemoryMapped, CachePolicy::ReadWrite)) {
+        error = "could not load " + entry.path;
+        return nullptr;
+    }
+    if (loaded_.size() >= cached_symbols_) {
+        loaded_.erase(load_order_.front());
+        load_order_.pop_front();
+    }
+    load_order_.push_back(symbol);
+    return loaded_.emplace(symbol, std::move(data)).first->second.get();
+}
+
+bool SweepWorker::run(const std::string& host, uint16_t port, size_t connect_attempts) {
+    TcpSocket socket;
+    for (size_t attempt = 0; !socket.connect(host, port); ++attempt) {
+        if (attempt + 1 >= std::max<size_t>(connect_attempts, 1)) {
+            std::cerr << "Error: Could not connect to coordinator " << host << ":" << port << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    SnapshotWriter hello;
+    hello.put(kSweepProtocolMagic);
+    hello.put(kSweepProtocolVersion);
+    hello.put(kByteOrderMark);
+    hello.put(static_cast<uint32_t>(sizeof(SweepResult)));
+    hello.put(static_cast<uint32_t>(threads_ == 0 ? std::thread::hardware_concurrency() : threads_));
+    if (!send_message(socket, SweepMessage::Hello, hello)) {
+        std::cerr << "Error: Lost connection to coordinator" << std::endl;
+        return false;
+    }
+
+    std::vector<char> payload;
+    bool have_job = false;
+    while (true) {
+        FrameHeader header;
+        if (!socket.recv_all(&header, sizeof(header)) || header.size > kMaxFrameBytes) {
+            std::cerr << "Error: Lost connection to coordinator" << std::endl;
+            return false;
+        }
+        payload.resize(header.size);
+        if (header.size > 0 && !socket.recv_all(payload.data(), payload.size())) {
+            std::cerr << "Error: Lost connection to coordinator" << std::endl;
+            return false;
+        }
+        SnapshotReader in(payload.data(), payload.size());
+
+        switch (static_cast<SweepMessage>(header.type)) {
+            case SweepMessage::Job: {
+                uint8_t rank_by = 0;
+                uint64_t grid_size = 0;
+                uint32_t symbol_count = 0;
+                in.get(config_.initial_capital);
+                in.get(config_.commission);
+                read_size(in, config_.block_size);
+                read_bool(in, config_.share_indicators);
+                read_bool(in, config_.run_arena);
+                read_size(in, config_.warmup_bars);
+                in.get(rank_by);
+                in.get(config_.periods_per_year);
+                read_size(in, top_k_);
+                in.get(grid_size);
+                config_.rank_by = static_cast<SweepRanking>(rank_by);
+                config_.threads = threads_;
+                grid_.clear();
+                for (uint64_t i = 0; i < grid_size && in.ok(); ++i) {
+                    SmaParams params{0, 0};
+                    read_size(in, params.short_window);
+                    read_size(in, params.long_window);
+                    grid_.push_back(params);
+                }
+                in.get(symbol_count);
+                symbols_.clear();
+                for (uint32_t i = 0; i < symbol_count && in.ok(); ++i) {
+                    SweepSymbol symbol;
+                    in.get_string(symbol.symbol);
+                    in.get_string(symbol.path);
+                    symbols_.push_back(symbol);
+                }
+                if (!in.ok()) {
+                    std::cerr << "Error: Malformed job from coordinator" << std::endl;
+                    return false;
+                }
+                loaded_.clear();
+                load_order_.clear();
+                have_job = true;
+                break;
+            }
+            case SweepMessage::Assign: {
+                uint64_t id = 0;
+                uint32_t symbol = 0;
+                uint64_t begin = 0;
+                uint64_t end = 0;
+                if (!have_job || !in.get(id) || !in.get(symbol) || !in.get(begin) || !in.get(end)) {
+                    std::cerr << "Error: Malformed assignment from coordinator" << std::endl;
+                    return false;
+                }
+                const auto start = std::chrono::steady_clock::now();
+                std::string error;
+                const DataHandler* data = load(symbol, error);
+                end = std::min<uint64_t>(end, grid_.size());
+                begin = std::min(begin, end);
+
+                SnapshotWriter out;
+                out.put(id);
+                if (data == nullptr) {
+                    out.put(static_cast<uint8_t>(0));
+                    out.put(seconds_since(start));
+                    out.put(static_cast<uint64_t>(0));
+                    out.put_string(error);
+                } else {
+                    const std::vector<SmaParams> slice(grid_.begin() + begin, grid_.begin() + end);
+                    const SweepEngine engine(data->columns(), config_);
+                    std::vector<SweepResult> results = engine.run(slice);
+                    results.resize(std::min(results.size(), top_k_));
+                    out.put(static_cast<uint8_t>(1));
+                    out.put(seconds_since(start));
+                    out.put(static_cast<uint64_t>(data->size() * slice.size()));
+                    out.put(static_cast<uint32_t>(results.size()));
+                    for (const SweepResult& result : results) {
+                        out.put(result);
+                    }
+                }
+                if (!send_message(socket, SweepMessage::Result, out)) {
+                    std::cerr << "Error: Lost connection to coordinator" << std::endl;
+                    return false;
+                }
+                ++units_done_;
+                break;
+            }
+            case SweepMessage::Shutdown:
+                return true;
+            default:
+                std::cerr << "Error: Unexpected message " << header.type << " from coordinator" << std::endl;
+                return false;
+        }
+    }
+}
+
+void print_distributed_results(std::ostream& os, const std::vector<DistributedResult>& results) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%4s %-10s %6s %6s %14s %10s %8s %8s %8s\n",
+                  "rank", "symbol", "short", "long", "final_value", "return", "trades", "sharpe", "max_dd");
+    os << line;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SweepResult& r = results[i].result;
+        std::snprintf(line, sizeof(line), "%4zu %-10s %6zu %6zu %14.2f %9.2f%% %8zu %8.2f %7.2f%%\n",
+                      i + 1, results[i].symbol.c_str(), r.params.short_window, r.params.long_window,
+                      r.final_value, r.total_return * 100.0, r.trades,
+                      r.metrics.sharpe, r.metrics.max_drawdown * 100.0);
+        os << line;
+    }
+}
+
+} // namespace backtest
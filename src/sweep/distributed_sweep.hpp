@@ -0,0 +1,286 @@
+/**
+ * @file distributed_sweep.hpp
+ * @brief Parameter sweeps sharded across worker processes on many machines
+ *
+ * One SweepEngine run covers one symbol on one machine. A distributed sweep
+ * crosses a window grid with a list of symbols and splits the product into
+ * work units of (symbol, block of grid points). A SweepCoordinator listens on
+ * a TCP port and hands units out on demand to any number of SweepWorker
+ * processes; each worker memory-maps the symbol's binary bar cache
+ * (bar_cache.hpp) on its own node, runs the block with a local SweepEngine
+ * and sends back only the block's best top_k results, which the coordinator
+ * merges into a streaming top-K.
+ *
+ * Units are handed out dynamically, a few in flight per worker, so fast
+ * workers take more of them and the wall time scales with the number of
+ * workers. Units of a worker that disconnects go back into the queue. Once
+ * the queue is empty, idle workers re-run units that have been running for
+ * much longer than the average (stragglers); whichever copy finishes first
+ * counts.
+ *
+ * Protocol: every message is a FrameHeader followed by a payload written
+ * with SnapshotWriter in native layout. Hello carries the byte order and the
+ * size of a SweepResult, and workers whose layout differs are refused:
+ *
+ *   worker -> Hello(magic, version, byte order, result size, threads)
+ *   coordinator -> Job(sweep settings, top_k, grid, symbols)
+ *   coordinator -> Assign(unit, symbol, grid range)   ...   worker -> Result(unit, ...)
+ *   coordinator -> Shutdown
+ */
+
+#ifndef DISTRIBUTED_SWEEP_HPP
+#define DISTRIBUTED_SWEEP_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "sweep_engine.hpp"
+#include "../data/data_handler.hpp"
+#include "../util/tcp_socket.hpp"
+
+namespace backtest {
+
+/// First field of Hello ("BTSW" read as a little-endian integer)
+constexpr uint32_t kSweepProtocolMagic = 0x57535442;
+
+/// Bumped whenever a message layout changes
+constexpr uint32_t kSweepProtocolVersion = 1;
+
+/// Port coordinators listen on unless told otherwise
+constexpr uint16_t kDefaultSweepPort = 7878;
+
+/**
+ * @enum SweepMessage
+ * @brief Type of a protocol message
+ */
+enum class SweepMessage : uint32_t {
+    Hello = 1,
+    Job = 2,
+    Assign = 3,
+    Result = 4,
+    Shutdown = 5
+};
+
+/**
+ * @struct FrameHeader
+ * @brief Precedes every message on the wire
+ */
+struct FrameHeader {
+    uint32_t type;  ///< SweepMessage
+    uint32_t size;  ///< Payload bytes that follow
+};
+
+/**
+ * @struct SweepSymbol
+ * @brief One instrument of a distributed sweep
+ */
+struct SweepSymbol {
+    std::string symbol;  ///< Name reported with its results
+    std::string path;    ///< CSV path, valid on every worker node (its .bars cache is used)
+};
+
+/**
+ * @brief Reads "SYMBOL PATH" lines; blank lines and lines starting with '#' are skipped
+ * @return false if the file cannot be read or a line has no path
+ */
+bool load_symbol_list(const std::string& path, std::vector<SweepSymbol>& symbols);
+
+/**
+ * @struct DistributedSweepConfig
+ * @brief Sharding, merging and retry settings of a SweepCoordinator
+ */
+struct DistributedSweepConfig {
+    SweepConfig sweep;                   ///< Run settings sent to the workers (threads is each worker's own)
+    size_t params_per_unit = 256;        ///< Grid points per work unit
+    size_t top_k = 10;                   ///< Results kept, best first
+    size_t units_per_worker = 2;         ///< Units in flight per worker, so none waits for its next one
+    double straggler_factor = 3.0;       ///< Re-run units running this many times the mean unit time...
+    double straggler_min_seconds = 1.0;  ///< ...and at least this long
+    size_t max_attempts = 3;             ///< Assignments of one unit (failures, lost workers, stragglers)
+    double progress_interval = 1.0;      ///< Seconds between progress lines (0 = none)
+};
+
+/**
+ * @struct DistributedResult
+ * @brief One run of a distributed sweep
+ */
+struct DistributedResult {
+    std::string symbol;
+    SweepResult result;
+};
+
+/**
+ * @struct DistributedSweepStats
+ * @brief Work and failures of SweepCoordinator::run()
+ */
+struct DistributedSweepStats {
+    size_t units = 0;              ///< Work units of the sweep
+    size_t completed = 0;          ///< Units with results
+    size_t failed = 0;             ///< Units given up after max_attempts
+    size_t workers = 0;            ///< Workers that joined
+    size_t lost_workers = 0;       ///< Workers that disconnected before the end
+    size_t requeued = 0;           ///< Units re-queued after a failure or a lost worker
+    size_t speculative = 0;        ///< Extra copies of straggling units started
+    size_t duplicate_results = 0;  ///< Results of units already completed by another copy
+    uint64_t runs = 0;             ///< Grid points run over all symbols
+    uint64_t bars = 0;             ///< Bars replayed over all runs
+    double seconds = 0.0;          ///< Wall time of run()
+
+    double bars_per_second() const { return seconds > 0.0 ? bars / seconds : 0.0; }
+};
+
+/**
+ * @class StreamingTopK
+ * @brief The best k results seen so far, in O(log k) per result
+ *
+ * Orders by the sweep ranking (ranks_before()), ties broken by symbol, so
+ * the merged list does not depend on the order results arrive in.
+ */
+class StreamingTopK {
+public:
+    StreamingTopK(size_t k, SweepRanking ranking) : k_(k), ranking_(ranking) {}
+
+    void push(const DistributedResult& result);
+
+    /**
+     * @brief The kept results, best first
+     */
+    std::vector<DistributedResult> sorted() const;
+
+    size_t size() const { return heap_.size(); }
+
+private:
+    bool better(const DistributedResult& a, const DistributedResult& b) const;
+
+    size_t k_;
+    SweepRanking ranking_;
+    std::vector<DistributedResult> heap_;  ///< Worst kept result on top
+};
+
+/**
+ * @class SweepCoordinator
+ * @brief Shards a symbols x grid sweep into work units and serves them to workers
+ *
+ * Single-threaded: one poll() loop accepts workers, reads their results and
+ * keeps every worker's queue of assignments filled.
+ */
+class SweepCoordinator {
+public:
+    SweepCoordinator(std::vector<SweepSymbol> symbols, std::vector<SmaParams> grid,
+                     const DistributedSweepConfig& config = DistributedSweepConfig());
+
+    /**
+     * @brief Starts listening; port 0 picks a free port (see port())
+     * @return false if the port cannot be bound
+     */
+    bool listen(uint16_t port = kDefaultSweepPort);
+
+    uint16_t port() const { return listener_.local_port(); }
+
+    /**
+     * @brief Serves units until every one has completed or failed, then shuts the workers down
+     * @param progress Stream for periodic progress lines, or nullptr
+     * @return The top_k results over all symbols, best first
+     */
+    std::vector<DistributedResult> run(std::ostream* progress = nullptr);
+
+    const DistributedSweepStats& stats() const { return stats_; }
+    size_t units() const { return units_.size(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class UnitState { Pending, Running, Done, Failed };
+
+    struct Unit {
+        uint32_t symbol;
+        uint64_t begin;           ///< First grid point
+        uint64_t end;             ///< One past the last grid point
+        UnitState state = UnitState::Pending;
+        size_t attempts = 0;      ///< Assignments so far
+        size_t active = 0;        ///< Workers currently running it
+        Clock::time_point started;
+    };
+
+    struct Connection {
+        TcpSocket socket;
+        std::vector<char> input;            ///< Bytes received and not parsed yet
+        bool joined = false;                ///< Hello received and Job sent
+        std::vector<uint64_t> in_flight;    ///< Units assigned and not answered
+        uint32_t threads = 0;               ///< SweepEngine threads the worker announced
+    };
+
+    bool handle(Connection& connection, SweepMessage type, const char* payload, size_t size);
+    bool handle_result(Connection& connection, const char* payload, size_t size);
+    bool send_job(const Connection& connection) const;
+    bool fill(Connection& connection);
+    int64_t next_unit(const Connection& connection, bool& speculative);
+    void drop(Connection& connection);
+    void finish_unit(uint64_t id, bool ok);
+    void report(std::ostream& os) const;
+
+    std::vector<SweepSymbol> symbols_;
+    std::vector<SmaParams> grid_;
+    DistributedSweepConfig config_;
+    TcpSocket listener_;
+    std::vector<Unit> units_;
+    std::deque<uint64_t> pending_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    StreamingTopK top_;
+    DistributedSweepStats stats_;
+    double unit_seconds_ = 0.0;  ///< Sum of the durations of completed units
+    Clock::time_point start_;
+};
+
+/**
+ * @class SweepWorker
+ * @brief Connects to a coordinator and runs the units it is assigned
+ *
+ * Loaded symbols stay mapped between units so consecutive blocks of the same
+ * symbol do not reload it; the least recently used one is released beyond
+ * cached_symbols.
+ */
+class SweepWorker {
+public:
+    /**
+     * @param threads SweepEngine threads per unit (0 = hardware concurrency)
+     * @param cached_symbols Symbols kept loaded between units
+     */
+    explicit SweepWorker(size_t threads = 0, size_t cached_symbols = 16);
+
+    /**
+     * @brief Serves one coordinator until it sends Shutdown
+     * @param connect_attempts Connection attempts, 100 ms apart, for workers started before the coordinator
+     * @return false if the connection could not be made or broke; reported on std::cerr
+     */
+    bool run(const std::string& host, uint16_t port, size_t connect_attempts = 50);
+
+    size_t units_done() const { return units_done_; }
+
+private:
+    const DataHandler* load(uint32_t symbol, std::string& error);
+
+    size_t threads_;
+    size_t cached_symbols_;
+    SweepConfig config_;
+    size_t top_k_ = 0;
+    std::vector<SmaParams> grid_;
+    std::vector<SweepSymbol> symbols_;
+    std::map<uint32_t, std::unique_ptr<DataHandler>> loaded_;
+    std::deque<uint32_t> load_order_;  ///< Least recently loaded first
+    size_t units_done_ = 0;
+};
+
+/**
+ * @brief Prints results as an aligned table with a symbol column
+ */
+void print_distributed_results(std::ostream& os, const std::vector<DistributedResult>& results);
+
+} // namespace backtest
+
+#endif // DISTRIBUTED_SWEEP_HPP
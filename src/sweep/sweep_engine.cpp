@@ -0,0 +1,327 @@
+/**
+ * @file sweep_engine.cpp
+ * @brief Implementation of the parallel SMA parameter sweep
+ */
+
+#include "sweep_engine.hpp"
+#include "../indicators/rolling_mean_cache.hpp"
+#include "../portfolio/portfolio.hpp"
+#include "../strategy/sma_strategy.hpp"
+#include "../util/run_arena.hpp"
+#include "../util/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace backtest {
+
+SweepEngine::SweepEngine(const BarColumns& bars, const SweepConfig& config)
+    : bars_(bars), config_(config) {
+    if (config_.block_size == 0) {
+        config_.block_size = 1;
+    }
+    config_.warmup_bars = std::min(config_.warmup_bars, bars_.size());
+}
+
+SweepEngine::SweepEngine(const CompactBarStore& bars, const SweepConfig& config)
+    : SweepEngine(BarColumns{}, config) {
+    compact_ = &bars;
+    config_.warmup_bars = std::min(config.warmup_bars, bars.size());
+}
+
+Span<const double> SweepEngine::closes(size_t offset, size_t count, std::pmr::vector<double>& scratch) const {
+    if (compact_ == nullptr) {
+        return bars_.close.subspan(offset, count);
+    }
+    scratch.resize(count);
+    compact_->decode_closes(offset, count, scratch.data());
+    return scratch;
+}
+
+BarColumns SweepEngine::block(size_t offset, size_t count, DecodedBars& scratch) const {
+    if (compact_ == nullptr) {
+        return bars_.slice(offset, count);
+    }
+    return compact_->decode(offset, count, scratch);
+}
+
+std::vector<SmaParams> SweepEngine::make_grid(const std::vector<size_t>& short_windows,
+                                              const std::vector<size_t>& long_windows) {
+    std::vector<SmaParams> grid;
+    grid.reserve(short_windows.size() * long_windows.size());
+    for (size_t short_window : short_windows) {
+        for (size_t long_window : long_windows) {
+            if (short_window < long_window) {
+                grid.push_back(SmaParams{short_window, long_window});
+            }
+        }
+    }
+    return grid;
+}
+
+namespace {
+
+    /**
+     * @brief Long/flat execution rule shared by the strategy and cached paths
+     */
+    class LongFlatTrader {
+    public:
+        LongFlatTrader(const SweepConfig& config, SymbolId symbol, SweepResult& result,
+                       std::pmr::memory_resource* resource)
+            : config_(config), symbol_(symbol), result_(result), portfolio_(config.initial_capital, resource),
+              performance_(config.initial_capital, config.periods_per_year), held_(0) {}
+
+        void on_bar(SignalType type, double price) {
+            if (type == SignalType::BUY && held_ == 0) {
+                const int quantity = static_cast<int>(
+                    std::floor((portfolio_.cash() - config_.commission) / price));
+                if (quantity > 0) {
+                    portfolio_.open_position(symbol_, quantity, price, config_.commission);
+                    performance_.on_fill(quantity * price);
+                    held_ = quantity;
+                    ++result_.trades;
+                }
+            } else if (type == SignalType::SELL && held_ > 0) {
+                const double realized = portfolio_.realized_pnl();
+                portfolio_.close_position(symbol_, held_, price, config_.commission);
+                performance_.on_fill(held_ * price);
+                performance_.on_round_trip(portfolio_.realized_pnl() - realized);
+                held_ = 0;
+                ++result_.trades;
+            } else if (held_ != 0) {
+                portfolio_.update_price(symbol_, price);
+            }
+            performance_.on_bar(portfolio_.total_value());
+        }
+
+        void finish() {
+            result_.final_value = portfolio_.total_value();
+            result_.total_return = result_.final_value / config_.initial_capital - 1.0;
+            result_.realized_pnl = portfolio_.realized_pnl();
+            result_.metrics = performance_.metrics();
+        }
+
+    private:
+        const SweepConfig& config_;
+        SymbolId symbol_;
+        SweepResult& result_;
+        Portfolio portfolio_;
+        PerformanceTracker performance_;
+        int held_;
+    };
+
+} // namespace
+
+/**
+ * @brief Replays all bars through one strategy/portfolio pair
+ *
+ * The strategy, portfolio, signal buffer and decode scratch are local to the
+ * call, which is what makes concurrent runs over the same columns safe.
+ */
+SweepResult SweepEngine::run_one(const SmaParams& params, std::pmr::memory_resource* resource) const {
+    SweepResult result{params, config_.initial_capital, 0.0, 0.0, 0, PerformanceMetrics{}};
+    const size_t n_bars = size();
+    if (n_bars == 0) {
+        return result;
+    }
+
+    SMAStrategy strategy(params.short_window, params.long_window, resource);
+    std::pmr::vector<Signal> signals(std::min(config_.block_size, n_bars), resource);
+    DecodedBars scratch(resource);
+
+    LongFlatTrader trader(config_, symbol(), result, resource);
+
+    // Warm-up bars only feed the strategy; the block boundary at warmup_bars keeps the loop below branch-free
+    size_t remaining_warmup = config_.warmup_bars;
+    for (size_t offset = 0; offset < n_bars;) {
+        const size_t n = std::min(remaining_warmup > 0 ? std::min(remaining_warmup, config_.block_size)
+                                                       : config_.block_size,
+                                  n_bars - offset);
+        const BarColumns bars = block(offset, n, scratch);
+        offset += n;
+        strategy.on_bars(bars, Span<Signal>(signals.data(), n));
+        if (remaining_warmup > 0) {
+            remaining_warmup -= n;
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            trader.on_bar(signals[i].type, bars.close[i]);
+        }
+    }
+
+    trader.finish();
+    return result;
+}
+
+bool SweepEngine::cacheable(const SmaParams& params) {
+    // SMAStrategy caps the short window during warm-up only when short >= long
+    return params.short_window >= 1 && params.short_window < params.long_window;
+}
+
+/**
+ * @brief Replays all bars using precomputed mean series instead of a strategy
+ *
+ * Applies SMAStrategy's rules to the cached means: HOLD until long_window
+ * bars have been seen, then BUY/SELL on short above/below long. Warm-up bars
+ * are skipped, as their signals are never traded.
+ */
+SweepResult SweepEngine::run_cached(const SmaParams& params, const RollingMeanCache& cache,
+                                    std::pmr::memory_resource* resource) const {
+    SweepResult result{params, config_.initial_capital, 0.0, 0.0, 0, PerformanceMetrics{}};
+    const size_t n_bars = size();
+    if (n_bars == 0) {
+        return result;
+    }
+
+    const Span<const double> short_means = cache.means(params.short_window);
+    const Span<const double> long_means = cache.means(params.long_window);
+    LongFlatTrader trader(config_, symbol(), result, resource);
+    std::pmr::vector<double> scratch(resource);
+
+    const size_t first = config_.warmup_bars;
+    const size_t warmup = std::max(first, std::min(params.long_window - 1, n_bars));
+    for (size_t offset = first; offset < n_bars;) {
+        const size_t n = std::min(config_.block_size, n_bars - offset);
+        const Span<const double> close = closes(offset, n, scratch);
+        const size_t held = std::min(n, warmup > offset ? warmup - offset : 0);
+        for (size_t k = 0; k < held; ++k) {
+            trader.on_bar(SignalType::HOLD, close[k]);
+        }
+        for (size_t k = held; k < n; ++k) {
+            const size_t i = offset + k;
+            const double short_mean = short_means[i];
+            const double long_mean = long_means[i];
+            const SignalType type = short_mean > long_mean ? SignalType::BUY
+                                  : short_mean < long_mean ? SignalType::SELL
+                                  : SignalType::HOLD;
+            trader.on_bar(type, close[k]);
+        }
+        offset += n;
+    }
+
+    trader.finish();
+    return result;
+}
+
+std::vector<SweepResult> SweepEngine::run(const std::vector<SmaParams>& grid) const {
+    // Clamp so the pool never starts threads that would only sleep
+    ThreadPool pool(std::min(config_.threads == 0 ? std::thread::hardware_concurrency() : config_.threads,
+                             std::max<size_t>(grid.size(), 1)));
+    return run_on(grid, &pool);
+}
+
+std::vector<SweepResult> SweepEngine::run_serial(const std::vector<SmaParams>& grid) const {
+    return run_on(grid, nullptr);
+}
+
+std::vector<SweepResult> SweepEngine::run_on(const std::vector<SmaParams>& grid, ThreadPool* pool) const {
+    std::vector<SweepResult> results(grid.size());
+    auto for_each = [pool](size_t n, auto&& fn) {
+        if (pool != nullptr) {
+            pool->parallel_for(n, fn);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                fn(i);
+            }
+        }
+    };
+
+    // Each run's state dies with the run, so its memory is released wholesale
+    auto run_point = [&](size_t i, const RollingMeanCache* cache) {
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+        if (config_.run_arena) {
+            thread_local RunArena arena;
+            arena.reset();
+            resource = arena.resource();
+        }
+        results[i] = cache != nullptr && cacheable(grid[i]) ? run_cached(grid[i], *cache, resource)
+                                                            : run_one(grid[i], resource);
+    };
+
+    if (config_.share_indicators) {
+        RollingMeanCache cache;
+        std::pmr::vector<double> scratch;
+        for (size_t offset = 0; offset < size(); offset += config_.block_size) {
+            cache.extend(closes(offset, std::min(config_.block_size, size() - offset), scratch));
+        }
+        std::vector<size_t> windows;
+        windows.reserve(grid.size() * 2);
+        for (const SmaParams& params : grid) {
+            if (cacheable(params)) {
+                windows.push_back(params.short_window);
+                windows.push_back(params.long_window);
+            }
+        }
+        const std::vector<size_t> pending = cache.request(windows);
+        for_each(pending.size(), [&](size_t i) {
+            cache.compute(pending[i]);
+        });
+        last_indicator_passes_ = cache.windows();
+
+        for_each(grid.size(), [&](size_t i) {
+            run_point(i, &cache);
+        });
+    } else {
+        last_indicator_passes_ = grid.size();
+        for_each(grid.size(), [&](size_t i) {
+            run_point(i, nullptr);
+        });
+    }
+
+    const SweepRanking ranking = config_.rank_by;
+    std::sort(results.begin(), results.end(), [ranking](const SweepResult& a, const SweepResult& b) {
+        return ranks_before(a, b, ranking);
+    });
+    return results;
+}
+
+double ranking_score(const SweepResult& result, SweepRanking ranking) {
+    switch (ranking) {
+        case SweepRanking::TotalReturn: return result.total_return;
+        case SweepRanking::Sharpe: return result.metrics.sharpe;
+        case SweepRanking::Sortino: return result.metrics.sortino;
+        case SweepRanking::Drawdown: return -result.metrics.max_drawdown;
+    }
+    return result.total_return;
+}
+
+bool ranks_before(const SweepResult& a, const SweepResult& b, SweepRanking ranking) {
+    const double score_a = ranking_score(a, ranking);
+    const double score_b = ranking_score(b, ranking);
+    if (score_a != score_b) return score_a > score_b;
+    if (a.params.short_window != b.params.short_window) return a.params.short_window < b.params.short_window;
+    return a.params.long_window < b.params.long_window;
+}
+
+bool parse_sweep_ranking(const std::string& name, SweepRanking& ranking) {
+    if (name == "return") {
+        ranking = SweepRanking::TotalReturn;
+    } else if (name == "sharpe") {
+        ranking = SweepRanking::Sharpe;
+    } else if (name == "sortino") {
+        ranking = SweepRanking::Sortino;
+    } else if (name == "drawdown") {
+        ranking = SweepRanking::Drawdown;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void print_sweep_results(std::ostream& os, const std::vector<SweepResult>& results, size_t top_n) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "%4s %6s %6s %14s %10s %8s %8s %8s\n",
+                  "rank", "short", "long", "final_value", "return", "trades", "sharpe", "max_dd");
+    os << line;
+    const size_t n = std::min(top_n, results.size());
+    for (size_t i = 0; i < n; ++i) {
+        const SweepResult& r = results[i];
+        std::snprintf(line, sizeof(line), "%4zu %6zu %6zu %14.2f %9.2f%% %8zu %8.2f %7.2f%%\n",
+                      i + 1, r.params.short_window, r.params.long_window,
+                      r.final_value, r.total_return * 100.0, r.trades,
+                      r.metrics.sharpe, r.metrics.max_drawdown * 100.0);
+        os << line;
+    }
+}
+
+} // namespace backtest
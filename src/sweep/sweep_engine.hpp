@@ -0,0 +1,222 @@
+/**
+ * @file sweep_engine.hpp
+ * @brief Parallel parameter sweep of SMAStrategy over one loaded dataset
+ *
+ * Loads nothing itself: the engine replays a shared, read-only set of bar
+ * columns for every (short, long) window combination of a grid, each run with
+ * its own strategy, Portfolio and cursor, spread over a work-stealing pool.
+ * The columns are either doubles or a CompactBarStore in the configured
+ * price layout, which each run widens a block at a time.
+ */
+
+#ifndef SWEEP_ENGINE_HPP
+#define SWEEP_ENGINE_HPP
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../data/bar_store.hpp"
+#include "../data/compact_bar_store.hpp"
+#include "../engine/performance_tracker.hpp"
+
+namespace backtest {
+
+class RollingMeanCache;
+class ThreadPool;
+
+/**
+ * @enum SweepRanking
+ * @brief Metric run() ranks results by, best first
+ */
+enum class SweepRanking {
+    TotalReturn,  ///< Highest total return
+    Sharpe,       ///< Highest annualized Sharpe ratio
+    Sortino,      ///< Highest annualized Sortino ratio
+    Drawdown      ///< Smallest maximum drawdown
+};
+
+/**
+ * @struct SweepConfig
+ * @brief Settings shared by every run of a sweep
+ */
+struct SweepConfig {
+    double initial_capital = 100000.0;  ///< Starting cash of each run's Portfolio
+    double commission = 0.0;            ///< Commission charged per fill
+    size_t threads = 0;                 ///< Worker threads (0 = hardware concurrency)
+    size_t block_size = 4096;           ///< Bars per SMAStrategy::on_bars() call
+    bool share_indicators = true;       ///< Compute each distinct window's means once for the whole grid
+    bool run_arena = true;              ///< Allocate each run's state from a reusable per-thread RunArena
+    size_t warmup_bars = 0;             ///< Leading bars that only warm up the strategies; trading starts after them
+    SweepRanking rank_by = SweepRanking::TotalReturn;  ///< Order of run()'s results
+    double periods_per_year = kDefaultPeriodsPerYear;  ///< Bars per year, for annualized metrics
+};
+
+/**
+ * @struct SmaParams
+ * @brief One point of the parameter grid
+ */
+struct SmaParams {
+    size_t short_window;  ///< Short moving-average window
+    size_t long_window;   ///< Long moving-average window
+};
+
+/**
+ * @struct SweepResult
+ * @brief Outcome of one backtest run in a sweep
+ */
+struct SweepResult {
+    SmaParams params;       ///< Windows used for the run
+    double final_value;     ///< Portfolio::total_value() after the last bar
+    double total_return;    ///< final_value / initial_capital - 1
+    double realized_pnl;    ///< Portfolio::realized_pnl() after the last bar
+    size_t trades;          ///< Number of fills (entries + exits)
+    PerformanceMetrics metrics;  ///< Risk and trading metrics of the traded bars
+};
+
+/**
+ * @class SweepEngine
+ * @brief Runs a grid of SMAStrategy/Portfolio backtests in parallel
+ *
+ * Every run trades a single long/flat rule: on BUY while flat it invests all
+ * available cash at the close, on SELL while long it exits the whole
+ * position. Signals are computed in blocks with SMAStrategy::on_bars() and
+ * the Portfolio is updated bar by bar. Runs share nothing mutable, so the
+ * results do not depend on the number of threads.
+ *
+ * With SweepConfig::share_indicators, run() first materializes the mean
+ * series of every distinct window in the grid once (in parallel) and each
+ * short < long run only compares two cached series. The cached means are
+ * bit-identical to SMAStrategy's, so both paths produce the same results.
+ *
+ * With SweepConfig::run_arena, each worker thread keeps one RunArena and
+ * every run's strategy, Portfolio and signal buffer are allocated from it and
+ * released together when the run ends, so many short runs do not contend in
+ * the global allocator.
+ *
+ * Every run feeds a PerformanceTracker as it trades, so Sharpe, Sortino,
+ * drawdown, turnover and hit rate are available for ranking without storing
+ * any equity curve.
+ *
+ * With SweepConfig::warmup_bars, the first bars are fed to the strategies but
+ * not traded, so a run over a slice of a longer history (see
+ * WalkForwardRunner) starts with filled moving-average windows.
+ */
+class SweepEngine {
+public:
+    /**
+     * @brief Creates an engine over bars that stay alive and unmodified during run()
+     * @param bars Single-symbol bar columns, oldest first (e.g. DataHandler::columns())
+     * @param config Shared run settings
+     */
+    explicit SweepEngine(const BarColumns& bars, const SweepConfig& config = SweepConfig());
+
+    /**
+     * @brief Creates an engine over compact bars that stay alive and unmodified during run()
+     *
+     * Runs read the narrower price columns and widen each block of closes to
+     * double (see decode_closes()) right before use, so every pass over the
+     * history moves fewer bytes; means, signals and P&L are computed in
+     * double exactly as for double columns holding the decoded prices.
+     */
+    explicit SweepEngine(const CompactBarStore& bars, const SweepConfig& config = SweepConfig());
+
+    /**
+     * @brief Runs every grid point and returns the results ranked best first
+     *
+     * Results are sorted by SweepConfig::rank_by, ties broken by windows.
+     */
+    std::vector<SweepResult> run(const std::vector<SmaParams>& grid) const;
+
+    /**
+     * @brief Same as run(), but on the calling thread only
+     *
+     * For callers that already parallelize over several engines, e.g. from
+     * inside ThreadPool tasks (where run() must not nest its own pool wait).
+     */
+    std::vector<SweepResult> run_serial(const std::vector<SmaParams>& grid) const;
+
+    /**
+     * @brief Runs a single grid point on the calling thread through SMAStrategy
+     * @param resource Memory resource for the run's strategy, portfolio and buffers
+     */
+    SweepResult run_one(const SmaParams& params,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    /**
+     * @brief Runs a single grid point from cached mean series
+     * @param resource Memory resource for the run's portfolio
+     * @pre cacheable(params), and both windows are computed in cache
+     */
+    SweepResult run_cached(const SmaParams& params, const RollingMeanCache& cache,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    /**
+     * @brief Whether a grid point can be served from shared series (1 <= short < long)
+     */
+    static bool cacheable(const SmaParams& params);
+
+    /**
+     * @brief Builds the cross product of short and long windows, skipping short >= long
+     */
+    static std::vector<SmaParams> make_grid(const std::vector<size_t>& short_windows,
+                                            const std::vector<size_t>& long_windows);
+
+    const SweepConfig& config() const { return config_; }
+
+    /**
+     * @brief Moving-average passes the last run() performed
+     *
+     * Number of distinct windows with sharing enabled, one per grid point otherwise.
+     */
+    size_t last_indicator_passes() const { return last_indicator_passes_; }
+
+private:
+    /**
+     * @brief Shared body of run() and run_serial(); pool == nullptr runs inline
+     */
+    std::vector<SweepResult> run_on(const std::vector<SmaParams>& grid, ThreadPool* pool) const;
+
+    size_t size() const { return compact_ != nullptr ? compact_->size() : bars_.size(); }
+    SymbolId symbol() const { return compact_ != nullptr ? compact_->symbol_ids()[0] : bars_.symbol_ids[0]; }
+
+    /**
+     * @brief Closes [offset, offset + count): viewed in place, or decoded into scratch
+     */
+    Span<const double> closes(size_t offset, size_t count, std::pmr::vector<double>& scratch) const;
+
+    /**
+     * @brief Rows [offset, offset + count): viewed in place, or decoded into scratch
+     */
+    BarColumns block(size_t offset, size_t count, DecodedBars& scratch) const;
+
+    BarColumns bars_;
+    const CompactBarStore* compact_ = nullptr;  ///< Bars to decode instead of bars_, if set
+    SweepConfig config_;
+    mutable size_t last_indicator_passes_ = 0;
+};
+
+/**
+ * @brief Score of a result under a ranking; higher is better
+ */
+double ranking_score(const SweepResult& result, SweepRanking ranking);
+
+/**
+ * @brief Order of SweepEngine::run(): higher score first, ties broken by smaller windows
+ */
+bool ranks_before(const SweepResult& a, const SweepResult& b, SweepRanking ranking);
+
+/**
+ * @brief Parses "return", "sharpe", "sortino" or "drawdown" into a SweepRanking
+ * @return false if name is none of them
+ */
+bool parse_sweep_ranking(const std::string& name, SweepRanking& ranking);
+
+/**
+ * @brief Prints the top_n results as an aligned table
+ */
+void print_sweep_results(std::ostream& os, const std::vector<SweepResult>& results, size_t top_n);
+
+} // namespace backtest
+
+#endif // SWEEP_ENGINE_HPP
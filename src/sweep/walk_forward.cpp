@@ -0,0 +1,113 @@
+/**
+ * @file walk_forward.cpp
+ * @brief Implementation of the walk-forward runner
+ */
+
+#include "walk_forward.hpp"
+#include "../util/thread_pool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+namespace backtest {
+
+WalkForwardRunner::WalkForwardRunner(const BarColumns& bars, const WalkForwardConfig& config)
+    : bars_(bars), config_(config) {
+    if (config_.train_bars == 0) {
+        config_.train_bars = 1;
+    }
+    if (config_.test_bars == 0) {
+        config_.test_bars = 1;
+    }
+    if (config_.step_bars == 0) {
+        config_.step_bars = config_.test_bars;
+    }
+}
+
+std::vector<WalkForwardFold> WalkForwardRunner::folds() const {
+    std::vector<WalkForwardFold> folds;
+    const size_t n = bars_.size();
+    for (size_t start = 0; start + config_.train_bars < n; start += config_.step_bars) {
+        WalkForwardFold fold;
+        fold.train_begin = config_.anchored ? 0 : start;
+        fold.train_end = start + config_.train_bars;
+        fold.test_begin = fold.train_end;
+        fold.test_end = std::min(fold.test_begin + config_.test_bars, n);
+        folds.push_back(fold);
+    }
+    return folds;
+}
+
+SweepEngine WalkForwardRunner::make_engine(size_t begin, size_t end, size_t warmup) const {
+    const size_t lead = std::min(warmup, begin);
+    SweepConfig config = config_.sweep;
+    config.warmup_bars = lead;
+    return SweepEngine(bars_.slice(begin - lead, end - (begin - lead)), config);
+}
+
+void WalkForwardRunner::run_fold(WalkForwardFold& fold, const std::vector<SmaParams>& grid, size_t warmup,
+                                 bool parallel) const {
+    const SweepEngine train = make_engine(fold.train_begin, fold.train_end, warmup);
+    const std::vector<SweepResult> ranked = parallel ? train.run(grid) : train.run_serial(grid);
+    if (ranked.empty()) {
+        return;
+    }
+    fold.train = ranked.front();
+
+    const SweepEngine test = make_engine(fold.test_begin, fold.test_end, warmup);
+    fold.test = test.run_one(fold.train.params);
+}
+
+std::vector<WalkForwardFold> WalkForwardRunner::run(const std::vector<SmaParams>& grid) const {
+    std::vector<WalkForwardFold> result = folds();
+    if (result.empty() || grid.empty()) {
+        return result;
+    }
+
+    size_t warmup = 0;
+    if (config_.warm_start) {
+        for (const SmaParams& params : grid) {
+            warmup = std::max(warmup, std::max(params.short_window, params.long_window));
+        }
+        warmup = warmup > 0 ? warmup - 1 : 0;
+    }
+
+    const size_t threads = config_.sweep.threads == 0 ? std::thread::hardware_concurrency()
+                                                      : config_.sweep.threads;
+    if (result.size() >= threads) {
+        ThreadPool pool(threads);
+        pool.parallel_for(result.size(), [&](size_t i) {
+            run_fold(result[i], grid, warmup, false);
+        });
+    } else {
+        for (WalkForwardFold& fold : result) {
+            run_fold(fold, grid, warmup, true);
+        }
+    }
+    return result;
+}
+
+double walk_forward_return(const std::vector<WalkForwardFold>& folds) {
+    double growth = 1.0;
+    for (const WalkForwardFold& fold : folds) {
+        growth *= 1.0 + fold.test.total_return;
+    }
+    return growth - 1.0;
+}
+
+void print_walk_forward(std::ostream& os, const std::vector<WalkForwardFold>& folds) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%4s %17s %17s %6s %6s %10s %10s %7s\n",
+                  "fold", "train", "test", "short", "long", "train_ret", "test_ret", "trades");
+    os << line;
+    for (size_t i = 0; i < folds.size(); ++i) {
+        const WalkForwardFold& f = folds[i];
+        std::snprintf(line, sizeof(line), "%4zu %8zu-%-8zu %8zu-%-8zu %6zu %6zu %9.2f%% %9.2f%% %7zu\n",
+                      i + 1, f.train_begin, f.train_end, f.test_begin, f.test_end,
+                      f.train.params.short_window, f.train.params.long_window,
+                      f.train.total_return * 100.0, f.test.total_return * 100.0, f.test.trades);
+        os << line;
+    }
+}
+
+} // namespace backtest
@@ -0,0 +1,112 @@
+/**
+ * @file walk_forward.hpp
+ * @brief Walk-forward validation of SMA parameters over one loaded dataset
+ *
+ * Each fold optimizes the SMA windows over a training range with a
+ * SweepEngine and then trades the best windows over the following test
+ * range. Ranges are zero-copy slices of the loaded columns, folds are
+ * independent and run in parallel, and each range's strategies are warmed up
+ * from the bars just before it, so no fold replays the history from the start.
+ */
+
+#ifndef WALK_FORWARD_HPP
+#define WALK_FORWARD_HPP
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "sweep_engine.hpp"
+#include "../data/bar_store.hpp"
+
+namespace backtest {
+
+/**
+ * @struct WalkForwardConfig
+ * @brief Fold layout and run settings of a walk-forward analysis
+ */
+struct WalkForwardConfig {
+    size_t train_bars = 500;  ///< Bars in each optimization range
+    size_t test_bars = 100;   ///< Bars in each out-of-sample range
+    size_t step_bars = 0;     ///< Offset between consecutive folds (0 = test_bars)
+    bool anchored = false;    ///< Training ranges all start at bar 0 (expanding window)
+    bool warm_start = true;   ///< Warm strategies up on the bars preceding each range
+    SweepConfig sweep;        ///< Capital, commission, threads and sweep options of every run
+};
+
+/**
+ * @struct WalkForwardFold
+ * @brief Ranges and results of one fold; ranges are [begin, end) bar indices
+ */
+struct WalkForwardFold {
+    size_t train_begin = 0;
+    size_t train_end = 0;
+    size_t test_begin = 0;
+    size_t test_end = 0;
+    SweepResult train{};  ///< Best grid point over the training range
+    SweepResult test{};   ///< The same windows traded over the test range
+};
+
+/**
+ * @class WalkForwardRunner
+ * @brief Runs optimize-then-test folds over shared, read-only bar columns
+ *
+ * With warm_start, a range beginning at bar b is run over the slice
+ * [b - w, end) with SweepConfig::warmup_bars = w, where w is the longest
+ * window of the grid minus one (capped at b). Strategies therefore start the
+ * range with full moving averages, as if the whole history had been replayed,
+ * while only w extra bars are processed. Without warm_start every range is run
+ * cold, like a separately loaded file. Each range trades a fresh Portfolio.
+ *
+ * Folds are spread over a thread pool, each running its sweep serially; with
+ * fewer folds than threads the folds run one after another and each sweep
+ * uses the pool instead. Results do not depend on the thread count.
+ */
+class WalkForwardRunner {
+public:
+    /**
+     * @param bars Single-symbol bar columns, oldest first, alive and unmodified during run()
+     * @param config Fold layout and run settings
+     */
+    WalkForwardRunner(const BarColumns& bars, const WalkForwardConfig& config);
+
+    /**
+     * @brief Fold ranges for the configured layout (results not yet filled in)
+     *
+     * Folds advance by step_bars while a training range fits; the last test
+     * range may be shorter than test_bars.
+     */
+    std::vector<WalkForwardFold> folds() const;
+
+    /**
+     * @brief Optimizes every fold over grid and trades the winner out of sample
+     *
+     * The best training result is the one SweepEngine::run() ranks first.
+     */
+    std::vector<WalkForwardFold> run(const std::vector<SmaParams>& grid) const;
+
+    const WalkForwardConfig& config() const { return config_; }
+
+private:
+    /**
+     * @brief Engine over [begin, end), preceded by up to warmup bars of history
+     */
+    SweepEngine make_engine(size_t begin, size_t end, size_t warmup) const;
+
+    void run_fold(WalkForwardFold& fold, const std::vector<SmaParams>& grid, size_t warmup, bool parallel) const;
+
+    BarColumns bars_;
+    WalkForwardConfig config_;
+};
+
+/**
+ * @brief Compounded out-of-sample return of consecutive folds' test ranges
+ */
+double walk_forward_return(const std::vector<WalkForwardFold>& folds);
+
+/**
+ * @brief Prints one line per fold: ranges, chosen windows, in- and out-of-sample returns
+ */
+void print_walk_forward(std::ostream& os, const std::vector<WalkForwardFold>& folds);
+
+} // namespace backtest
+
+#endif // WALK_FORWARD_HPP
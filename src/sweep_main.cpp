@@ -0,0 +1,85 @@
+/**
+ * @file sweep_main.cpp
+ * @brief Command-line driver for the SMA parameter sweep
+ *
+ * Usage:
+ *   sweep [csv] [short_min short_max short_step] [long_min long_max long_step] [threads]
+ *         [return|sharpe|sortino|drawdown]
+ *
+ * Loads the file once and runs every short < long window combination in
+ * parallel, then prints the ten best runs by the chosen metric (total
+ * return by default). Builds configured with BACKTEST_PRICE_STORAGE=float
+ * or ticks load the file straight into a CompactBarStore and sweep that.
+ */
+
+#include "data/data_handler.hpp"
+#include "sweep/sweep_engine.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+    std::vector<size_t> make_range(size_t first, size_t last, size_t step) {
+        std::vector<size_t> values;
+        for (size_t v = first; v <= last; v += (step == 0 ? 1 : step)) {
+            values.push_back(v);
+        }
+        return values;
+    }
+
+    size_t arg_or(int argc, char** argv, int index, size_t fallback) {
+        return argc > index ? std::strtoull(argv[index], nullptr, 10) : fallback;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "../data/sample_data.csv";
+    const std::vector<size_t> short_windows =
+        make_range(arg_or(argc, argv, 2, 2), arg_or(argc, argv, 3, 10), arg_or(argc, argv, 4, 1));
+    const std::vector<size_t> long_windows =
+        make_range(arg_or(argc, argv, 5, 5), arg_or(argc, argv, 6, 40), arg_or(argc, argv, 7, 5));
+
+    backtest::SweepConfig config;
+    config.threads = arg_or(argc, argv, 8, 0);
+    if (argc > 9 && !backtest::parse_sweep_ranking(argv[9], config.rank_by)) {
+        std::cerr << "Unknown ranking: " << argv[9] << " (expected return, sharpe, sortino or drawdown)" << std::endl;
+        return 1;
+    }
+
+    constexpr bool kCompact = !std::is_same<backtest::PriceCodec, backtest::DoublePriceCodec>::value;
+    backtest::DataHandler data;
+    backtest::CompactBarStore compact;
+    const bool loaded = kCompact ? data.load_compact_csv(path, "SPY", compact)
+                                 : data.load_csv(path, "SPY", backtest::LoadMode::MemoryMapped);
+    if (!loaded) {
+        std::cout << "Failed to load data" << std::endl;
+        return 1;
+    }
+    const size_t n_bars = kCompact ? compact.size() : data.size();
+
+    const std::vector<backtest::SmaParams> grid =
+        backtest::SweepEngine::make_grid(short_windows, long_windows);
+    const backtest::SweepEngine engine = kCompact ? backtest::SweepEngine(compact, config)
+                                                  : backtest::SweepEngine(data.columns(), config);
+
+    std::cout << "Loaded " << n_bars << " bars (" << backtest::PriceCodec::name << " prices, "
+              << (kCompact ? compact.bytes()
+                       : n_bars * backtest::BasicCompactBarStore<backtest::DoublePriceCodec>::bytes_per_bar()) << " bytes), sweeping "
+              << grid.size() << " window combinations" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<backtest::SweepResult> results = engine.run(grid);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    backtest::print_sweep_results(std::cout, results, 10);
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout << grid.size() << " runs in " << seconds * 1e3 << " ms ("
+              << static_cast<double>(grid.size()) * static_cast<double>(n_bars) / seconds
+              << " bars/s, " << engine.last_indicator_passes() << " moving-average passes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file profiler.cpp
+ * @brief Registry, report and allocation counting of the instrumentation layer
+ */
+
+#include "profiler.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_allocated_bytes{0};
+    std::atomic<uint64_t> g_frees{0};
+
+    /**
+     * @brief Every thread's profile, kept after the thread exits so the report sees it
+     */
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadProfile>> profiles;
+        uint64_t start_ticks = profile_ticks();
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    };
+
+    Registry& registry() {
+        static Registry* instance = new Registry();  // Never destroyed: threads may outlive statics
+        return *instance;
+    }
+
+    /**
+     * @brief Profiling clock ticks per nanosecond, measured since the last reset
+     */
+    double ticks_per_ns() {
+        Registry& r = registry();
+        // A too-short interval makes the ratio noisy; wait for at least 10 ms
+        auto now = std::chrono::steady_clock::now();
+        while (now - r.start_time < std::chrono::milliseconds(10)) {
+            now = std::chrono::steady_clock::now();
+        }
+        const uint64_t ticks = profile_ticks() - r.start_ticks;
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - r.start_time).count());
+        return ns > 0.0 ? static_cast<double>(ticks) / ns : 1.0;
+    }
+
+} // namespace
+
+const char* stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::Load: return "load";
+        case Stage::Parse: return "parse";
+        case Stage::CacheIO: return "cache_io";
+        case Stage::Bar: return "bar";
+        case Stage::Indicators: return "indicators";
+        case Stage::Portfolio: return "portfolio";
+        case Stage::Execution: return "execution";
+        case Stage::Output: return "output";
+        case Stage::Count: break;
+    }
+    return "?";
+}
+
+const char* counter_name(Counter counter) {
+    switch (counter) {
+        case Counter::RowsParsed: return "rows_parsed";
+        case Counter::RowsMalformed: return "rows_malformed";
+        case Counter::Bars: return "bars";
+        case Counter::Signals: return "signals";
+        case Counter::Fills: return "fills";
+        case Counter::Count: break;
+    }
+    return "?";
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+}
+
+void LatencyHistogram::clear() {
+    for (uint64_t& c : counts_) {
+        c = 0;
+    }
+    total_ = 0;
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const unsigned msb = static_cast<unsigned>(bucket / kSubBuckets) + 3;
+    const uint64_t sub = bucket % kSubBuckets;
+    const uint64_t width = uint64_t(1) << (msb - 4);
+    return ((kSubBuckets + sub) << (msb - 4)) + width - 1;
+}
+
+uint64_t LatencyHistogram::quantile(double q) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    const double target = q * static_cast<double>(total_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts_[i];
+        if (counts_[i] != 0 && static_cast<double>(seen) >= target) {
+            return bucket_upper(i);
+        }
+    }
+    return bucket_upper(kBuckets - 1);
+}
+
+ThreadProfile& thread_profile() {
+    thread_local ThreadProfile* profile = nullptr;
+    if (profile == nullptr) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.profiles.push_back(std::make_unique<ThreadProfile>());
+        profile = r.profiles.back().get();
+    }
+    return *profile;
+}
+
+void profile_reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& profile : r.profiles) {
+        *profile = ThreadProfile();
+    }
+    r.start_ticks = profile_ticks();
+    r.start_time = std::chrono::steady_clock::now();
+    g_allocations = 0;
+    g_allocated_bytes = 0;
+    g_frees = 0;
+}
+
+void print_profile_report(std::ostream& os) {
+    if (!kInstrumentationEnabled) {
+        os << "Instrumentation disabled (configure with -DBACKTEST_INSTRUMENT=ON)" << std::endl;
+        return;
+    }
+
+    const double tpn = ticks_per_ns();
+    ThreadProfile total;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& profile : r.profiles) {
+            for (size_t s = 0; s < static_cast<size_t>(Stage::Count); ++s) {
+                total.stage_ticks[s] += profile->stage_ticks[s];
+                total.stage_calls[s] += profile->stage_calls[s];
+            }
+            for (size_t c = 0; c < static_cast<size_t>(Counter::Count); ++c) {
+                total.counters[c] += profile->counters[c];
+            }
+            total.bar_latency.merge(profile->bar_latency);
+        }
+    }
+
+    char line[160];
+    os << "Instrumentation report (stage times are inclusive)" << std::endl;
+    std::snprintf(line, sizeof(line), "%-12s %12s %12s %12s\n", "stage", "total_ms", "calls", "ns/call");
+    os << line;
+    for (size_t s = 0; s < static_cast<size_t>(Stage::Count); ++s) {
+        if (total.stage_calls[s] == 0) {
+            continue;
+        }
+        const double ns = static_cast<double>(total.stage_ticks[s]) / tpn;
+        std::snprintf(line, sizeof(line), "%-12s %12.3f %12llu %12.1f\n", stage_name(static_cast<Stage>(s)),
+                      ns * 1e-6, static_cast<unsigned long long>(total.stage_calls[s]),
+                      ns / static_cast<double>(total.stage_calls[s]));
+        os << line;
+    }
+
+    for (size_t c = 0; c < static_cast<size_t>(Counter::Count); ++c) {
+        if (total.counters[c] != 0) {
+            std::snprintf(line, sizeof(line), "%-14s %llu\n", counter_name(static_cast<Counter>(c)),
+                          static_cast<unsigned long long>(total.counters[c]));
+            os << line;
+        }
+    }
+
+    const LatencyHistogram& bars = total.bar_latency;
+    if (bars.count() > 0) {
+        std::snprintf(line, sizeof(line), "bar latency    p50 %.0f ns  p99 %.0f ns  p99.9 %.0f ns  (%llu bars)\n",
+                      static_cast<double>(bars.quantile(0.50)) / tpn,
+                      static_cast<double>(bars.quantile(0.99)) / tpn,
+                      static_cast<double>(bars.quantile(0.999)) / tpn,
+                      static_cast<unsigned long long>(bars.count()));
+        os << line;
+    }
+
+    std::snprintf(line, sizeof(line), "allocations    %llu (%llu bytes), %llu frees\n",
+                  static_cast<unsigned long long>(g_allocations.load()),
+                  static_cast<unsigned long long>(g_allocated_bytes.load()),
+                  static_cast<unsigned long long>(g_frees.load()));
+    os << line;
+}
+
+} // namespace backtest
+
+#if BACKTEST_INSTRUMENT
+
+// Counting replacements of the global allocation functions. They live in this
+// translation unit, which every instrumented binary links, and only count.
+
+namespace {
+
+    void* counted_alloc(std::size_t size, std::size_t alignment) {
+        backtest::g_allocations.fetch_add(1, std::memory_order_relaxed);
+        backtest::g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) {
+            size = 1;
+        }
+        if (alignment <= alignof(std::max_align_t)) {
+            return std::malloc(size);
+        }
+        // aligned_alloc wants a size that is a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void counted_free(void* p) {
+        if (p != nullptr) {
+            backtest::g_frees.fetch_add(1, std::memory_order_relaxed);
+            std::free(p);
+        }
+    }
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = counted_alloc(size, alignof(std::max_align_t))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = counted_alloc(size, alignof(std::max_align_t))) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = counted_alloc(size, static_cast<std::size_t>(alignment))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = counted_alloc(size, static_cast<std::size_t>(alignment))) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+
+#endif // BACKTEST_INSTRUMENT
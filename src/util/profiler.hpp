@@ -0,0 +1,197 @@
+/**
+ * @file profiler.hpp
+ * @brief Opt-in hot-path instrumentation: stage timers, counters, bar latency and allocations
+ *
+ * Configure with -DBACKTEST_INSTRUMENT=ON to enable. The BT_PROFILE_* macros
+ * then time scopes with the CPU timestamp counter (steady_clock where there
+ * is none) into per-thread totals, a per-bar latency histogram yields
+ * p50/p99/p99.9, and global operator new/delete count allocations. Without
+ * the option the macros expand to nothing and the hot paths are unchanged.
+ *
+ * Stage totals are inclusive: Load contains Parse and CacheIO, and Bar
+ * contains Indicators, Portfolio and Execution of the same bar.
+ */
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#ifndef BACKTEST_INSTRUMENT
+#define BACKTEST_INSTRUMENT 0
+#endif
+
+#if BACKTEST_INSTRUMENT && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace backtest {
+
+/// true in builds configured with BACKTEST_INSTRUMENT
+constexpr bool kInstrumentationEnabled = BACKTEST_INSTRUMENT != 0;
+
+/**
+ * @enum Stage
+ * @brief Timed sections of a run
+ */
+enum class Stage {
+    Load,        ///< DataHandler::load_csv, end to end
+    Parse,       ///< CSV parsing into columns
+    CacheIO,     ///< Binary sidecar read/write
+    Bar,         ///< One engine bar: all events it triggers plus equity recording
+    Indicators,  ///< Strategy indicator update and signal (SMAStrategy::on_new_bar/on_bars)
+    Portfolio,   ///< Portfolio fills and marks
+    Execution,   ///< Order sizing and fill simulation
+    Output,      ///< Writing results (e.g. printing signals)
+    Count
+};
+
+/**
+ * @enum Counter
+ * @brief Event counts of a run
+ */
+enum class Counter {
+    RowsParsed,     ///< CSV rows turned into bars
+    RowsMalformed,  ///< CSV rows rejected
+    Bars,           ///< Bars processed by an engine
+    Signals,        ///< BUY/SELL signals
+    Fills,          ///< Fills booked
+    Count
+};
+
+const char* stage_name(Stage stage);
+const char* counter_name(Counter counter);
+
+/**
+ * @brief Current value of the profiling clock (TSC ticks or steady_clock ns)
+ */
+inline uint64_t profile_ticks() {
+#if BACKTEST_INSTRUMENT && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear histogram of durations with ~6% relative resolution
+ *
+ * Values below 16 have their own buckets; above, every power of two is split
+ * into 16 linear sub-buckets. Recording is a bit scan and an increment, and
+ * 1000 buckets cover the full uint64_t range.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBuckets = 16;
+    static constexpr size_t kBuckets = 61 * kSubBuckets + kSubBuckets;
+
+    void record(uint64_t value) {
+        ++counts_[bucket_of(value)];
+        ++total_;
+    }
+
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    uint64_t count() const { return total_; }
+
+    /**
+     * @brief Smallest bucket upper bound with at least fraction q of the values at or below it
+     * @param q Quantile in [0, 1], e.g. 0.99
+     */
+    uint64_t quantile(double q) const;
+
+private:
+    static size_t bucket_of(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        const size_t sub = static_cast<size_t>(value >> (msb - 4)) & (kSubBuckets - 1);
+        return (msb - 3) * kSubBuckets + sub;
+    }
+
+    static uint64_t bucket_upper(size_t bucket);
+
+    uint64_t counts_[kBuckets] = {};
+    uint64_t total_ = 0;
+};
+
+/**
+ * @struct ThreadProfile
+ * @brief Totals recorded by one thread (owned by the profiler registry)
+ */
+struct ThreadProfile {
+    uint64_t stage_ticks[static_cast<size_t>(Stage::Count)] = {};
+    uint64_t stage_calls[static_cast<size_t>(Stage::Count)] = {};
+    uint64_t counters[static_cast<size_t>(Counter::Count)] = {};
+    LatencyHistogram bar_latency;  ///< Ticks per Stage::Bar scope
+};
+
+/**
+ * @brief The calling thread's profile, registered on first use
+ */
+ThreadProfile& thread_profile();
+
+/**
+ * @brief Zeroes all recorded totals of every thread and the allocation counters
+ */
+void profile_reset();
+
+/**
+ * @brief Prints per-stage totals, counters, bar latency percentiles and allocations
+ *
+ * Prints a one-line note instead in builds without BACKTEST_INSTRUMENT.
+ */
+void print_profile_report(std::ostream& os);
+
+/**
+ * @class ScopedStageTimer
+ * @brief Adds the lifetime of the scope to a stage of the calling thread
+ */
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(Stage stage)
+        : profile_(thread_profile()), stage_(static_cast<size_t>(stage)), start_(profile_ticks()) {}
+
+    ~ScopedStageTimer() {
+        const uint64_t elapsed = profile_ticks() - start_;
+        profile_.stage_ticks[stage_] += elapsed;
+        ++profile_.stage_calls[stage_];
+        if (stage_ == static_cast<size_t>(Stage::Bar)) {
+            profile_.bar_latency.record(elapsed);
+        }
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    ThreadProfile& profile_;
+    size_t stage_;
+    uint64_t start_;
+};
+
+} // namespace backtest
+
+#define BT_PROFILE_CONCAT_INNER(a, b) a##b
+#define BT_PROFILE_CONCAT(a, b) BT_PROFILE_CONCAT_INNER(a, b)
+
+#if BACKTEST_INSTRUMENT
+/// Times the enclosing scope as the given Stage
+#define BT_PROFILE_SCOPE(stage) \
+    ::backtest::ScopedStageTimer BT_PROFILE_CONCAT(bt_profile_scope_, __LINE__)(::backtest::Stage::stage)
+/// Adds n to the given Counter
+#define BT_PROFILE_COUNT(counter, n) \
+    (::backtest::thread_profile().counters[static_cast<size_t>(::backtest::Counter::counter)] += (n))
+#else
+#define BT_PROFILE_SCOPE(stage) ((void)0)
+#define BT_PROFILE_COUNT(counter, n) ((void)0)
+#endif
+
+#endif // PROFILER_HPP
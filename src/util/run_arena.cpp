@@ -0,0 +1,39 @@
+/**
+ * @file run_arena.cpp
+ * @brief Implementation of the reusable per-run arena
+ */
+
+#include "run_arena.hpp"
+#include <algorithm>
+
+namespace backtest {
+
+void* RunArena::CountingUpstream::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void RunArena::CountingUpstream::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+RunArena::RunArena(size_t initial_bytes)
+    : block_(new std::byte[std::max<size_t>(initial_bytes, 1024)]),
+      capacity_(std::max<size_t>(initial_bytes, 1024)) {
+    arena_.emplace(block_.get(), capacity_, &upstream_);
+}
+
+void RunArena::reset() {
+    const size_t needed = capacity_ + upstream_.bytes;
+    arena_->release();
+    if (upstream_.bytes > 0) {
+        // The last run outgrew the block: grow it so the next one fits
+        arena_.reset();
+        block_.reset(new std::byte[needed]);
+        capacity_ = needed;
+        arena_.emplace(block_.get(), capacity_, &upstream_);
+    }
+    upstream_.bytes = 0;
+}
+
+} // namespace backtest
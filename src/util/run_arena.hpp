@@ -0,0 +1,85 @@
+/**
+ * @file run_arena.hpp
+ * @brief Reusable monotonic memory arena for the state of one backtest run
+ *
+ * A backtest run allocates its containers (indicator rings, scratch buffers,
+ * the position book, the event ring) once and frees them all when it ends.
+ * Served from the global heap, thousands of short runs on several threads
+ * contend in the allocator. RunArena hands out that memory from one block by
+ * bumping a pointer (std::pmr::monotonic_buffer_resource) and takes it all
+ * back in a single reset(), and the block is reused by the next run.
+ */
+
+#ifndef RUN_ARENA_HPP
+#define RUN_ARENA_HPP
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace backtest {
+
+/**
+ * @class RunArena
+ * @brief Monotonic std::pmr resource over a block that grows to the largest run seen
+ *
+ * Containers built on resource() never return memory individually; all of it
+ * is reclaimed by reset(). If a run needs more than the block, the excess is
+ * taken from the global heap and the next reset() enlarges the block to cover
+ * it, so steady-state runs do no global-heap allocation at all. Not thread
+ * safe: use one arena per thread.
+ */
+class RunArena {
+public:
+    /**
+     * @brief Creates an arena with an initial block of initial_bytes (at least 1 KiB)
+     */
+    explicit RunArena(size_t initial_bytes = 256 * 1024);
+
+    RunArena(const RunArena&) = delete;
+    RunArena& operator=(const RunArena&) = delete;
+
+    /**
+     * @brief Resource to construct a run's containers with
+     */
+    std::pmr::memory_resource* resource() { return &*arena_; }
+
+    /**
+     * @brief Releases everything allocated since the last reset
+     * @pre No object still uses memory from resource()
+     */
+    void reset();
+
+    /**
+     * @brief Size of the reusable block
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Bytes requested from the global heap since the last reset
+     */
+    size_t overflow_bytes() const { return upstream_.bytes; }
+
+private:
+    /**
+     * @brief new/delete resource that counts what the arena takes beyond its block
+     */
+    struct CountingUpstream : std::pmr::memory_resource {
+        size_t bytes = 0;
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::unique_ptr<std::byte[]> block_;                      ///< Reused storage
+    size_t capacity_;                                         ///< Size of block_
+    CountingUpstream upstream_;                               ///< Overflow source
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;  ///< Bump allocator over block_
+};
+
+} // namespace backtest
+
+#endif // RUN_ARENA_HPP
@@ -0,0 +1,121 @@
+/**
+ * @file snapshot.hpp
+ * @brief Byte buffers for saving and restoring run state
+ *
+ * Components that can be checkpointed append their fields to a
+ * SnapshotWriter in a fixed order and read them back from a SnapshotReader
+ * in the same order. Fields are stored as raw native-order bytes, so a
+ * snapshot is only portable between machines of the same byte order (the
+ * checkpoint file header records it). Interned SymbolIds are process-local
+ * and are saved as names.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class SnapshotWriter
+ * @brief Growing byte buffer that fields are appended to
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Appends the bytes of a trivially copyable value
+     */
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        bytes_.insert(bytes_.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * @brief Appends a uint32 length followed by the characters
+     */
+    void put_string(std::string_view value) {
+        put(static_cast<uint32_t>(value.size()));
+        bytes_.insert(bytes_.end(), value.begin(), value.end());
+    }
+
+    const std::vector<char>& bytes() const { return bytes_; }
+    size_t size() const { return bytes_.size(); }
+
+private:
+    std::vector<char> bytes_;  ///< Fields written so far
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Bounds-checked cursor over a snapshot's bytes
+ *
+ * A read past the end fails and leaves the reader failed, so a sequence of
+ * reads can be checked once through ok().
+ */
+class SnapshotReader {
+public:
+    /**
+     * @param data Snapshot bytes, alive while the reader is used
+     * @param size Number of bytes
+     */
+    SnapshotReader(const char* data, size_t size) : data_(data), size_(size), position_(0), ok_(true) {}
+
+    /**
+     * @brief Reads the next value into `value`
+     * @return false (leaving `value` unchanged) if fewer than sizeof(T) bytes remain
+     */
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        if (!ok_ || size_ - position_ < sizeof(T)) {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(&value, data_ + position_, sizeof(T));
+        position_ += sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief Reads a string written by SnapshotWriter::put_string()
+     */
+    bool get_string(std::string& value) {
+        uint32_t length = 0;
+        if (!get(length)) {
+            return false;
+        }
+        if (size_ - position_ < length) {
+            ok_ = false;
+            return false;
+        }
+        value.assign(data_ + position_, length);
+        position_ += length;
+        return true;
+    }
+
+    /**
+     * @brief Marks the snapshot as invalid (e.g. a field failed validation)
+     */
+    void fail() { ok_ = false; }
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return size_ - position_; }
+
+private:
+    const char* data_;  ///< Snapshot bytes
+    size_t size_;       ///< Number of bytes
+    size_t position_;   ///< Offset of the next field
+    bool ok_;           ///< false once a read failed
+};
+
+} // namespace backtest
+
+#endif // SNAPSHOT_HPP
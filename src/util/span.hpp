@@ -0,0 +1,73 @@
+/**
+ * @file span.hpp
+ * @brief Minimal non-owning view over contiguous memory
+ *
+ * The project targets C++17, which has no std::span. Span<T> provides the
+ * small subset needed to hand columns of data to indicators and kernels
+ * without copying them.
+ */
+
+#ifndef SPAN_HPP
+#define SPAN_HPP
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class Span
+ * @brief Pointer + length view over a contiguous sequence of T
+ *
+ * A Span never owns its elements; the referenced storage must outlive it.
+ * Span<const T> is implicitly constructible from Span<T> and from vectors.
+ */
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    template <typename U, typename Alloc,
+              typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U, Alloc>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    template <typename U, typename Alloc,
+              typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U, Alloc>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr T& operator[](size_t i) const noexcept { return data_[i]; }
+    constexpr T& front() const noexcept { return data_[0]; }
+    constexpr T& back() const noexcept { return data_[size_ - 1]; }
+
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    /**
+     * @brief Returns the view [offset, offset + count), clamped to this span
+     */
+    constexpr Span subspan(size_t offset, size_t count = size_t(-1)) const noexcept {
+        if (offset > size_) offset = size_;
+        if (count > size_ - offset) count = size_ - offset;
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+} // namespace backtest
+
+#endif // SPAN_HPP
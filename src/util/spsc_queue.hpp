@@ -0,0 +1,103 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Bounded lock-free single-producer/single-consumer queue
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace backtest {
+
+/// Assumed cache line size; keeps the producer and consumer indices apart
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring shared by exactly one producer and one consumer thread
+ * @tparam T Default-constructible, movable element type
+ *
+ * try_push() and try_pop() never block and never allocate. Each side owns one
+ * index and keeps a cached copy of the other's, so the shared cache lines are
+ * only touched when the cached view says the ring looks full (producer) or
+ * empty (consumer). Release/acquire on the indices publishes the elements.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @param capacity Minimum number of elements; rounded up to a power of two
+     */
+    explicit SpscQueue(size_t capacity) {
+        size_t slots = 1;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        slots_.reset(new T[slots]);
+        mask_ = slots - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends value (producer only)
+     * @return false if the queue is full
+     */
+    template <typename U>
+    bool try_push(U&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element into out (consumer only)
+     * @return false if the queue is empty
+     */
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of queued elements; exact only when neither side is active
+     */
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};  ///< Next slot to pop, written by the consumer
+    size_t cached_tail_ = 0;                               ///< Consumer's last view of tail_
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};  ///< Next slot to fill, written by the producer
+    size_t cached_head_ = 0;                               ///< Producer's last view of head_
+};
+
+} // namespace backtest
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,202 @@
+/**
+ * @file tcp_socket.cpp
+ * @brief Implementation of the TCP socket wrapper
+ */
+
+#include "tcp_socket.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BACKTEST_HAVE_SOCKETS 1
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace backtest {
+
+#ifdef BACKTEST_HAVE_SOCKETS
+
+namespace {
+
+    void set_no_delay(int fd) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    int send_flags() {
+#ifdef MSG_NOSIGNAL
+        return MSG_NOSIGNAL;  // A closed peer is an error return, not SIGPIPE
+#else
+        return 0;
+#endif
+    }
+
+} // namespace
+
+TcpSocket& TcpSocket::operator=(TcpSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+bool TcpSocket::listen(uint16_t port, int backlog) {
+    close();
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        return false;
+    }
+    int on = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd_, backlog) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+TcpSocket TcpSocket::accept() const {
+    const int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd >= 0) {
+        set_no_delay(fd);
+    }
+    return TcpSocket(fd);
+}
+
+bool TcpSocket::connect(const std::string& host, uint16_t port) {
+    close();
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    const std::string service = std::to_string(port);
+    if (::getaddrinfo(host.c_str(), service.c_str(), &hints, &found) != 0) {
+        return false;
+    }
+    for (addrinfo* a = found; a != nullptr; a = a->ai_next) {
+        fd_ = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd_ < 0) {
+            continue;
+        }
+        if (::connect(fd_, a->ai_addr, a->ai_addrlen) == 0) {
+            break;
+        }
+        close();
+    }
+    ::freeaddrinfo(found);
+    if (fd_ < 0) {
+        return false;
+    }
+    set_no_delay(fd_);
+    return true;
+}
+
+bool TcpSocket::send_all(const void* data, size_t size) const {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::send(fd_, p, size, send_flags());
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool TcpSocket::recv_all(void* data, size_t size) const {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        const long n = recv_some(p, size);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+long TcpSocket::recv_some(void* data, size_t size) const {
+    for (;;) {
+        const ssize_t n = ::recv(fd_, data, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return static_cast<long>(n);
+    }
+}
+
+uint16_t TcpSocket::local_port() const {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (fd_ < 0 || ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+void TcpSocket::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+int poll_readable(const std::vector<const TcpSocket*>& sockets, int timeout_ms, std::vector<char>& ready) {
+    std::vector<pollfd> fds(sockets.size());
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        fds[i].fd = sockets[i]->fd();
+        fds[i].events = POLLIN;
+    }
+    int n = 0;
+    do {
+        n = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    ready.assign(sockets.size(), 0);
+    for (size_t i = 0; n > 0 && i < sockets.size(); ++i) {
+        ready[i] = (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+    }
+    return n;
+}
+
+#else
+
+TcpSocket& TcpSocket::operator=(TcpSocket&& other) noexcept {
+    fd_ = other.fd_;
+    other.fd_ = -1;
+    return *this;
+}
+
+bool TcpSocket::listen(uint16_t, int) { return false; }
+TcpSocket TcpSocket::accept() const { return TcpSocket(); }
+bool TcpSocket::connect(const std::string&, uint16_t) { return false; }
+bool TcpSocket::send_all(const void*, size_t) const { return false; }
+bool TcpSocket::recv_all(void*, size_t) const { return false; }
+long TcpSocket::recv_some(void*, size_t) const { return -1; }
+uint16_t TcpSocket::local_port() const { return 0; }
+void TcpSocket::close() { fd_ = -1; }
+
+int poll_readable(const std::vector<const TcpSocket*>& sockets, int, std::vector<char>& ready) {
+    ready.assign(sockets.size(), 0);
+    return -1;
+}
+
+#endif
+
+} // namespace backtest
@@ -0,0 +1,95 @@
+/**
+ * @file tcp_socket.hpp
+ * @brief Minimal RAII wrapper around a blocking IPv4 TCP socket
+ *
+ * Enough networking for the distributed sweep: listen and accept, connect by
+ * host name, and send or receive exact byte counts. Sockets disable Nagle's
+ * algorithm, since the sweep protocol exchanges many small messages whose
+ * latency matters more than packet count. On platforms without BSD sockets
+ * every operation fails.
+ */
+
+#ifndef TCP_SOCKET_HPP
+#define TCP_SOCKET_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class TcpSocket
+ * @brief Owns one socket descriptor; closed on destruction
+ */
+class TcpSocket {
+public:
+    TcpSocket() : fd_(-1) {}
+    explicit TcpSocket(int fd) : fd_(fd) {}
+    ~TcpSocket() { close(); }
+
+    TcpSocket(const TcpSocket&) = delete;
+    TcpSocket& operator=(const TcpSocket&) = delete;
+    TcpSocket(TcpSocket&& other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+    TcpSocket& operator=(TcpSocket&& other) noexcept;
+
+    /**
+     * @brief Binds to port on all interfaces (0 picks a free port) and listens
+     * @return false if the port cannot be bound
+     */
+    bool listen(uint16_t port, int backlog = 64);
+
+    /**
+     * @brief Accepts one pending connection of a listening socket
+     * @return Closed socket if none could be accepted
+     */
+    TcpSocket accept() const;
+
+    /**
+     * @brief Connects to host:port (name or dotted address)
+     */
+    bool connect(const std::string& host, uint16_t port);
+
+    /**
+     * @brief Sends exactly size bytes
+     * @return false if the connection failed
+     */
+    bool send_all(const void* data, size_t size) const;
+
+    /**
+     * @brief Receives exactly size bytes
+     * @return false if the connection closed or failed first
+     */
+    bool recv_all(void* data, size_t size) const;
+
+    /**
+     * @brief Receives whatever is available, up to size bytes
+     * @return Bytes read, 0 if the peer closed the connection, -1 on error
+     */
+    long recv_some(void* data, size_t size) const;
+
+    /**
+     * @brief Port a listening or connected socket is bound to locally (0 if none)
+     */
+    uint16_t local_port() const;
+
+    void close();
+    bool is_open() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+private:
+    int fd_;  ///< Descriptor, or -1
+};
+
+/**
+ * @brief Waits until a socket has data (or a pending connection, or a closed peer)
+ * @param sockets Open sockets to watch
+ * @param timeout_ms Longest wait; -1 waits indefinitely
+ * @param ready Receives one flag per socket
+ * @return Number of ready sockets, 0 on timeout, -1 on error
+ */
+int poll_readable(const std::vector<const TcpSocket*>& sockets, int timeout_ms, std::vector<char>& ready);
+
+} // namespace backtest
+
+#endif // TCP_SOCKET_HPP
@@ -0,0 +1,153 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of the work-stealing thread pool
+ */
+
+#include "thread_pool.hpp"
+
+namespace backtest {
+
+namespace {
+
+    /// Pool and worker index of the calling thread (nullptr outside any pool)
+    thread_local const ThreadPool* tls_pool = nullptr;
+    thread_local size_t tls_worker_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads)
+    : queued_(0), pending_(0), next_queue_(0), stopping_(false) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) {
+            threads = 1;
+        }
+    }
+
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this]() { return pending_.load() == 0; });
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::current_worker() const {
+    return tls_pool == this ? tls_worker_index : workers_.size();
+}
+
+void ThreadPool::submit(Task task) {
+    size_t target = current_worker();
+    if (target == workers_.size()) {
+        target = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    pending_.fetch_add(1);
+    {
+        // Counting before the push keeps queued_ from underflowing when a worker
+        // grabs the task immediately; counting under state_mutex_ pairs with the
+        // sleep predicate, so a worker about to sleep cannot miss this task
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        queued_.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    work_available_.notify_one();
+}
+
+void ThreadPool::wait_idle() {
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this]() { return pending_.load() == 0; });
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Takes the newest task of the worker's own queue (LIFO)
+ */
+bool ThreadPool::try_pop(size_t index, Task& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task of another worker's queue (FIFO end)
+ */
+bool ThreadPool::try_steal(size_t thief, Task& task) {
+    const size_t n = queues_.size();
+    for (size_t offset = 1; offset < n; ++offset) {
+        WorkerQueue& queue = *queues_[(thief + offset) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::finish_task() {
+    if (pending_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        all_done_.notify_all();
+    }
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    tls_pool = this;
+    tls_worker_index = index;
+
+    Task task;
+    while (true) {
+        if (try_pop(index, task) || try_steal(index, task)) {
+            queued_.fetch_sub(1);
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            task = nullptr;
+            finish_task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        work_available_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace backtest
@@ -0,0 +1,112 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Work-stealing thread pool
+ *
+ * Each worker owns a task deque. Workers take their own newest tasks first
+ * (good cache locality for tasks spawned by tasks) and, when they run dry,
+ * steal the oldest tasks from other workers, so uneven task durations (e.g.
+ * long vs short SMA windows in a sweep) still keep every core busy.
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace backtest {
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads with per-worker queues and stealing
+ *
+ * Tasks submitted from outside the pool are distributed round-robin; tasks
+ * submitted from a worker go to that worker's own queue. If a task throws,
+ * the first exception is rethrown by wait_idle().
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Starts the workers
+     * @param threads Number of workers (0 = std::thread::hardware_concurrency())
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Finishes all queued tasks and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task has finished
+     * @throws The first exception thrown by a task since the last wait_idle()
+     *
+     * Must not be called from inside a pool task (it would wait for itself).
+     */
+    void wait_idle();
+
+    /**
+     * @brief Runs fn(i) for every i in [0, n) on the pool and waits for completion
+     */
+    template <typename F>
+    void parallel_for(size_t n, F&& fn) {
+        for (size_t i = 0; i < n; ++i) {
+            submit([&fn, i]() { fn(i); });
+        }
+        wait_idle();
+    }
+
+    /**
+     * @brief Number of worker threads
+     */
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Index of the calling worker in [0, size()), or size() if called from outside the pool
+     */
+    size_t current_worker() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(size_t index);
+    bool try_pop(size_t index, Task& task);
+    bool try_steal(size_t thief, Task& task);
+    void finish_task();
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;  ///< One deque per worker
+    std::vector<std::thread> workers_;
+
+    std::mutex state_mutex_;              ///< Guards sleeping/waking and error_
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    std::atomic<size_t> queued_;          ///< Tasks sitting in queues
+    std::atomic<size_t> pending_;         ///< Tasks submitted but not yet finished
+    std::atomic<size_t> next_queue_;      ///< Round-robin target for external submissions
+    bool stopping_;
+    std::exception_ptr error_;
+};
+
+} // namespace backtest
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,67 @@
+/**
+ * @file walk_forward_main.cpp
+ * @brief Command-line driver for walk-forward validation of the SMA strategy
+ *
+ * Usage:
+ *   walkforward [csv] [train_bars] [test_bars] [threads] [anchored|cold]...
+ *
+ * Loads the file once, optimizes the window grid of `sweep` (short 2..10,
+ * long 5..40 step 5) over each training range and trades the winner over the
+ * following test range, then prints every fold and the compounded
+ * out-of-sample return.
+ */
+
+#include "data/data_handler.hpp"
+#include "sweep/walk_forward.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "../data/sample_data.csv";
+
+    backtest::WalkForwardConfig config;
+    config.train_bars = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    config.test_bars = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10;
+    config.sweep.threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+    for (int i = 5; i < argc; ++i) {
+        if (std::strcmp(argv[i], "anchored") == 0) {
+            config.anchored = true;
+        } else if (std::strcmp(argv[i], "cold") == 0) {
+            config.warm_start = false;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    backtest::DataHandler data;
+    if (!data.load_csv(path, "SPY", backtest::LoadMode::MemoryMapped)) {
+        std::cout << "Failed to load data" << std::endl;
+        return 1;
+    }
+
+    std::vector<size_t> short_windows;
+    std::vector<size_t> long_windows;
+    for (size_t w = 2; w <= 10; ++w) short_windows.push_back(w);
+    for (size_t w = 5; w <= 40; w += 5) long_windows.push_back(w);
+    const std::vector<backtest::SmaParams> grid = backtest::SweepEngine::make_grid(short_windows, long_windows);
+
+    const backtest::WalkForwardRunner runner(data.columns(), config);
+    std::cout << "Loaded " << data.size() << " bars, " << runner.folds().size() << " folds of "
+              << config.train_bars << " train / " << config.test_bars << " test bars, "
+              << grid.size() << " window combinations" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<backtest::WalkForwardFold> folds = runner.run(grid);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    backtest::print_walk_forward(std::cout, folds);
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout << "Out-of-sample return: " << backtest::walk_forward_return(folds) * 100.0 << "% | "
+              << folds.size() << " folds in " << seconds * 1e3 << " ms" << std::endl;
+    return 0;
+}